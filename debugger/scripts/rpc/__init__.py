@@ -137,6 +137,14 @@ class Simulator(object):
         req = ["Syringe",[float(diam),k1,k2]]
         return self.client.send(req)
 
+    def subscribe(self, hap, enable=True):
+        """
+        Enable/disable asynchronous notifications 'Halt' or 'Resume'
+        pushed by simulator. Use client.registerHapListener() to handle them.
+        """
+        req = ["Subscribe",[hap, enable]]
+        return self.client.send(req)
+
     def isON(self):
         req = ["Status","IsON"]
         return self.client.send(req)
@@ -26,6 +26,7 @@ class TcpClient(threading.Thread):
         self.eventTx = threading.Event()
         self.response = ""
         self.console_listeners = []
+        self.hap_listeners = []
 
     def run(self):
         safe_print("Connecting to {0}:{1}\n".format(TCP_IP, TCP_PORT))
@@ -65,6 +66,9 @@ class TcpClient(threading.Thread):
                      elif json[0] == "Console":
                           for l in self.console_listeners:
                               l.callback(json[1])
+                     elif json[0] == "Halt" or json[0] == "Resume":
+                          for l in self.hap_listeners:
+                              l.callback(json[0], json[1])
                      else:
                           raise ValueError(
                             'Unexpected simulation response: {0}'.format(json))
@@ -97,4 +101,10 @@ class TcpClient(threading.Thread):
     def unregisterConsoleListener(self, listener):
         if listener in self.console_listeners:
             self.console_listeners.remove(listener)
-        
\ No newline at end of file
+
+    def registerHapListener(self, listener):
+        self.hap_listeners.append(listener)
+
+    def unregisterHapListener(self, listener):
+        if listener in self.hap_listeners:
+            self.hap_listeners.remove(listener)
@@ -0,0 +1,234 @@
+#!/usr/bin/env python3
+#
+#  Copyright 2018 Sergey Khabarov, sergeykhbr@gmail.com
+#
+#  Licensed under the Apache License, Version 2.0 (the "License");
+#  you may not use this file except in compliance with the License.
+#  You may obtain a copy of the License at
+#
+#      http://www.apache.org/licenses/LICENSE-2.0
+#
+#  Unless required by applicable law or agreed to in writing, software
+#  distributed under the License is distributed on an "AS IS" BASIS,
+#  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+#  See the License for the specific language governing permissions and
+#  limitations under the License.
+#
+# Convert binary trace written by the River SystemC Tracer
+# (CFG_TRACER_BINARY = true) into the text format of trace_river_sysc<N>.log
+#
+# Usage: python3 rvtrace2txt.py <trace_river_sysc0.bin> <trace_river_sysc0.log>
+
+import struct
+import sys
+
+MAGIC = b"RVTRACE\n"
+
+RNAME = [
+    "zero", "ra", "sp", "gp", "tp", "t0", "t1", "t2",
+    "s0", "s1", "a0", "a1", "a2", "a3", "a4", "a5",
+    "a6", "a7", "s2", "s3", "s4", "s5", "s6", "s7",
+    "s8", "s9", "s10", "s11", "t3", "t4", "t5", "t6",
+    "ft0", "ft1", "ft2", "ft3", "ft4", "ft5", "ft6", "ft7",
+    "fs0", "fs1", "fa0", "fa1", "fa2", "fa3", "fa4", "fa5",
+    "fa6", "fa7", "fs2", "fs3", "fs4", "fs5", "fs6", "fs7",
+    "fs8", "fs9", "fs10", "fs11", "ft8", "ft9", "ft10", "ft11",
+]
+
+AMO = {
+    0x00: "amoadd", 0x01: "amoswap", 0x03: "sc", 0x04: "amoxor",
+    0x08: "amoor", 0x0C: "amoand", 0x10: "amomin", 0x14: "amomax",
+    0x18: "amominu", 0x1C: "amomaxu",
+}
+
+# funct3 -> {funct7: name} for OP and OP-32
+OP = {
+    0: {0x00: "add", 0x01: "mul", 0x20: "sub"},
+    1: {0x00: "sll", 0x01: "mulh"},
+    2: {0x00: "slt", 0x01: "mulhsu"},
+    3: {0x00: "sltu", 0x01: "mulhu"},
+    4: {0x00: "xor", 0x01: "div"},
+    5: {0x00: "srl", 0x01: "divu", 0x20: "sra"},
+    6: {0x00: "or", 0x01: "rem"},
+    7: {0x00: "and", 0x01: "remu"},
+}
+OP32 = {
+    0: {0x00: "addw", 0x01: "mulw", 0x20: "subw"},
+    1: {0x00: "sllw"},
+    4: {0x01: "divw"},
+    5: {0x00: "srlw", 0x01: "divuw", 0x20: "sraw"},
+    6: {0x01: "remw"},
+    7: {0x01: "remuw"},
+}
+
+SYSTEM = {
+    0x00000073: "ecall", 0x00100073: "ebreak", 0x00200073: "uret",
+    0x10200073: "sret", 0x10500073: "wfi", 0x20200073: "hret",
+    0x30200073: "mret",
+}
+
+
+def bits(v, hi, lo):
+    return (v >> lo) & ((1 << (hi - lo + 1)) - 1)
+
+
+def disasm_c(instr):
+    q = bits(instr, 1, 0)
+    f3 = bits(instr, 15, 13)
+    b12 = bits(instr, 12, 12)
+    if q == 0:
+        if f3 == 0:
+            return "ERROR" if bits(instr, 12, 2) == 0 else "c.addi4spn"
+        return ["", "c.fld", "c.lw", "c.ld",
+                "ERROR", "c.fsd", "c.sw", "c.sd"][f3]
+    if q == 1:
+        if f3 == 0:
+            return "c.nop" if bits(instr, 12, 2) == 0 else "c.addi"
+        if f3 == 1:
+            return "ERROR" if bits(instr, 11, 7) == 0 else "c.addiw"
+        if f3 == 2:
+            return "ERROR" if bits(instr, 11, 7) == 0 else "c.li"
+        if f3 == 3:
+            if bits(instr, 11, 7) == 2:
+                return "c.addi16sp"
+            return "c.lui" if bits(instr, 11, 7) != 0 else "ERROR"
+        if f3 == 4:
+            f2 = bits(instr, 11, 10)
+            if f2 == 0 or f2 == 1:
+                name = "c.srli" if f2 == 0 else "c.srai"
+                if b12 == 0 and bits(instr, 6, 2) == 0:
+                    name += "64"
+                return name
+            if f2 == 2:
+                return "c.andi"
+            return {(0, 0): "c.sub", (0, 1): "c.xor", (0, 2): "c.or",
+                    (0, 3): "c.and", (1, 0): "c.subw", (1, 1): "c.addw"
+                    }.get((b12, bits(instr, 6, 5)), "ERROR")
+        return ["", "", "", "", "", "c.j", "c.beqz", "c.bnez"][f3]
+    # q == 2
+    if f3 == 0:
+        if b12 == 0 and bits(instr, 6, 5) == 0:
+            return "c.slli64"
+        return "c.slli"
+    if f3 == 4:
+        rs2 = bits(instr, 6, 2)
+        if b12 == 0:
+            return "c.jr" if rs2 == 0 else "c.mv"
+        if rs2 == 0 and bits(instr, 11, 7) == 0:
+            return "c.ebreak"
+        return "c.jalr" if rs2 == 0 else "c.add"
+    return ["", "c.fldsp", "c.lwsp", "c.ldsp",
+            "", "c.fsdsp", "c.swsp", "c.sdsp"][f3]
+
+
+def disasm(instr):
+    if bits(instr, 1, 0) != 3:
+        return disasm_c(instr)
+    opcode = bits(instr, 6, 0)
+    f3 = bits(instr, 14, 12)
+    f7 = bits(instr, 31, 25)
+    if opcode == 0x03:
+        return ["lb", "lh", "lw", "ld", "lbu", "lhu", "lwu", "ERROR"][f3]
+    if opcode == 0x07:
+        return "fld" if f3 == 3 else "ERROR"
+    if opcode == 0x0F:
+        return {0: "fence", 1: "fence.i"}.get(f3, "ERROR")
+    if opcode == 0x13:
+        if f3 == 1:
+            return "slli" if bits(instr, 31, 26) == 0 else "ERROR"
+        if f3 == 5:
+            return {0: "srli", 0x10: "srai"}.get(bits(instr, 31, 26), "ERROR")
+        return ["addi", "", "slti", "sltiu", "xori", "", "ori", "andi"][f3]
+    if opcode == 0x17:
+        return "auipc"
+    if opcode == 0x1B:
+        if f3 == 0:
+            return "addiw"
+        if f3 == 1:
+            return "slliw" if f7 == 0 else "ERROR"
+        if f3 == 5:
+            return {0: "srliw", 0x20: "sraiw"}.get(f7, "ERROR")
+        return "ERROR"
+    if opcode == 0x23:
+        return {0: "sb", 1: "sh", 2: "sw", 3: "sd"}.get(f3, "ERROR")
+    if opcode == 0x27:
+        return "fsd" if f3 == 3 else "ERROR"
+    if opcode == 0x2F:
+        if f3 != 2 and f3 != 3:
+            return "ERROR"
+        sfx = ".w" if f3 == 2 else ".d"
+        f5 = bits(instr, 31, 27)
+        if f5 == 0x02:
+            return "lr" + sfx if bits(instr, 24, 20) == 0 else "ERROR"
+        if f5 in AMO:
+            return AMO[f5] + sfx
+        return "ERROR"
+    if opcode == 0x33:
+        return OP[f3].get(f7, "ERROR")
+    if opcode == 0x37:
+        return "lui"
+    if opcode == 0x3B:
+        return OP32.get(f3, {}).get(f7, "ERROR")
+    if opcode == 0x53:
+        rs2 = bits(instr, 24, 20)
+        simple = {0x01: "fadd", 0x05: "fsub", 0x09: "fmul", 0x0D: "fdiv"}
+        if f7 in simple:
+            return simple[f7]
+        if f7 == 0x15:
+            return {0: "fmin", 1: "fmax"}.get(f3, "ERROR")
+        if f7 == 0x51:
+            return {0: "fle", 1: "flt", 2: "feq"}.get(f3, "ERROR")
+        if f7 == 0x61:
+            return {0: "fcvt.w.d", 1: "fcvt.wu.d", 2: "fcvt.l.d",
+                    3: "fcvt.lu.d"}.get(rs2, "ERROR")
+        if f7 == 0x69:
+            return {0: "fcvt.d.w", 1: "fcvt.d.wu", 2: "fcvt.d.l",
+                    3: "fcvt.d.lu"}.get(rs2, "ERROR")
+        if f7 == 0x71 or f7 == 0x79:
+            if rs2 == 0 and f3 == 0:
+                return "fmov.x.d" if f7 == 0x71 else "fmov.d.x"
+        return "ERROR"
+    if opcode == 0x63:
+        return {0: "beq", 1: "bne", 4: "blt", 5: "bge",
+                6: "bltu", 7: "bgeu"}.get(f3, "ERROR")
+    if opcode == 0x67:
+        return "jalr"
+    if opcode == 0x6F:
+        return "jal"
+    if opcode == 0x73:
+        if f3 == 0:
+            return SYSTEM.get(instr, "ERROR")
+        return ["", "csrrw", "csrrs", "csrrc",
+                "ERROR", "csrrwi", "csrrsi", "csrrci"][f3]
+    return "ERROR"
+
+
+def main(fin, fout):
+    f = open(fin, "rb")
+    if f.read(len(MAGIC)) != MAGIC:
+        print("Wrong file format")
+        return 1
+    f.read(4)   # hartid
+    out = open(fout, "w")
+    while True:
+        hdr = f.read(22)
+        if len(hdr) < 22:
+            break
+        exec_cnt, pc, instr, memcnt, regcnt = struct.unpack("<QQIBB", hdr)
+        out.write("%9d: %08x: %10s \n" % (exec_cnt, pc, disasm(instr)))
+        for i in range(memcnt):
+            store, addr, data = struct.unpack("<BQQ", f.read(17))
+            out.write("%20s [%08x] %s %016x\n"
+                      % ("", addr, "<=" if store else "=>", data))
+        for i in range(regcnt):
+            waddr, wres = struct.unpack("<BQ", f.read(9))
+            out.write("%20s %10s <= %016x\n" % ("", RNAME[waddr], wres))
+    out.close()
+    return 0
+
+
+if __name__ == "__main__":
+    if len(sys.argv) != 3:
+        print("Usage: python3 rvtrace2txt.py <input.bin> <output.log>")
+        sys.exit(1)
+    sys.exit(main(sys.argv[1], sys.argv[2]))
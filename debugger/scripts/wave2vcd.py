@@ -0,0 +1,122 @@
+#!/usr/bin/env python3
+#
+#  Copyright 2018 Sergey Khabarov, sergeykhbr@gmail.com
+#
+#  Licensed under the Apache License, Version 2.0 (the "License");
+#  you may not use this file except in compliance with the License.
+#  You may obtain a copy of the License at
+#
+#      http://www.apache.org/licenses/LICENSE-2.0
+#
+#  Unless required by applicable law or agreed to in writing, software
+#  distributed under the License is distributed on an "AS IS" BASIS,
+#  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+#  See the License for the specific language governing permissions and
+#  limitations under the License.
+#
+# Convert compact waveform written by cpu_sysc_plugin (WaveFile attribute)
+# into the standard VCD format.
+#
+# Usage: python3 wave2vcd.py <input.wave> <output.vcd>
+
+import struct
+import sys
+
+MAGIC = b"RVWAVE1\n"
+
+
+def read_varint(f):
+    v = 0
+    shift = 0
+    while True:
+        b = f.read(1)
+        if not b:
+            return None
+        v |= (b[0] & 0x7F) << shift
+        shift += 7
+        if (b[0] & 0x80) == 0:
+            return v
+
+
+def vcd_id(idx):
+    s = ""
+    idx += 1
+    while idx:
+        idx -= 1
+        s += chr(33 + idx % 94)
+        idx //= 94
+    return s
+
+
+def timescale(fs):
+    units = ["fs", "ps", "ns", "us", "ms", "s"]
+    i = 0
+    while fs >= 1000 and fs % 1000 == 0 and i < len(units) - 1:
+        fs //= 1000
+        i += 1
+    return "%d %s" % (fs, units[i])
+
+
+def write_scopes(out, tree, ids):
+    for name, node in sorted(tree.items()):
+        if isinstance(node, tuple):
+            bits, idx = node
+            out.write("$var wire %d %s %s $end\n" % (bits, ids[idx], name))
+        else:
+            out.write("$scope module %s $end\n" % name)
+            write_scopes(out, node, ids)
+            out.write("$upscope $end\n")
+
+
+def main(fin, fout):
+    f = open(fin, "rb")
+    if f.read(len(MAGIC)) != MAGIC:
+        print("Wrong file format")
+        return 1
+    resolution_fs, = struct.unpack("<Q", f.read(8))
+    cnt, = struct.unpack("<I", f.read(4))
+    sigs = []
+    tree = {}
+    for i in range(cnt):
+        bits, ln = struct.unpack("<IH", f.read(6))
+        name = f.read(ln).decode()
+        sigs.append(bits)
+        path = name.split(".")
+        node = tree
+        for p in path[:-1]:
+            node = node.setdefault(p, {})
+        node[path[-1]] = (bits, i)
+    ids = [vcd_id(i) for i in range(cnt)]
+
+    out = open(fout, "w")
+    out.write("$timescale %s $end\n" % timescale(resolution_fs))
+    write_scopes(out, tree, ids)
+    out.write("$enddefinitions $end\n")
+
+    t = 0
+    while True:
+        dt = read_varint(f)
+        if dt is None:
+            break
+        t += dt
+        out.write("#%d\n" % t)
+        idx = read_varint(f)
+        if idx == 0:
+            out.write("$comment capture window closed $end\n")
+        while idx:
+            bits = sigs[idx - 1]
+            val = int.from_bytes(f.read((bits + 7) // 8), "little")
+            if bits == 1:
+                out.write("%d%s\n" % (val & 1, ids[idx - 1]))
+            else:
+                out.write("b%s %s\n" % (format(val, "b"), ids[idx - 1]))
+            idx = read_varint(f)
+    out.close()
+    return 0
+
+
+if __name__ == "__main__":
+    if len(sys.argv) != 3:
+        print("Usage: python3 wave2vcd.py <input.wave> <output.vcd>")
+        sys.exit(1)
+    sys.exit(main(sys.argv[1], sys.argv[2]))
@@ -0,0 +1,632 @@
+/*
+ *  Copyright 2023 Sergey Khabarov, sergeykhbr@gmail.com
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include "batch.h"
+#include "iservice.h"
+#include "coreservices/iclock.h"
+#include "coreservices/icmdexec.h"
+#include "coreservices/icpuriscv.h"
+#include "coreservices/idport.h"
+#include "coreservices/isrccode.h"
+#include "coreservices/iwatchpoint.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <string>
+#include <vector>
+#if !defined(_WIN32) && !defined(__CYGWIN__)
+#include <fcntl.h>
+#include <spawn.h>
+#include <sys/wait.h>
+
+extern char **environ;
+#endif
+
+namespace debugger {
+
+/** Services that wait for the user or open host resources (TCP ports,
+ *  serial ports) which cannot be shared by the parallel instances. */
+static const char *const HEADLESS_REMOVE_CLASSES[] = {
+    "GuiPluginClass",
+    "ConsoleServiceClass",
+    "TcpServerClass",
+    "TcpClientClass",
+    "ComPortServiceClass",
+    0
+};
+
+void batchHeadlessConfig(AttributeType *cfg) {
+    (*cfg)["GlobalSettings"]["GUI"].make_boolean(false);
+
+    AttributeType &serv = (*cfg)["Services"];
+    AttributeType newserv;
+    newserv.make_list(0);
+    for (unsigned i = 0; i < serv.size(); i++) {
+        bool skip = false;
+        for (int k = 0; HEADLESS_REMOVE_CLASSES[k]; k++) {
+            if (serv[i]["Class"].is_equal(HEADLESS_REMOVE_CLASSES[k])) {
+                skip = true;
+                break;
+            }
+        }
+        if (skip) {
+            continue;
+        }
+
+        AttributeType &inst = serv[i]["Instances"];
+        for (unsigned n = 0; n < inst.size(); n++) {
+            AttributeType &attr = inst[n]["Attr"];
+            for (unsigned a = 0; a < attr.size(); a++) {
+                AttributeType &item = attr[a];
+                if (item.size() >= 2
+                    && item[0u].is_equal("GenerateTraceFile")) {
+                    item[1].make_string("");
+                }
+            }
+        }
+        newserv.add_to_list(&serv[i]);
+    }
+    serv = newserv;
+}
+
+/**
+ * Halts the CPU when the instructions limit reached.
+ */
+class BatchStepLimit : public IClockListener {
+ public:
+    explicit BatchStepLimit(IDPort *idport) : idport_(idport), hit_(false) {}
+
+    virtual void stepCallback(uint64_t t) {
+        hit_ = true;
+        idport_->haltreq();
+    }
+    bool isHit() { return hit_; }
+
+ private:
+    IDPort *idport_;
+    volatile bool hit_;
+};
+
+static void batchError(AttributeType *res, const char *descr) {
+    (*res)["Status"].make_string("error");
+    (*res)["Error"].make_string(descr);
+    printf("Error: %s\n", descr);
+}
+
+static void batchSimulate(const char *elffile, const BatchSettingsType *s,
+                          AttributeType *res) {
+    ICmdExecutor *iexec = static_cast<ICmdExecutor *>(
+            RISCV_get_service_iface("cmdexec0", IFACE_CMD_EXECUTOR));
+    AttributeType lstServ;
+    RISCV_get_services_with_iface(IFACE_DPORT, &lstServ);
+    if (!iexec || lstServ.size() == 0) {
+        batchError(res, "CPU or command executor not found");
+        return;
+    }
+    IService *icpu = static_cast<IService *>(lstServ[0u].to_iface());
+    IDPort *idport = static_cast<IDPort *>(icpu->getInterface(IFACE_DPORT));
+    IClock *iclk = static_cast<IClock *>(icpu->getInterface(IFACE_CLOCK));
+    IWatchpoint *iwp = static_cast<IWatchpoint *>(
+                        icpu->getInterface(IFACE_WATCHPOINT));
+    bool riscv = icpu->getInterface(IFACE_CPU_RISCV) != 0;
+    if (!iclk) {
+        batchError(res, "CPU clock interface not found");
+        return;
+    }
+
+    ISourceCode *isrc = 0;
+    RISCV_get_services_with_iface(IFACE_SOURCE_CODE, &lstServ);
+    if (lstServ.size()) {
+        IService *iserv = static_cast<IService *>(lstServ[0u].to_iface());
+        isrc = static_cast<ISourceCode *>(
+                    iserv->getInterface(IFACE_SOURCE_CODE));
+    }
+
+    uint64_t t_start = RISCV_get_time_ms();
+    uint64_t t_end = t_start + 1000ull * s->timeout_sec;
+    // Request stays pending in the halted state, so it is sent only once
+    if (!idport->isHalted()) {
+        idport->haltreq();
+    }
+    while (!idport->isHalted() && RISCV_get_time_ms() < t_end) {
+        RISCV_sleep_ms(1);
+    }
+
+    // 'loadelf' doesn't report a missing file
+    FILE *f = fopen(elffile, "rb");
+    if (!f) {
+        batchError(res, "Cannot open ELF-file");
+        return;
+    }
+    fclose(f);
+
+    char tstr[4096];
+    AttributeType cmdres;
+    RISCV_sprintf(tstr, sizeof(tstr), "loadelf %s", elffile);
+    iexec->exec(tstr, &cmdres, true);
+    if (cmdres.is_list() && cmdres.size() && cmdres[0u].is_equal("ERROR")) {
+        batchError(res, "Cannot load ELF-file");
+        return;
+    }
+
+    uint64_t entry;
+    if (riscv && isrc && isrc->symbol2Address("_start", &entry) == 0) {
+        idport->writeRegDbg(ICpuRiscV::CSR_dpc, entry);
+    }
+
+    uint64_t tohost = s->tohost;
+    if (!tohost && isrc && isrc->symbol2Address("tohost", &tohost) != 0) {
+        tohost = 0;
+    }
+    if (tohost) {
+        if (!iwp || iwp->addWatchpoint(tohost, 8, WatchFlag_Write, 0)) {
+            batchError(res, "Cannot set watchpoint on 'tohost'");
+            return;
+        }
+        (*res)["ToHostAddr"].make_uint64(tohost);
+    }
+
+    BatchStepLimit limit(idport);
+    uint64_t step_start = iclk->getStepCounter();
+    iclk->registerStepCallback(static_cast<IClockListener *>(&limit),
+                               step_start + s->max_steps);
+    idport->resumereq();
+
+    bool timeout = false;
+    while (!(idport->isHalted() && iclk->getStepCounter() != step_start)) {
+        if (RISCV_get_time_ms() >= t_end) {
+            timeout = true;
+            idport->haltreq();
+            break;
+        }
+        RISCV_sleep_ms(1);
+    }
+    // Wait until the timeout halt request is processed
+    while (!idport->isHalted() && RISCV_get_time_ms() < t_end + 1000) {
+        RISCV_sleep_ms(1);
+    }
+    // Limit callback could be still in the queue, it must never fire
+    iclk->moveStepCallback(static_cast<IClockListener *>(&limit), ~0ull);
+
+    (*res)["Steps"].make_uint64(iclk->getStepCounter() - step_start);
+    (*res)["SimMs"].make_uint64(RISCV_get_time_ms() - t_start);
+
+    if (timeout) {
+        (*res)["Status"].make_string("timeout");
+        return;
+    }
+    if (limit.isHit()) {
+        // Benchmark without exit protocol may use limit as the normal stop
+        bool pass = !tohost && s->pass_on_limit;
+        (*res)["Status"].make_string(pass ? "pass" : "limit");
+        return;
+    }
+    if (!tohost) {
+        (*res)["Status"].make_string("halted");
+        return;
+    }
+
+    uint64_t val = 0;
+    RISCV_sprintf(tstr, sizeof(tstr), "read 0x%" RV_PRI64 "x 8", tohost);
+    iexec->exec(tstr, &cmdres, true);
+    if (!cmdres.is_data() || cmdres.size() != sizeof(val)) {
+        batchError(res, "Cannot read 'tohost'");
+        return;
+    }
+    memcpy(&val, cmdres.data(), sizeof(val));
+    (*res)["ToHost"].make_uint64(val);
+
+    // riscv-tests protocol: 1 = pass, (testnum << 1) | 1 = fail
+    if (val == 1) {
+        (*res)["Status"].make_string("pass");
+    } else if (val & 1) {
+        (*res)["Status"].make_string("fail");
+        (*res)["TestNum"].make_uint64(val >> 1);
+    } else {
+        (*res)["Status"].make_string("halted");
+    }
+}
+
+int batchRunTest(const char *elffile, const BatchSettingsType *s) {
+    AttributeType res;
+    res.make_dict();
+    // File name is set by the parent: JSON strings here aren't escaped
+    res["Steps"].make_uint64(0);
+    batchSimulate(elffile, s, &res);
+
+    int ret = res["Status"].is_equal("pass") ? 0 : 1;
+    if (s->result) {
+        res.to_config();
+        RISCV_write_json_file(s->result, res.to_string());
+    }
+    return ret;
+}
+
+int batchReadList(const char *filename, AttributeType *elflist) {
+    uint64_t sz;
+    char *buf = reinterpret_cast<char *>(RISCV_file_map(filename, &sz));
+    elflist->make_list(0);
+    if (!buf) {
+        return -1;
+    }
+    AttributeType item;
+    char line[1024];
+    uint64_t pos = 0;
+    while (pos < sz) {
+        uint64_t end = pos;
+        while (end < sz && buf[end] != '\n' && buf[end] != '\r') {
+            end++;
+        }
+        uint64_t last = end;
+        while (pos < last && (buf[pos] == ' ' || buf[pos] == '\t')) {
+            pos++;
+        }
+        while (last > pos && (buf[last - 1] == ' ' || buf[last - 1] == '\t')) {
+            last--;
+        }
+        if (last > pos && buf[pos] != '#' && last - pos < sizeof(line)) {
+            memcpy(line, &buf[pos], static_cast<size_t>(last - pos));
+            line[last - pos] = '\0';
+            item.make_string(line);
+            elflist->add_to_list(&item);
+        }
+        pos = end + 1;
+    }
+    RISCV_file_unmap(buf, sz);
+    return 0;
+}
+
+/**
+ * Shared state of the worker threads. Every item of the results list is
+ * written only by the worker that took the test index.
+ */
+struct BatchPoolType {
+    const AttributeType *elflist;
+    const BatchSettingsType *s;
+    AttributeType results;
+    unsigned next;
+    unsigned done;
+    mutex_def mutex;
+};
+
+struct BatchWorkerType {
+    LibThreadType th;
+    BatchPoolType *pool;
+};
+
+static bool batchIsPassed(const AttributeType &item) {
+    return strcmp(item["Status"].to_string(), "pass") == 0;
+}
+
+#if defined(_WIN32) || defined(__CYGWIN__)
+/** Quote one argument by the rules of CommandLineToArgvW() */
+static void batchQuoteArg(std::string *cmdline, const char *arg) {
+    if (cmdline->size()) {
+        *cmdline += ' ';
+    }
+    *cmdline += '"';
+    for (const char *p = arg; ; p++) {
+        size_t slashes = 0;
+        while (*p == '\\') {
+            slashes++;
+            p++;
+        }
+        if (*p == '\0') {
+            // Backslashes before the closing quote are escaped
+            cmdline->append(slashes * 2, '\\');
+            break;
+        }
+        if (*p == '"') {
+            cmdline->append(slashes * 2 + 1, '\\');
+        } else {
+            cmdline->append(slashes, '\\');
+        }
+        *cmdline += *p;
+    }
+    *cmdline += '"';
+}
+#endif
+
+/**
+ * Start the simulator without a shell, so paths are passed as they are.
+ *
+ * @return -1 if the process wasn't started
+ */
+static int batchSpawn(const char *const *argv, const char *logfile) {
+#if defined(_WIN32) || defined(__CYGWIN__)
+    std::string cmdline;
+    for (int i = 0; argv[i]; i++) {
+        batchQuoteArg(&cmdline, argv[i]);
+    }
+    SECURITY_ATTRIBUTES sa;
+    memset(&sa, 0, sizeof(sa));
+    sa.nLength = sizeof(sa);
+    sa.bInheritHandle = TRUE;
+    HANDLE hlog = CreateFileA(logfile, GENERIC_WRITE, FILE_SHARE_READ, &sa,
+                              CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (hlog == INVALID_HANDLE_VALUE) {
+        return -1;
+    }
+    STARTUPINFOA si;
+    PROCESS_INFORMATION pi;
+    memset(&si, 0, sizeof(si));
+    si.cb = sizeof(si);
+    si.dwFlags = STARTF_USESTDHANDLES;
+    si.hStdInput = GetStdHandle(STD_INPUT_HANDLE);
+    si.hStdOutput = hlog;
+    si.hStdError = hlog;
+    std::vector<char> buf(cmdline.begin(), cmdline.end());
+    buf.push_back('\0');
+    BOOL ok = CreateProcessA(argv[0], &buf[0], NULL, NULL, TRUE, 0,
+                             NULL, NULL, &si, &pi);
+    CloseHandle(hlog);
+    if (!ok) {
+        return -1;
+    }
+    WaitForSingleObject(pi.hProcess, INFINITE);
+    CloseHandle(pi.hThread);
+    CloseHandle(pi.hProcess);
+    return 0;
+#else
+    posix_spawn_file_actions_t fa;
+    posix_spawn_file_actions_init(&fa);
+    posix_spawn_file_actions_addopen(&fa, 1, logfile,
+                                     O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    posix_spawn_file_actions_adddup2(&fa, 1, 2);
+    pid_t pid;
+    int err = posix_spawnp(&pid, argv[0], &fa, NULL,
+                           const_cast<char *const *>(argv), environ);
+    posix_spawn_file_actions_destroy(&fa);
+    if (err != 0) {
+        return -1;
+    }
+    int status;
+    while (waitpid(pid, &status, 0) < 0 && errno == EINTR) {
+    }
+    return 0;
+#endif
+}
+
+static void batchRunOne(BatchPoolType *p, unsigned idx) {
+    const BatchSettingsType *s = p->s;
+    const char *prefix = s->report ? s->report : "batch";
+    const char *elffile = (*p->elflist)[idx].to_string();
+    char resfile[1024];
+    char logfile[1024];
+    char maxsteps[32];
+    char timeout[32];
+    char tohost[32];
+    RISCV_sprintf(resfile, sizeof(resfile), "%s.%d.res", prefix, idx);
+    RISCV_sprintf(logfile, sizeof(logfile), "%s.%d.log", prefix, idx);
+    RISCV_sprintf(maxsteps, sizeof(maxsteps), "%" RV_PRI64 "d", s->max_steps);
+    RISCV_sprintf(timeout, sizeof(timeout), "%d", s->timeout_sec);
+    RISCV_sprintf(tohost, sizeof(tohost), "0x%" RV_PRI64 "x", s->tohost);
+
+    const char *argv[16];
+    int argc = 0;
+    argv[argc++] = s->exename;
+    argv[argc++] = "-c";
+    argv[argc++] = s->cfgfile;
+    argv[argc++] = "--run";
+    argv[argc++] = elffile;
+    argv[argc++] = "--result";
+    argv[argc++] = resfile;
+    argv[argc++] = "--max-steps";
+    argv[argc++] = maxsteps;
+    argv[argc++] = "--timeout";
+    argv[argc++] = timeout;
+    if (s->tohost) {
+        argv[argc++] = "--tohost";
+        argv[argc++] = tohost;
+    }
+    if (s->pass_on_limit) {
+        argv[argc++] = "--pass-on-limit";
+    }
+    argv[argc] = 0;
+
+    uint64_t t1 = RISCV_get_time_ms();
+    int started = batchSpawn(argv, logfile);
+    uint64_t wall = RISCV_get_time_ms() - t1;
+
+    AttributeType &item = p->results[idx];
+    AttributeType buf;
+    if (RISCV_read_json_file(resfile, &buf) > 0) {
+        item.from_config(buf.to_string());
+    }
+    if (!item.is_dict()) {
+        item.make_dict();
+        item["Status"].make_string("error");
+        item["Error"].make_string(started < 0
+                                  ? "Cannot start simulator process"
+                                  : "Simulator process failed");
+        item["Steps"].make_uint64(0);
+    }
+    item["Name"].make_string(elffile);
+    item["WallMs"].make_uint64(wall);
+    remove(resfile);
+    if (batchIsPassed(item)) {
+        remove(logfile);
+    } else {
+        item["Log"].make_string(logfile);
+    }
+
+    RISCV_mutex_lock(&p->mutex);
+    p->done++;
+    printf("[%3d/%d] %-7s %s steps=%" RV_PRI64 "d wall=%" RV_PRI64 "d ms\n",
+           p->done, p->results.size(), item["Status"].to_string(),
+           elffile, item["Steps"].to_uint64(), wall);
+    fflush(stdout);
+    RISCV_mutex_unlock(&p->mutex);
+}
+
+static thread_return_t batchWorker(void *args) {
+    BatchPoolType *p = reinterpret_cast<BatchWorkerType *>(args)->pool;
+    unsigned idx;
+    while (true) {
+        RISCV_mutex_lock(&p->mutex);
+        idx = p->next++;
+        RISCV_mutex_unlock(&p->mutex);
+        if (idx >= p->elflist->size()) {
+            break;
+        }
+        batchRunOne(p, idx);
+    }
+    return 0;
+}
+
+static void batchJsonString(FILE *f, const char *s) {
+    fputc('"', f);
+    for (; *s; s++) {
+        if (*s == '"' || *s == '\\') {
+            fputc('\\', f);
+        }
+        fputc(*s, f);
+    }
+    fputc('"', f);
+}
+
+static void batchXmlString(FILE *f, const char *s) {
+    for (; *s; s++) {
+        switch (*s) {
+        case '&': fputs("&amp;", f); break;
+        case '<': fputs("&lt;", f); break;
+        case '>': fputs("&gt;", f); break;
+        case '"': fputs("&quot;", f); break;
+        default: fputc(*s, f);
+        }
+    }
+}
+
+static void batchWriteJson(FILE *f, const AttributeType &results,
+                           unsigned failed, uint64_t wall) {
+    fprintf(f, "{\n  \"total\": %d,\n  \"failed\": %d,\n"
+               "  \"wall_ms\": %" RV_PRI64 "d,\n  \"tests\": [\n",
+            results.size(), failed, wall);
+    for (unsigned i = 0; i < results.size(); i++) {
+        const AttributeType &item = results[i];
+        fprintf(f, "    {\"name\": ");
+        batchJsonString(f, item["Name"].to_string());
+        fprintf(f, ", \"status\": \"%s\", \"instructions\": %" RV_PRI64 "d"
+                   ", \"wall_ms\": %" RV_PRI64 "d",
+                item["Status"].to_string(), item["Steps"].to_uint64(),
+                item["WallMs"].to_uint64());
+        if (item["TestNum"].is_integer()) {
+            fprintf(f, ", \"testnum\": %" RV_PRI64 "d",
+                    item["TestNum"].to_uint64());
+        }
+        if (item["Log"].is_string()) {
+            fprintf(f, ", \"log\": ");
+            batchJsonString(f, item["Log"].to_string());
+        }
+        fprintf(f, "}%s\n", i + 1 < results.size() ? "," : "");
+    }
+    fprintf(f, "  ]\n}\n");
+}
+
+static void batchWriteJUnit(FILE *f, const AttributeType &results,
+                            unsigned failed, uint64_t wall) {
+    fprintf(f, "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n");
+    fprintf(f, "<testsuite name=\"appdbg64g\" tests=\"%d\" failures=\"%d\""
+               " time=\"%.3f\">\n",
+            results.size(), failed, static_cast<double>(wall) / 1000.0);
+    for (unsigned i = 0; i < results.size(); i++) {
+        const AttributeType &item = results[i];
+        fprintf(f, "  <testcase name=\"");
+        batchXmlString(f, item["Name"].to_string());
+        fprintf(f, "\" time=\"%.3f\">\n",
+                static_cast<double>(item["WallMs"].to_uint64()) / 1000.0);
+        fprintf(f, "    <properties><property name=\"instructions\""
+                   " value=\"%" RV_PRI64 "d\"/></properties>\n",
+                item["Steps"].to_uint64());
+        if (!batchIsPassed(item)) {
+            fprintf(f, "    <failure type=\"%s\" message=\"",
+                    item["Status"].to_string());
+            if (item["Error"].is_string()) {
+                batchXmlString(f, item["Error"].to_string());
+            } else if (item["TestNum"].is_integer()) {
+                fprintf(f, "testnum %" RV_PRI64 "d",
+                        item["TestNum"].to_uint64());
+            }
+            fprintf(f, "\"/>\n");
+        }
+        fprintf(f, "  </testcase>\n");
+    }
+    fprintf(f, "</testsuite>\n");
+}
+
+int batchRunPool(const AttributeType &elflist, const BatchSettingsType *s) {
+    BatchPoolType pool;
+    pool.elflist = &elflist;
+    pool.s = s;
+    pool.results.make_list(elflist.size());
+    pool.next = 0;
+    pool.done = 0;
+    RISCV_mutex_init(&pool.mutex);
+
+    int jobs = s->jobs;
+    if (jobs > static_cast<int>(elflist.size())) {
+        jobs = static_cast<int>(elflist.size());
+    }
+    if (jobs < 1) {
+        jobs = 1;
+    }
+
+    uint64_t t1 = RISCV_get_time_ms();
+    BatchWorkerType *workers = new BatchWorkerType[jobs];
+    for (int i = 0; i < jobs; i++) {
+        workers[i].pool = &pool;
+        workers[i].th.func = reinterpret_cast<lib_thread_func>(batchWorker);
+        workers[i].th.args = &workers[i];
+        if (i > 0) {
+            RISCV_thread_create(&workers[i].th);
+        }
+    }
+    batchWorker(&workers[0]);
+    for (int i = 1; i < jobs; i++) {
+        RISCV_thread_join(workers[i].th.Handle, -1);    // no timeout
+    }
+    delete [] workers;
+    uint64_t wall = RISCV_get_time_ms() - t1;
+    RISCV_mutex_destroy(&pool.mutex);
+
+    unsigned failed = 0;
+    for (unsigned i = 0; i < pool.results.size(); i++) {
+        if (!batchIsPassed(pool.results[i])) {
+            failed++;
+        }
+    }
+    printf("Total %d, passed %d, failed %d, wall %" RV_PRI64 "d ms\n",
+           pool.results.size(), pool.results.size() - failed, failed, wall);
+
+    if (s->report) {
+        FILE *f = fopen(s->report, "wb");
+        if (!f) {
+            printf("Error: cannot write report %s\n", s->report);
+        } else {
+            size_t len = strlen(s->report);
+            if (len > 4 && strcmp(&s->report[len - 4], ".xml") == 0) {
+                batchWriteJUnit(f, pool.results, failed, wall);
+            } else {
+                batchWriteJson(f, pool.results, failed, wall);
+            }
+            fclose(f);
+        }
+    }
+    return failed ? 1 : 0;
+}
+
+}  // namespace debugger
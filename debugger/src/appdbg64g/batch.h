@@ -0,0 +1,62 @@
+/*
+ *  Copyright 2023 Sergey Khabarov, sergeykhbr@gmail.com
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ * Headless regression runner: every ELF-file of the list is simulated by
+ * its own appdbg64g process ('--run' mode), the parent process runs them
+ * with a pool of worker threads and writes the JSON or JUnit summary.
+ */
+
+#pragma once
+
+#include "api_core.h"
+#include "attribute.h"
+
+namespace debugger {
+
+static const int BATCH_JOBS_DEFAULT = 4;
+static const uint64_t BATCH_MAX_STEPS_DEFAULT = 100000000ull;
+static const int BATCH_TIMEOUT_SEC_DEFAULT = 600;
+
+struct BatchSettingsType {
+    const char *exename;        // path of the simulator executable
+    const char *cfgfile;        // platform configuration file
+    const char *report;         // summary *.json or *.xml
+    const char *result;         // '--run' mode output file
+    int jobs;
+    uint64_t max_steps;
+    uint64_t tohost;            // 0 = use 'tohost' symbol of the ELF-file
+    int timeout_sec;
+    bool pass_on_limit;         // no 'tohost': instructions limit is pass
+};
+
+/** Remove interactive services: GUI, console, TCP servers and trace files */
+void batchHeadlessConfig(AttributeType *cfg);
+
+/** '--run' mode: simulate one ELF-file in the configured platform.
+ *
+ * @return 0 if the test passed
+ */
+int batchRunTest(const char *elffile, const BatchSettingsType *s);
+
+/** '--batch' mode: run list of ELF-files with the pool of processes.
+ *
+ * @return 0 if all tests passed
+ */
+int batchRunPool(const AttributeType &elflist, const BatchSettingsType *s);
+
+/** Read list of ELF-files, one per line, '#' starts comment */
+int batchReadList(const char *filename, AttributeType *elflist);
+
+}  // namespace debugger
@@ -19,6 +19,7 @@
 #include "coreservices/ilink.h"
 #include "coreservices/ithread.h"
 #include "coreservices/icmdexec.h"
+#include "batch.h"
 #include <stdio.h>
 #include <string>
 
@@ -48,12 +49,27 @@ int main(int argc, char* argv[]) {
     AttributeType databuf;
     bool nogui = false;
     bool gui = false;
+    const char *batchlist = 0;
+    const char *runelf = 0;
+    BatchSettingsType batch;
+    memset(&batch, 0, sizeof(batch));
+    batch.jobs = BATCH_JOBS_DEFAULT;
+    batch.max_steps = BATCH_MAX_STEPS_DEFAULT;
+    batch.timeout_sec = BATCH_TIMEOUT_SEC_DEFAULT;
+
+    // Child processes re-run this executable by its absolute path
+    char exepath[1024];
+    batch.exename = argv[0];
+    if (RISCV_get_exe_path(exepath, sizeof(exepath)) == 0) {
+        batch.exename = exepath;
+    }
 
     // Parse arguments:
     if (argc > 1) {
         for (int i = 1; i < argc; i++) {
             if (strcmp(argv[i], "-c") == 0) {
                 i++;
+                batch.cfgfile = argv[i];
                 RISCV_read_json_file(argv[i], &databuf);
             } else if (strcmp(argv[i], "-p") == 0) {
                 i++;
@@ -62,6 +78,24 @@ int main(int argc, char* argv[]) {
                 nogui = true;
             } else if (strcmp(argv[i], "--gui") == 0) {
                 gui = true;
+            } else if (strcmp(argv[i], "--batch") == 0 && i + 1 < argc) {
+                batchlist = argv[++i];
+            } else if (strcmp(argv[i], "--run") == 0 && i + 1 < argc) {
+                runelf = argv[++i];
+            } else if (strcmp(argv[i], "--result") == 0 && i + 1 < argc) {
+                batch.result = argv[++i];
+            } else if (strcmp(argv[i], "--report") == 0 && i + 1 < argc) {
+                batch.report = argv[++i];
+            } else if (strcmp(argv[i], "-j") == 0 && i + 1 < argc) {
+                batch.jobs = atoi(argv[++i]);
+            } else if (strcmp(argv[i], "--max-steps") == 0 && i + 1 < argc) {
+                batch.max_steps = strtoull(argv[++i], 0, 0);
+            } else if (strcmp(argv[i], "--tohost") == 0 && i + 1 < argc) {
+                batch.tohost = strtoull(argv[++i], 0, 0);
+            } else if (strcmp(argv[i], "--timeout") == 0 && i + 1 < argc) {
+                batch.timeout_sec = atoi(argv[++i]);
+            } else if (strcmp(argv[i], "--pass-on-limit") == 0) {
+                batch.pass_on_limit = true;
             }
         }
     }
@@ -70,9 +104,25 @@ int main(int argc, char* argv[]) {
         printf("Error: Platform script file not defined\n");
         printf("       Use -c key to specify configuration file location:\n");
         printf("Example: appdbg64.exe -c ../../targets/default.json\n");
+        printf("Batch:   appdbg64.exe -c <cfg> --batch <list.txt> [-j N]\n");
+        printf("         [--report <file.json|file.xml>] [--max-steps N]\n");
+        printf("         [--tohost <addr>] [--timeout <sec>]\n");
+        printf("         [--pass-on-limit]\n");
         return 0;
     }
 
+    /** Batch mode: simulator instances are the child processes */
+    if (batchlist) {
+        AttributeType elflist;
+        if (batchReadList(batchlist, &elflist) || elflist.size() == 0) {
+            printf("Error: empty or missing tests list %s\n", batchlist);
+            return 1;
+        }
+        int ret = batchRunPool(elflist, &batch);
+        RISCV_cleanup();
+        return ret;
+    }
+
     Config.from_config(databuf.to_string());
 	
 	/** Disable GUI using application arguments list */
@@ -107,9 +157,13 @@ int main(int argc, char* argv[]) {
         }
     }
 
+    if (runelf) {
+        batchHeadlessConfig(&Config);
+    }
+
     if (RISCV_set_configuration(&Config)) {
         printf("Error: can't instantiate configuration\n");
-        return 0;
+        return runelf ? 1 : 0;
     }
 
     AttributeType res;
@@ -123,6 +177,15 @@ int main(int argc, char* argv[]) {
         }
     }
 
+    if (runelf) {
+        int ret = batchRunTest(runelf, &batch);
+        // Stop the threads the same way as the 'exit' command
+        RISCV_break_simulation();
+        RISCV_dispatcher_start();
+        RISCV_cleanup();
+        return ret;
+    }
+
     /** Main loop */
     RISCV_dispatcher_start();
     databuf.attr_free();
@@ -297,6 +297,16 @@ void* RISCV_memshare_map(sharemem_def h, int sz);
 void RISCV_memshare_unmap(void *buf, int sz);
 void RISCV_memshare_delete(sharemem_def h);
 
+/**
+ * @brief Map file into the process address space.
+ * @details Mapping is private (copy-on-write) so that modification of the
+ *          mapped content never reaches the file on disk.
+ * @param [out] sz File size in bytes.
+ * @return Pointer on the mapped file content or 0 if failed.
+ */
+void *RISCV_file_map(const char *filename, uint64_t *sz);
+void RISCV_file_unmap(void *buf, uint64_t sz);
+
 /** Memory allocator/de-allocator */
 void *RISCV_malloc(uint64_t sz);
 void RISCV_free(void *p);
@@ -305,6 +315,9 @@ void RISCV_free(void *p);
 int RISCV_get_core_folder(char *out, int sz);
 int RISCV_get_core_folderw(wchar_t* out, int sz);
 
+/** Get absolute path of the running executable file. */
+int RISCV_get_exe_path(char *out, int sz);
+
 /** Set $(pwd) directory equals to executable location */
 void RISCV_set_current_dir();
 
@@ -0,0 +1,68 @@
+/*
+ *  Copyright 2023 Sergey Khabarov, sergeykhbr@gmail.com
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#ifndef __DEBUGGER_COMMON_CORESERVICES_ICALLGRAPH_H__
+#define __DEBUGGER_COMMON_CORESERVICES_ICALLGRAPH_H__
+
+#include <inttypes.h>
+#include <iface.h>
+#include <attribute.h>
+
+namespace debugger {
+
+static const char *const IFACE_CALL_GRAPH = "ICallGraph";
+
+enum ECallGraphFunc {
+    CallGraphFunc_address,      // entry point or PC when profiling started
+    CallGraphFunc_calls,
+    CallGraphFunc_inclusive,    // executed instructions including callees
+    CallGraphFunc_exclusive,
+    CallGraphFunc_Total
+};
+
+enum ECallGraphEdge {
+    CallGraphEdge_caller,
+    CallGraphEdge_callee,
+    CallGraphEdge_calls,
+    CallGraphEdge_inclusive,
+    CallGraphEdge_Total
+};
+
+/**
+ * @brief Exact call graph of the CPU model.
+ * @details Updated by the call/return instructions via pushStackTrace()
+ *          and popStackTrace(), counters are the CPU clock steps.
+ */
+class ICallGraph : public IFace {
+ public:
+    ICallGraph() : IFace(IFACE_CALL_GRAPH) {}
+
+    virtual void enableCallGraph(bool en) = 0;
+    virtual bool isCallGraphEnabled() = 0;
+    virtual void clearCallGraph() = 0;
+
+    /** Functions still on the call stack are included with the
+     *  counters accumulated up to the current step.
+     *
+     * @param[out] funcs List of ECallGraphFunc items
+     * @param[out] edges List of ECallGraphEdge items
+     */
+    virtual void getCallGraph(AttributeType *funcs, AttributeType *edges) = 0;
+};
+
+}  // namespace debugger
+
+#endif  // __DEBUGGER_COMMON_CORESERVICES_ICALLGRAPH_H__
@@ -80,7 +80,23 @@ class ICommandRiscv : public ICommand {
             {"cycle",   8, 0xc00},
             {"time",    8, 0xc01},
             {"insret",  8, 0xc02},
+            {"fflags",   8, 0x001},
+            {"frm",      8, 0x002},
+            {"fcsr",     8, 0x003},
+            {"mstatus",  8, 0x300},
+            {"misa",     8, 0x301},
+            {"medeleg",  8, 0x302},
+            {"mideleg",  8, 0x303},
+            {"mie",      8, 0x304},
+            {"mtvec",    8, 0x305},
+            {"mscratch", 8, 0x340},
+            {"mepc",     8, 0x341},
+            {"mcause",   8, 0x342},
+            {"mtval",    8, 0x343},
+            {"mip",      8, 0x344},
+            {"mhartid",  8, 0xf14},
             {"r0",    8, 0x1000},
+            {"zero",  8, 0x1000},
             {"ra",    8, 0x1001},
             {"sp",    8, 0x1002},
             {"gp",    8, 0x1003},
@@ -112,6 +128,38 @@ class ICommandRiscv : public ICommand {
             {"t4",    8, 0x101D},
             {"t5",    8, 0x101E},
             {"t6",    8, 0x101F},
+            {"ft0",   8, 0x1020},
+            {"ft1",   8, 0x1021},
+            {"ft2",   8, 0x1022},
+            {"ft3",   8, 0x1023},
+            {"ft4",   8, 0x1024},
+            {"ft5",   8, 0x1025},
+            {"ft6",   8, 0x1026},
+            {"ft7",   8, 0x1027},
+            {"fs0",   8, 0x1028},
+            {"fs1",   8, 0x1029},
+            {"fa0",   8, 0x102A},
+            {"fa1",   8, 0x102B},
+            {"fa2",   8, 0x102C},
+            {"fa3",   8, 0x102D},
+            {"fa4",   8, 0x102E},
+            {"fa5",   8, 0x102F},
+            {"fa6",   8, 0x1030},
+            {"fa7",   8, 0x1031},
+            {"fs2",   8, 0x1032},
+            {"fs3",   8, 0x1033},
+            {"fs4",   8, 0x1034},
+            {"fs5",   8, 0x1035},
+            {"fs6",   8, 0x1036},
+            {"fs7",   8, 0x1037},
+            {"fs8",   8, 0x1038},
+            {"fs9",   8, 0x1039},
+            {"fs10",  8, 0x103A},
+            {"fs11",  8, 0x103B},
+            {"ft8",   8, 0x103C},
+            {"ft9",   8, 0x103D},
+            {"ft10",  8, 0x103E},
+            {"ft11",  8, 0x103F},
             {"stktr_cnt",   8, 0xC040},     // Non-standart extension. Stack trace counter
             {"stktr_buf",   8, 0xC080},     // Non-standart extension. Stack trace buffer
             {"",            0, 0}
@@ -178,7 +226,7 @@ class ICommandRiscv : public ICommand {
         return get_reg(reg2addr(regname), regsize(regname), res);
     }
 
-    virtual uint32_t set_reg(const char *regname, Reg64Type *val) {
+    virtual uint32_t set_reg(uint32_t regaddr, uint32_t regsize, Reg64Type *val) {
         IJtag::dmi_command_type command;
         uint32_t cmderr;
 
@@ -187,11 +235,11 @@ class ICommandRiscv : public ICommand {
 
         command.u32 = 0;
         command.regaccess.cmdtype = 0;
-        command.regaccess.aarsize = regsize(regname);
+        command.regaccess.aarsize = regsize;
         command.regaccess.write = 1;
         command.regaccess.transfer = 1;
         command.regaccess.aarpostincrement = 1;
-        command.regaccess.regno = reg2addr(regname);
+        command.regaccess.regno = regaddr;
 
         write_dmi(IJtag::DMI_COMMAND, command.u32);
         cmderr = wait_dmi();
@@ -202,6 +250,10 @@ class ICommandRiscv : public ICommand {
         return cmderr;
     }
 
+    virtual uint32_t set_reg(const char *regname, Reg64Type *val) {
+        return set_reg(reg2addr(regname), regsize(regname), val);
+    }
+
  protected:
     IJtag *ijtag_;
 };
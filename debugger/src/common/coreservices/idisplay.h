@@ -33,15 +33,21 @@ class GenericDisplayCmdType : public ICommand {
             "    Read display resolution using config command\n"
             "    or frame using 'frame' subcommand.\n"
             "    Additional option 'encoded' allows reduce frame buffer\n"
-            "    size.\n"
+            "    size. Option 'diff <seq>' returns only rectangles modified\n"
+            "    since the frame 'Seq' received by the client. The whole\n"
+            "    frame is returned when 'seq' is 0 or unknown.\n"
             "Response config:\n"
             "    List {Width:w,Height:h,BkgColor:0x00ff00}\n"
             "Response 'frame':\n"
             "    List [b0,b1,b1,...],\n"
-            "          Bytes of column0,column1,etcn"
+            "          Bytes of column0,column1,etc\n"
+            "Response 'frame diff':\n"
+            "    {Seq:n,Rects:[[x,y,w,h,[b0,b1,...]],...]}\n"
+            "          Frame sequence number and modified rectangles\n"
             "Usage:\n"
             "    display0 config\n"
             "    display0 frame\n"
+            "    display0 frame diff 0\n"
             "    display0 frame encoded");
     }
 
@@ -64,10 +70,14 @@ class GenericDisplayCmdType : public ICommand {
             (*res)["BkgColor"].make_uint64(getBkgColor());
         } else if (type.is_equal("frame")) {
             bool diff = false;
+            uint64_t seq = 0;
             if (args->size() > 2 && (*args)[2].is_equal("diff")) {
                 diff = true;
+                if (args->size() > 3 && (*args)[3].is_integer()) {
+                    seq = (*args)[3].to_uint64();
+                }
             }
-            getFrame(res, diff);
+            getFrame(res, diff, seq);
             if (args->size() > 2 && (*args)[2].is_equal("encoded")) {
                 encode(res);
             }
@@ -78,7 +88,7 @@ class GenericDisplayCmdType : public ICommand {
     virtual int getWidth() = 0;
     virtual int getHeight() = 0;
     virtual uint32_t getBkgColor() = 0;     // distance between pixels
-    virtual void getFrame(AttributeType *res, bool diff) = 0;
+    virtual void getFrame(AttributeType *res, bool diff, uint64_t seq) = 0;
     virtual void encode(AttributeType *frame) {
         if (!frame->is_data()) {
             return;
@@ -40,6 +40,21 @@ class IElfReader : public IFace {
     virtual uint64_t sectionSize(unsigned idx) = 0;
 
     virtual uint8_t *sectionData(unsigned idx) = 0;
+
+    /** Section contains executable machine instructions */
+    virtual bool sectionExecutable(unsigned idx) = 0;
+
+    /** PT_LOAD segments of the program header table */
+    virtual unsigned loadableSegmentTotal() = 0;
+
+    virtual uint64_t segmentAddress(unsigned idx) = 0;
+
+    /** Bytes stored in file. The rest up to memsz must be zero filled */
+    virtual uint64_t segmentFileSize(unsigned idx) = 0;
+
+    virtual uint64_t segmentMemSize(unsigned idx) = 0;
+
+    virtual uint8_t *segmentData(unsigned idx) = 0;
 };
 
 }  // namespace debugger
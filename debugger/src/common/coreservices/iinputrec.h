@@ -0,0 +1,63 @@
+/*
+ *  Copyright 2023 Sergey Khabarov, sergeykhbr@gmail.com
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#ifndef __DEBUGGER_COMMON_CORESERVICES_IINPUTREC_H__
+#define __DEBUGGER_COMMON_CORESERVICES_IINPUTREC_H__
+
+#include <inttypes.h>
+#include <iface.h>
+#include <attribute.h>
+
+namespace debugger {
+
+static const char *const IFACE_INPUT_SOURCE = "IInputSource";
+
+/**
+ * @brief Device receiving asynchronous inputs (UART RX, keys, debug
+ *        halt requests) from the host threads.
+ */
+class IInputSource : public IFace {
+ public:
+    IInputSource() : IFace(IFACE_INPUT_SOURCE) {}
+
+    /** Apply the event, called from the simulation thread */
+    virtual void applyInput(AttributeType *event) = 0;
+};
+
+static const char *const IFACE_INPUT_RECORDER = "IInputRecorder";
+
+/**
+ * @brief Record/replay of the asynchronous inputs at the clock steps.
+ * @details Source passes every input event to putInput(). If it returns
+ *          true the event is applied later with IInputSource::applyInput()
+ *          at the step stored in the log (record) or read from it (replay).
+ *          Otherwise the source applies the event itself.
+ */
+class IInputRecorder : public IFace {
+ public:
+    IInputRecorder() : IFace(IFACE_INPUT_RECORDER) {}
+
+    virtual void registerInputSource(const char *name, IInputSource *src) = 0;
+    virtual void unregisterInputSource(IInputSource *src) = 0;
+
+    virtual bool putInput(IInputSource *src, AttributeType *event) = 0;
+
+    virtual bool isReplay() = 0;
+};
+
+}  // namespace debugger
+
+#endif  // __DEBUGGER_COMMON_CORESERVICES_IINPUTREC_H__
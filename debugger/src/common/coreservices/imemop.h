@@ -33,6 +33,7 @@ static const int PAYLOAD_MAX_BYTES = 8;
 enum EAxi4Action {
     MemAction_Read,
     MemAction_Write,
+    MemAction_Backdoor,     // getHostPointer() only: image loaders
     MemAction_Total
 };
 
@@ -113,6 +114,22 @@ class IMemoryOperation : public IFace {
         return ret;
     }
 
+    /**
+     * Direct access to the host memory of RAM-backed device
+     *
+     * Returns pointer on the byte at address 'addr' and the number of bytes
+     * available from this pointer in 'avail', or 0 if the device doesn't
+     * allow direct access for the specified action (side effects, read-only
+     * memory and so on). Pointer stays valid until the device is deleted.
+     * MemAction_Backdoor returns writable pointer on the backing storage
+     * of read-only memory too, it is used to load images and must not be
+     * requested by the simulated bus masters.
+     */
+    virtual uint8_t *getHostPointer(uint64_t addr, EAxi4Action action,
+                                    uint64_t *avail) {
+        return 0;
+    }
+
     virtual uint64_t getBaseAddress() { return baseAddress_.to_uint64(); }
     virtual void setBaseAddress(uint64_t addr) {
         baseAddress_.make_uint64(addr);
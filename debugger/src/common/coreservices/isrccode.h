@@ -68,6 +68,22 @@ enum EColumnNames {
 
 static const uint64_t BreakFlag_HW = (1 << 0);
 
+static const char *const IFACE_SYMBOL_TABLE = "ISymbolTable";
+
+/**
+ * Symbol table owned by the debug info reader (ELF). Lookup methods use
+ * the same formats as ISourceCode: info = [name, offset], list items are
+ * ESymbolInfoListItem. They return false/-1 if symbol not found.
+ */
+class ISymbolTable : public IFace {
+ public:
+    ISymbolTable() : IFace(IFACE_SYMBOL_TABLE) {}
+
+    virtual void getSymbols(AttributeType *list) = 0;
+    virtual bool addressToSymbol(uint64_t addr, AttributeType *info) = 0;
+    virtual int symbol2Address(const char *name, uint64_t *addr) = 0;
+};
+
 class ISourceCode : public IFace {
  public:
     ISourceCode() : IFace(IFACE_SOURCE_CODE) {}
@@ -82,6 +98,8 @@ class ISourceCode : public IFace {
 
     virtual void clearSymbols() = 0;
     virtual void addSymbols(AttributeType *list) = 0;
+    /** Lookups are served by the table first, then by added symbols */
+    virtual void setSymbolTable(ISymbolTable *tbl) = 0;
 
     virtual void getSymbols(AttributeType *list) = 0;
 
@@ -0,0 +1,77 @@
+/*
+ *  Copyright 2023 Sergey Khabarov, sergeykhbr@gmail.com
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#ifndef __DEBUGGER_COMMON_CORESERVICES_IWATCHPOINT_H__
+#define __DEBUGGER_COMMON_CORESERVICES_IWATCHPOINT_H__
+
+#include <inttypes.h>
+#include <iface.h>
+#include <attribute.h>
+
+namespace debugger {
+
+static const char *const IFACE_WATCHPOINT = "IWatchpoint";
+
+static const uint32_t WatchFlag_Read  = (1 << 0);
+static const uint32_t WatchFlag_Write = (1 << 1);
+static const uint32_t WatchFlag_Value = (1 << 2);   // data must be equal
+
+enum EWatchList {
+    WatchList_address,
+    WatchList_length,
+    WatchList_flags,
+    WatchList_value,
+    WatchList_Total
+};
+
+/**
+ * @brief Data watchpoints of the CPU model load/store path.
+ * @details CPU halts after the instruction that accessed the range.
+ */
+class IWatchpoint : public IFace {
+ public:
+    IWatchpoint() : IFace(IFACE_WATCHPOINT) {}
+
+    /** Add or update watchpoint, flags is a combination of WatchFlag_*.
+     *
+     * @param[in] addr  First byte of the watched range
+     * @param[in] len   Range length in bytes
+     * @param[in] value Compared with the accessed data if WatchFlag_Value
+     * @return 0 if no errors
+     */
+    virtual int addWatchpoint(uint64_t addr, uint64_t len,
+                              uint32_t flags, uint64_t value) = 0;
+
+    /** Remove watchpoint with the same range and access flags.
+     *
+     * @return 0 if no errors
+     */
+    virtual int removeWatchpoint(uint64_t addr, uint64_t len,
+                                 uint32_t flags) = 0;
+
+    /** List of [addr, len, flags, value] items, see EWatchList */
+    virtual void getWatchpointList(AttributeType *list) = 0;
+
+    /** Flags of the watchpoint caused the last halt, 0 otherwise.
+     *
+     * @param[out] addr Accessed address inside of the watched range
+     */
+    virtual uint32_t getWatchpointHit(uint64_t *addr) = 0;
+};
+
+}  // namespace debugger
+
+#endif  // __DEBUGGER_COMMON_CORESERVICES_IWATCHPOINT_H__
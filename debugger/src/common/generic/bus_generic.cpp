@@ -140,6 +140,36 @@ ETransStatus BusGeneric::nb_transport(Axi4TransactionType *trans,
     return ret;
 }
 
+/** Only hash slots with the single device are allowed for the direct
+    access, region is clipped by the slot boundary so that overlapped
+    devices with the higher priority cannot be bypassed. */
+uint8_t *BusGeneric::getHostPointer(uint64_t addr, EAxi4Action action,
+                                    uint64_t *avail) {
+    uint8_t *ret = 0;
+    uint64_t slotend;
+    uint64_t devend;
+
+    RISCV_mutex_lock(&mutexBAccess_);
+    uint64_t hashidx = (addr & ADDR_MASK_) >> HASH_LVL1_OFFSET_;
+    IMemoryOperation *imem = imemtbl_[hashidx].idev;
+    if (imem && imem->getBaseAddress() <= addr
+        && addr < imem->getBaseAddress() + imem->getLength()) {
+        ret = imem->getHostPointer(addr, action, avail);
+    }
+    if (ret) {
+        slotend = ((addr >> HASH_LVL1_OFFSET_) + 1) << HASH_LVL1_OFFSET_;
+        devend = imem->getBaseAddress() + imem->getLength();
+        if (devend < slotend) {
+            slotend = devend;
+        }
+        if (*avail > slotend - addr) {
+            *avail = slotend - addr;
+        }
+    }
+    RISCV_mutex_unlock(&mutexBAccess_);
+    return ret;
+}
+
 void BusGeneric::getMapedDevice(Axi4TransactionType *trans,
                          IMemoryOperation **pdev, uint32_t *sz) {
     IMemoryOperation *imem;
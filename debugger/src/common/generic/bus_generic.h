@@ -39,6 +39,8 @@ class BusGeneric : public IService,
     virtual ETransStatus b_transport(Axi4TransactionType *trans);
     virtual ETransStatus nb_transport(Axi4TransactionType *trans,
                                       IAxi4NbResponse *cb);
+    virtual uint8_t *getHostPointer(uint64_t addr, EAxi4Action action,
+                                    uint64_t *avail);
 
     /** IHap */
     virtual void hapTriggered(EHapType type, uint64_t param,
@@ -29,8 +29,11 @@ CpuGeneric::CpuGeneric(const char *name)
     registerInterface(static_cast<IClock *>(this));
     registerInterface(static_cast<ICpuFunctional *>(this));
     registerInterface(static_cast<IDPort *>(this));
+    registerInterface(static_cast<IWatchpoint *>(this));
+    registerInterface(static_cast<ICallGraph *>(this));
     registerInterface(static_cast<IPower *>(this));
     registerInterface(static_cast<IResetListener *>(this));
+    registerInterface(static_cast<IInputSource *>(this));
     registerInterface(static_cast<IHap *>(this));
     registerAttribute("Enable", &isEnable_);
     registerAttribute("SysBus", &sysBus_);
@@ -49,11 +52,11 @@ CpuGeneric::CpuGeneric(const char *name)
     registerAttribute("TriggersTotal", &triggersTotal_);
     registerAttribute("McontrolMaskmax", &mcontrolMaskmax_);
     registerAttribute("ResetState", &resetState_);
+    registerAttribute("CallGraph", &callGraph_);
 
     char tstr[256];
     RISCV_sprintf(tstr, sizeof(tstr), "eventConfigDone_%s", name);
     RISCV_event_create(&eventConfigDone_, tstr);
-    RISCV_mutex_init(&mutex_csr_);
     RISCV_register_hap(static_cast<IHap *>(this));
 
     isysbus_ = 0;
@@ -69,6 +72,13 @@ CpuGeneric::CpuGeneric(const char *name)
     resumereq_ = false;
 
     ptriggers_ = 0;
+    trigRange_ = 0;
+    trigDirty_ = false;
+    trigExecTotal_ = 0;
+    trigRangeTotal_ = 0;
+    trigICountTotal_ = 0;
+    trigAlways_ = false;
+    memset(trigExecMap_, 0, sizeof(trigExecMap_));
     trace_file_ = 0;
     memset(&trace_data_, 0, sizeof(trace_data_));
     icache_ = 0;
@@ -79,6 +89,22 @@ CpuGeneric::CpuGeneric(const char *name)
     CACHE_BASE_ADDR_ = 0;
     CACHE_MASK_ = 0;
     oplen_ = 0;
+    wpTotal_ = 0;
+    memset(wpPageMap_, 0, sizeof(wpPageMap_));
+    wpPending_ = false;
+    wpHitFlags_ = 0;
+    wpHitAddr_ = 0;
+    wpDescr_[0] = '\0';
+    cgEnabled_ = false;
+    cgFunc_ = 0;
+    cgEdge_ = 0;
+    cgFuncSz_ = 0;
+    cgEdgeSz_ = 0;
+    cgResize(CALL_GRAPH_TABLE_MIN, CALL_GRAPH_TABLE_MIN);
+    cgDepth_ = 0;
+    cgOverflow_ = 0;
+    irec_ = 0;
+    RISCV_mutex_init(&mutexCallGraph_);
     RISCV_set_default_clock(static_cast<IClock *>(this));
 
     R = portRegs_.getpR64();
@@ -91,13 +117,16 @@ CpuGeneric::CpuGeneric(const char *name)
 CpuGeneric::~CpuGeneric() {
     RISCV_set_default_clock(0);
     RISCV_event_close(&eventConfigDone_);
-    RISCV_mutex_destroy(&mutex_csr_);
     if (icache_) {
         delete [] icache_;
     }
     if (ptriggers_) {
         delete [] ptriggers_;
     }
+    delete [] trigRange_;
+    delete [] cgFunc_;
+    delete [] cgEdge_;
+    RISCV_mutex_destroy(&mutexCallGraph_);
     if (trace_file_) {
         trace_file_->close();
         delete trace_file_;
@@ -146,10 +175,22 @@ void CpuGeneric::postinitService() {
         return;
     }
 
+    AttributeType lstServ;
+    RISCV_get_services_with_iface(IFACE_INPUT_RECORDER, &lstServ);
+    if (lstServ.size() != 0) {
+        IService *iserv = static_cast<IService *>(lstServ[0u].to_iface());
+        irec_ = static_cast<IInputRecorder *>(
+                            iserv->getInterface(IFACE_INPUT_RECORDER));
+        irec_->registerInputSource(getObjName(),
+                                   static_cast<IInputSource *>(this));
+    }
+
     stackTraceBuf_.setRegTotal(2 * stackTraceSize_.to_int());
 
     ptriggers_ = new TriggerStorageType[triggersTotal_.to_int()];
     memset(ptriggers_, 0, triggersTotal_.to_int()*sizeof(TriggerStorageType));
+    trigRange_ = new TriggerRangeType[triggersTotal_.to_int() + 1];
+    invalidateTriggers();
 
     CACHE_BASE_ADDR_ = cacheBaseAddr_.to_uint64();
     CACHE_MASK_ = ~cacheAddrMask_.to_uint64();
@@ -173,6 +214,9 @@ void CpuGeneric::postinitService() {
 
     setPC(getResetAddress());
     setNPC(getResetAddress());
+    if (callGraph_.to_bool()) {
+        enableCallGraph(true);
+    }
 }
 
 void CpuGeneric::hapTriggered(EHapType type,
@@ -249,6 +293,10 @@ bool CpuGeneric::updateState() {
             haltreq_ = false;
             upd = false;
             halt(HALT_CAUSE_HALTREQ, "External Halt request");
+        } else if (wpPending_) {
+            wpPending_ = false;
+            upd = false;
+            halt(HALT_CAUSE_TRIGGER, wpDescr_);
         } else if (isTriggerICount()) {
             upd = false;
             halt(HALT_CAUSE_TRIGGER, "Trigger icount hit");
@@ -302,7 +350,7 @@ void CpuGeneric::fetchILine() {
         trans_.addr = getPC();
         trans_.xsize = 4;
         trans_.wstrb = 0;
-        if (dma_memop(&trans_) == TRANS_ERROR) {
+        if (memop(&trans_) == TRANS_ERROR) {
             generateExceptionLoadInstruction(trans_.addr);
             handleTrap();
             setPC(getNPC());
@@ -424,6 +472,9 @@ void CpuGeneric::setBranch(uint64_t npc) {
 
 void CpuGeneric::pushStackTrace() {
     int cnt = static_cast<int>(stackTraceCnt_.getValue().val);
+    if (cgEnabled_) {
+        cgPush(getNPC());
+    }
     if (cnt >= stackTraceSize_.to_int()) {
         return;
     }
@@ -437,9 +488,26 @@ void CpuGeneric::popStackTrace() {
     if (cnt) {
         stackTraceCnt_.setValue(cnt - 1);
     }
+    if (cgEnabled_) {
+        cgPop();
+    }
 }
 
 ETransStatus CpuGeneric::dma_memop(Axi4TransactionType *tr) {
+    ETransStatus ret = memop(tr);
+    uint64_t page;
+    // Instructions load/store path: only watched pages are checked
+    if (wpTotal_ && estate_ == CORE_Normal) {
+        page = tr->addr >> WATCH_PAGE_SHIFT;
+        if ((wpPageMap_[(page >> 6) & (WATCH_PAGE_MAP_SZ - 1)]
+                >> (page & 0x3F)) & 0x1) {
+            checkWatchpoint(tr);
+        }
+    }
+    return ret;
+}
+
+ETransStatus CpuGeneric::memop(Axi4TransactionType *tr) {
     ETransStatus ret = TRANS_OK;
     tr->source_idx = sysBusMasterID_.to_int();
     if (tr->xsize <= sysBusWidthBytes_.to_uint32()) {
@@ -476,10 +544,31 @@ ETransStatus CpuGeneric::dma_memop(Axi4TransactionType *tr) {
     return ret;
 }
 
+void CpuGeneric::haltreq() {
+    AttributeType ev;
+    ev.make_list(1);
+    ev[0u].make_string("halt");
+    // Resume is always issued while halted and doesn't need a step stamp.
+    // Live debugger requests still work while replaying the log.
+    if (irec_ && !irec_->isReplay()
+        && irec_->putInput(static_cast<IInputSource *>(this), &ev)) {
+        return;
+    }
+    haltreq_ = true;
+}
+
+void CpuGeneric::applyInput(AttributeType *event) {
+    if ((*event)[0u].is_equal("halt")) {
+        haltreq_ = true;
+    }
+}
+
 void CpuGeneric::resume() {
     if (estate_ == CORE_OFF) {
         RISCV_error("CPU is turned-off", 0);
     }
+    wpPending_ = false;
+    wpHitFlags_ = 0;
     estate_ = CORE_Normal;
 }
 
@@ -491,7 +580,9 @@ void CpuGeneric::halt(uint32_t cause, const char *descr) {
     char strop[32];
     uint8_t tbyte;
     unsigned bytetot = oplen_;
-    if (cause == HALT_CAUSE_TRIGGER || cause == HALT_CAUSE_EBREAK) {
+    if (cause == HALT_CAUSE_EBREAK
+        || (cause == HALT_CAUSE_TRIGGER && !wpHitFlags_)) {
+        // Instruction wasn't executed, watchpoint halts after the access
         enterDebugMode(getPC(), cause);
     } else {
         enterDebugMode(getNPC(), cause);
@@ -517,11 +608,20 @@ void CpuGeneric::halt(uint32_t cause, const char *descr) {
                        getPC(), strop, descr);
     }
     estate_ = CORE_Halted;
+    // CpuMonitor restores breakpoints and then triggers HAP_Halt
+    RISCV_trigger_hap(HAP_CpuHalted, getHartId(),
+                      descr ? descr : "CPU halted");
 }
 
 bool CpuGeneric::isTriggerICount() {
     bool ret = false;
     TriggerStorageType *pt;
+    if (trigDirty_) {
+        compileTriggers();
+    }
+    if (trigICountTotal_ == 0) {
+        return false;
+    }
     for (unsigned i = 0; i < triggersTotal_.to_uint32(); i++) {
         pt = &ptriggers_[i];
         if (pt->data1.bitsdef.type == TriggerType_InstrCountMatch) {
@@ -566,15 +666,267 @@ void CpuGeneric::reset(IFace *isource) {
         memset(ptriggers_,
                0,
                triggersTotal_.to_int()*sizeof(TriggerStorageType));
+        invalidateTriggers();
     }
     stackTraceCnt_.reset(isource);
     interrupt_pending_[0] = 0;
     interrupt_pending_[1] = 0;
     do_not_cache_ = false;
+    wpPending_ = false;
+    if (cgEnabled_) {
+        RISCV_mutex_lock(&mutexCallGraph_);
+        cgResetStack(getResetAddress());
+        RISCV_mutex_unlock(&mutexCallGraph_);
+    }
+}
+
+int CpuGeneric::addWatchpoint(uint64_t addr, uint64_t len,
+                              uint32_t flags, uint64_t value) {
+    WatchpointType *p;
+    uint32_t acc = WatchFlag_Read | WatchFlag_Write;
+    int total = wpTotal_;
+    int idx = total;
+    if (len == 0 || (flags & acc) == 0) {
+        return -1;
+    }
+    for (int i = 0; i < total; i++) {
+        p = &wp_[i];
+        if (p->flags == 0) {
+            if (idx == total) {
+                idx = i;
+            }
+            continue;
+        }
+        if (p->addr == addr && p->len == len
+            && (p->flags & acc) == (flags & acc)) {
+            p->flags = flags;
+            p->value = value;
+            return 0;
+        }
+    }
+    if (idx >= WATCHPOINTS_MAX) {
+        RISCV_error("Watchpoints limit %d reached", WATCHPOINTS_MAX);
+        return -1;
+    }
+    if (idx == total) {
+        total++;
+    }
+    // Slot stays dead (flags = 0) until its fields and the filter are set
+    p = &wp_[idx];
+    p->addr = addr;
+    p->len = len;
+    p->value = value;
+    updateWatchPages(total);
+    RISCV_memory_barrier();
+    p->flags = flags;
+    RISCV_memory_barrier();
+    wpTotal_ = total;
+    return 0;
+}
+
+int CpuGeneric::removeWatchpoint(uint64_t addr, uint64_t len,
+                                 uint32_t flags) {
+    uint32_t acc = WatchFlag_Read | WatchFlag_Write;
+    int total = wpTotal_;
+    for (int i = 0; i < total; i++) {
+        if (wp_[i].flags == 0 || wp_[i].addr != addr || wp_[i].len != len
+            || (wp_[i].flags & acc) != (flags & acc)) {
+            continue;
+        }
+        // Entries aren't moved while the simulation thread may read them:
+        // the slot is marked dead and only trailing dead slots are dropped.
+        wp_[i].flags = 0;
+        RISCV_memory_barrier();
+        wp_[i].len = 0;
+        while (total > 0 && wp_[total - 1].flags == 0) {
+            total--;
+        }
+        wpTotal_ = total;
+        RISCV_memory_barrier();
+        updateWatchPages(total);
+        return 0;
+    }
+    return -1;
+}
+
+void CpuGeneric::getWatchpointList(AttributeType *list) {
+    int total = wpTotal_;
+    list->make_list(0);
+    for (int i = 0; i < total; i++) {
+        if (wp_[i].flags == 0) {
+            continue;
+        }
+        AttributeType item;
+        item.make_list(WatchList_Total);
+        item[WatchList_address].make_uint64(wp_[i].addr);
+        item[WatchList_length].make_uint64(wp_[i].len);
+        item[WatchList_flags].make_uint64(wp_[i].flags);
+        item[WatchList_value].make_uint64(wp_[i].value);
+        list->add_to_list(&item);
+    }
+}
+
+uint32_t CpuGeneric::getWatchpointHit(uint64_t *addr) {
+    *addr = wpHitAddr_;
+    return wpHitFlags_;
+}
+
+void CpuGeneric::updateWatchPages(int total) {
+    uint64_t map[WATCH_PAGE_MAP_SZ];
+    uint64_t start, end;
+    memset(map, 0, sizeof(map));
+    for (int i = 0; i < total; i++) {
+        if (wp_[i].len == 0) {
+            continue;
+        }
+        // Unaligned access up to 8 bytes may start on the previous page
+        start = (wp_[i].addr - 7) >> WATCH_PAGE_SHIFT;
+        end = (wp_[i].addr + wp_[i].len - 1) >> WATCH_PAGE_SHIFT;
+        if (wp_[i].addr < 7) {
+            start = 0;
+        }
+        if (end - start >= 64 * WATCH_PAGE_MAP_SZ) {
+            memset(map, 0xFF, sizeof(map));
+            break;
+        }
+        for (uint64_t page = start; page <= end; page++) {
+            map[(page >> 6) & (WATCH_PAGE_MAP_SZ - 1)] |=
+                1ull << (page & 0x3F);
+        }
+    }
+    memcpy(wpPageMap_, map, sizeof(map));
+}
+
+void CpuGeneric::checkWatchpoint(Axi4TransactionType *tr) {
+    WatchpointType *p;
+    uint32_t acc;
+    uint32_t flags;
+    uint64_t data = 0;
+    uint64_t mask = ~0ull;
+    uint32_t sz = tr->xsize < 8 ? tr->xsize : 8;
+    if (tr->action == MemAction_Write) {
+        acc = WatchFlag_Write;
+        memcpy(&data, tr->wpayload.b8, sz);
+    } else {
+        acc = WatchFlag_Read;
+        memcpy(&data, tr->rpayload.b8, sz);
+    }
+    if (sz < 8) {
+        mask = (1ull << (8 * sz)) - 1;
+    }
+
+    for (int i = 0; i < wpTotal_; i++) {
+        p = &wp_[i];
+        flags = p->flags;
+        if ((flags & acc) == 0
+            || tr->addr + tr->xsize <= p->addr
+            || tr->addr >= p->addr + p->len) {
+            continue;
+        }
+        if ((flags & WatchFlag_Value) && ((data ^ p->value) & mask)) {
+            continue;
+        }
+        wpPending_ = true;
+        wpHitFlags_ = flags;
+        wpHitAddr_ = tr->addr > p->addr ? tr->addr : p->addr;
+        RISCV_sprintf(wpDescr_, sizeof(wpDescr_),
+                      "Watchpoint %s [%08" RV_PRI64 "x]",
+                      acc == WatchFlag_Write ? "write" : "read",
+                      tr->addr);
+        return;
+    }
+}
+
+void CpuGeneric::compileTriggers() {
+    TriggerData1Type::bits_type2 *pt;
+    uint64_t data2, mask;
+    int tcnt;
+
+    trigDirty_ = false;
+    trigExecTotal_ = 0;
+    trigRangeTotal_ = 0;
+    trigICountTotal_ = 0;
+    trigAlways_ = false;
+    memset(trigExecMap_, 0, sizeof(trigExecMap_));
+    for (int i = 0; i < triggersTotal_.to_int(); i++) {
+        pt = &ptriggers_[i].data1.mcontrol_bits;
+        data2 = ptriggers_[i].data2;
+        if (pt->type == TriggerType_InstrCountMatch) {
+            trigICountTotal_++;
+            continue;
+        }
+        if (pt->type != TriggerType_AddrDataMatch
+            || !(pt->m | pt->s | pt->u) || !pt->execute) {
+            continue;
+        }
+        trigExecTotal_++;
+        if (pt->hit) {
+            trigAlways_ = true;
+            continue;
+        }
+        TriggerRangeType &r = trigRange_[trigRangeTotal_];
+        switch (pt->match) {
+        case 0:
+            trigExecMap_[(data2 >> 7) & (TRIGGER_MAP_SZ - 1)]
+                |= 1ull << ((data2 >> 1) & 0x3F);
+            break;
+        case 1:
+            mask = 1;
+            tcnt = 0;
+            while ((tcnt < mcontrolMaskmax_.to_int()) && !(data2 & mask)) {
+                mask <<= 1;
+                tcnt++;
+            }
+            r.lo = data2 & ~(mask - 1);
+            r.hi = data2 | (mask - 1);
+            trigRangeTotal_++;
+            break;
+        case 2:
+            r.lo = data2;
+            r.hi = ~0ull;
+            trigRangeTotal_++;
+            break;
+        case 3:
+            if (data2) {
+                r.lo = 0;
+                r.hi = data2 - 1;
+                trigRangeTotal_++;
+            }
+            break;
+        default:
+            // Masked compare of the PC halves
+            trigAlways_ = true;
+        }
+    }
 }
 
 bool CpuGeneric::isTriggerInstruction() {
     uint64_t pc = getPC();
+    bool check;
+    if (trigDirty_) {
+        compileTriggers();
+    }
+    if (trigExecTotal_ == 0) {
+        return false;
+    }
+    check = trigAlways_ || ((trigExecMap_[(pc >> 7) & (TRIGGER_MAP_SZ - 1)]
+                            >> ((pc >> 1) & 0x3F)) & 0x1);
+    for (int i = 0; i < trigRangeTotal_ && !check; i++) {
+        check = pc >= trigRange_[i].lo && pc <= trigRange_[i].hi;
+    }
+    if (!check) {
+        return false;
+    }
+    if (isTriggerInstructionAll()) {
+        // hit bit remains set until tdata1 is written
+        trigAlways_ = true;
+        return true;
+    }
+    return false;
+}
+
+bool CpuGeneric::isTriggerInstructionAll() {
+    uint64_t pc = getPC();
 
     TriggerData1Type::bits_type2 *pt;
     bool fire = false;
@@ -684,5 +1036,202 @@ void CpuGeneric::exitProgbufExec() {
 }
 
 
+void CpuGeneric::enableCallGraph(bool en) {
+    if (en && !cgEnabled_) {
+        clearCallGraph();
+    }
+    cgEnabled_ = en;
+}
+
+void CpuGeneric::clearCallGraph() {
+    RISCV_mutex_lock(&mutexCallGraph_);
+    memset(cgFunc_, 0, cgFuncSz_ * sizeof(CallGraphFuncType));
+    memset(cgEdge_, 0, cgEdgeSz_ * sizeof(CallGraphEdgeType));
+    cgFuncUsed_ = 0;
+    cgEdgeUsed_ = 0;
+    cgResetStack(getPC());
+    RISCV_mutex_unlock(&mutexCallGraph_);
+}
+
+void CpuGeneric::getCallGraph(AttributeType *funcs, AttributeType *edges) {
+    AttributeType item;
+    uint64_t incl, child_incl = 0;
+    CallGraphFuncType *pf;
+    CallGraphEdgeType *pe;
+
+    RISCV_mutex_lock(&mutexCallGraph_);
+    // Open frames, starting from the deepest one, as if they return now
+    uint64_t *open_incl = new uint64_t[cgDepth_ + 1];
+    for (int i = cgDepth_ - 1; i >= 0; i--) {
+        incl = step_cnt_ - cgStack_[i].t_entry;
+        open_incl[i] = incl;
+        pf = cgFunc(cgStack_[i].addr);
+        pf->incl += incl;
+        pf->excl += incl - cgStack_[i].t_child - child_incl;
+        if (i > 0) {
+            cgEdge(cgStack_[i - 1].addr, cgStack_[i].addr)->incl += incl;
+        }
+        child_incl = incl;
+    }
+
+    funcs->make_list(0);
+    item.make_list(CallGraphFunc_Total);
+    for (unsigned i = 0; i < cgFuncSz_; i++) {
+        pf = &cgFunc_[i];
+        if (!pf->used) {
+            continue;
+        }
+        item[CallGraphFunc_address].make_uint64(pf->addr);
+        item[CallGraphFunc_calls].make_uint64(pf->calls);
+        item[CallGraphFunc_inclusive].make_uint64(pf->incl);
+        item[CallGraphFunc_exclusive].make_uint64(pf->excl);
+        funcs->add_to_list(&item);
+    }
+    edges->make_list(0);
+    item.make_list(CallGraphEdge_Total);
+    for (unsigned i = 0; i < cgEdgeSz_; i++) {
+        pe = &cgEdge_[i];
+        if (!pe->used) {
+            continue;
+        }
+        item[CallGraphEdge_caller].make_uint64(pe->caller);
+        item[CallGraphEdge_callee].make_uint64(pe->callee);
+        item[CallGraphEdge_calls].make_uint64(pe->calls);
+        item[CallGraphEdge_inclusive].make_uint64(pe->incl);
+        edges->add_to_list(&item);
+    }
+
+    // Restore accumulated counters
+    child_incl = 0;
+    for (int i = cgDepth_ - 1; i >= 0; i--) {
+        incl = open_incl[i];
+        pf = cgFunc(cgStack_[i].addr);
+        pf->incl -= incl;
+        pf->excl -= incl - cgStack_[i].t_child - child_incl;
+        if (i > 0) {
+            cgEdge(cgStack_[i - 1].addr, cgStack_[i].addr)->incl -= incl;
+        }
+        child_incl = incl;
+    }
+    delete [] open_incl;
+    RISCV_mutex_unlock(&mutexCallGraph_);
+}
+
+CpuGeneric::CallGraphFuncType *CpuGeneric::cgFunc(uint64_t addr) {
+    uint64_t h = (addr >> 1) * 0x9E3779B97F4A7C15ull;
+    unsigned idx = static_cast<unsigned>(h >> 32) & (cgFuncSz_ - 1);
+    while (cgFunc_[idx].used && cgFunc_[idx].addr != addr) {
+        idx = (idx + 1) & (cgFuncSz_ - 1);
+    }
+    CallGraphFuncType *p = &cgFunc_[idx];
+    if (!p->used) {
+        p->used = true;
+        p->addr = addr;
+        if (2 * (++cgFuncUsed_) > cgFuncSz_) {
+            cgResize(2 * cgFuncSz_, cgEdgeSz_);
+            p = cgFunc(addr);
+        }
+    }
+    return p;
+}
+
+CpuGeneric::CallGraphEdgeType *CpuGeneric::cgEdge(uint64_t caller,
+                                                  uint64_t callee) {
+    uint64_t h = ((caller >> 1) ^ (callee << 15)) * 0x9E3779B97F4A7C15ull;
+    unsigned idx = static_cast<unsigned>(h >> 32) & (cgEdgeSz_ - 1);
+    while (cgEdge_[idx].used && (cgEdge_[idx].caller != caller
+                              || cgEdge_[idx].callee != callee)) {
+        idx = (idx + 1) & (cgEdgeSz_ - 1);
+    }
+    CallGraphEdgeType *p = &cgEdge_[idx];
+    if (!p->used) {
+        p->used = true;
+        p->caller = caller;
+        p->callee = callee;
+        if (2 * (++cgEdgeUsed_) > cgEdgeSz_) {
+            cgResize(cgFuncSz_, 2 * cgEdgeSz_);
+            p = cgEdge(caller, callee);
+        }
+    }
+    return p;
+}
+
+void CpuGeneric::cgResize(unsigned funcsz, unsigned edgesz) {
+    CallGraphFuncType *pf = cgFunc_;
+    CallGraphEdgeType *pe = cgEdge_;
+    unsigned fsz = cgFuncSz_;
+    unsigned esz = cgEdgeSz_;
+
+    cgFunc_ = new CallGraphFuncType[funcsz];
+    memset(cgFunc_, 0, funcsz * sizeof(CallGraphFuncType));
+    cgEdge_ = new CallGraphEdgeType[edgesz];
+    memset(cgEdge_, 0, edgesz * sizeof(CallGraphEdgeType));
+    cgFuncSz_ = funcsz;
+    cgEdgeSz_ = edgesz;
+    cgFuncUsed_ = 0;
+    cgEdgeUsed_ = 0;
+    for (unsigned i = 0; i < fsz; i++) {
+        if (pf[i].used) {
+            *cgFunc(pf[i].addr) = pf[i];
+        }
+    }
+    for (unsigned i = 0; i < esz; i++) {
+        if (pe[i].used) {
+            *cgEdge(pe[i].caller, pe[i].callee) = pe[i];
+        }
+    }
+    delete [] pf;
+    delete [] pe;
+}
+
+void CpuGeneric::cgResetStack(uint64_t pc) {
+    // Function that was executing when profiling started isn't known
+    // until it returns, so its frame is identified by the current PC.
+    cgStack_[0].addr = pc;
+    cgStack_[0].t_entry = step_cnt_;
+    cgStack_[0].t_child = 0;
+    cgFunc(pc);
+    cgDepth_ = 1;
+    cgOverflow_ = 0;
+}
+
+void CpuGeneric::cgPush(uint64_t addr) {
+    RISCV_mutex_lock(&mutexCallGraph_);
+    if (cgDepth_ >= CALL_GRAPH_DEPTH) {
+        cgOverflow_++;
+        RISCV_mutex_unlock(&mutexCallGraph_);
+        return;
+    }
+    cgFunc(addr)->calls++;
+    cgEdge(cgStack_[cgDepth_ - 1].addr, addr)->calls++;
+    cgStack_[cgDepth_].addr = addr;
+    cgStack_[cgDepth_].t_entry = step_cnt_;
+    cgStack_[cgDepth_].t_child = 0;
+    cgDepth_++;
+    RISCV_mutex_unlock(&mutexCallGraph_);
+}
+
+void CpuGeneric::cgPop() {
+    RISCV_mutex_lock(&mutexCallGraph_);
+    if (cgOverflow_) {
+        cgOverflow_--;
+        RISCV_mutex_unlock(&mutexCallGraph_);
+        return;
+    }
+    CallGraphFrameType &f = cgStack_[--cgDepth_];
+    uint64_t incl = step_cnt_ - f.t_entry;
+    CallGraphFuncType *pf = cgFunc(f.addr);
+    pf->incl += incl;
+    pf->excl += incl - f.t_child;
+    if (cgDepth_ > 0) {
+        cgEdge(cgStack_[cgDepth_ - 1].addr, f.addr)->incl += incl;
+        cgStack_[cgDepth_ - 1].t_child += incl;
+    } else {
+        // Return from the first function, caller becomes the new root
+        cgResetStack(getNPC());
+    }
+    RISCV_mutex_unlock(&mutexCallGraph_);
+}
+
 }  // namespace debugger
 
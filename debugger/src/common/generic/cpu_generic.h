@@ -24,12 +24,15 @@
 #include "coreservices/ithread.h"
 #include "coreservices/icpufunctional.h"
 #include "coreservices/idport.h"
+#include "coreservices/iwatchpoint.h"
+#include "coreservices/icallgraph.h"
 #include "coreservices/imemop.h"
 #include "coreservices/iclock.h"
 #include "coreservices/ireset.h"
 #include "coreservices/isrccode.h"
 #include "coreservices/icmdexec.h"
 #include "coreservices/icoveragetracker.h"
+#include "coreservices/iinputrec.h"
 #include "generic/mapreg.h"
 #include <riscv-isa.h>
 #include <fstream>
@@ -40,9 +43,12 @@ class CpuGeneric : public IService,
                    public IThread,
                    public ICpuFunctional,
                    public IDPort,
+                   public IWatchpoint,
+                   public ICallGraph,
                    public IClock,
                    public IPower,
                    public IResetListener,
+                   public IInputSource,
                    public IHap {
  public:
     explicit CpuGeneric(const char *name);
@@ -75,7 +81,7 @@ class CpuGeneric : public IService,
 
     /** IDPort interface */
     virtual void resumereq() {resumereq_ = true; }
-    virtual void haltreq() { haltreq_ = true; }
+    virtual void haltreq();
     virtual bool isHalted() { return estate_ == CORE_Halted; }
     virtual uint64_t readRegDbg(uint32_t regno) { return 0; }
     virtual void writeRegDbg(uint32_t regno, uint64_t val) {}
@@ -83,9 +89,23 @@ class CpuGeneric : public IService,
     virtual bool isExecutingProgbuf() { return estate_ == CORE_ProgbufExec; }
     virtual void setResetPin(bool val) {}
 
+    /** IWatchpoint interface */
+    virtual int addWatchpoint(uint64_t addr, uint64_t len,
+                              uint32_t flags, uint64_t value);
+    virtual int removeWatchpoint(uint64_t addr, uint64_t len,
+                                 uint32_t flags);
+    virtual void getWatchpointList(AttributeType *list);
+    virtual uint32_t getWatchpointHit(uint64_t *addr);
+
+    /** ICallGraph interface */
+    virtual void enableCallGraph(bool en);
+    virtual bool isCallGraphEnabled() { return cgEnabled_; }
+    virtual void clearCallGraph();
+    virtual void getCallGraph(AttributeType *funcs, AttributeType *edges);
 
  protected:
     virtual uint64_t getResetAddress() { return resetVector_.to_uint64(); }
+    virtual uint64_t getHartId() { return 0; }
     virtual EEndianessType endianess() = 0;
     virtual GenericInstruction *decodeInstruction(Reg64Type *cache) = 0;
     virtual void generateIllegalOpcode() = 0;
@@ -101,6 +121,10 @@ class CpuGeneric : public IService,
     virtual bool isStepEnabled() { return false; }
     virtual bool isTriggerICount();
     virtual bool isTriggerInstruction();
+    bool isTriggerInstructionAll();
+    /** Must be called when tdata registers were modified */
+    void invalidateTriggers() { trigDirty_ = true; }
+    void compileTriggers();
 
  public:
     /** IClock */
@@ -121,6 +145,9 @@ class CpuGeneric : public IService,
     /** IResetListener interface */
     virtual void reset(IFace *isource);
 
+    /** IInputSource interface */
+    virtual void applyInput(AttributeType *event);
+
     /** IHap */
     virtual void hapTriggered(EHapType type, uint64_t param,
                               const char *descr);
@@ -137,6 +164,20 @@ class CpuGeneric : public IService,
     virtual void enterProgbufExec();
     virtual void exitProgbufExec();
 
+    /** System bus access without data watchpoints, used by fetch */
+    ETransStatus memop(Axi4TransactionType *tr);
+    void checkWatchpoint(Axi4TransactionType *tr);
+    void updateWatchPages(int total);
+
+    struct CallGraphFuncType;
+    struct CallGraphEdgeType;
+    CallGraphFuncType *cgFunc(uint64_t addr);
+    CallGraphEdgeType *cgEdge(uint64_t caller, uint64_t callee);
+    void cgResize(unsigned funcsz, unsigned edgesz);
+    void cgResetStack(uint64_t pc);
+    void cgPush(uint64_t addr);
+    void cgPop();
+
  protected:
     AttributeType isEnable_;
     AttributeType freqHz_;
@@ -155,10 +196,12 @@ class CpuGeneric : public IService,
     AttributeType resetState_;
     AttributeType triggersTotal_;
     AttributeType mcontrolMaskmax_;
+    AttributeType callGraph_;
 
     ISourceCode *isrc_;
     ICoverageTracker *icovtracker_;
     ICmdExecutor *icmdexec_;
+    IInputRecorder *irec_;
     IMemoryOperation *isysbus_;
     GenericInstruction *instr_;
 
@@ -196,6 +239,21 @@ class CpuGeneric : public IService,
         uint64_t extra;
     } *ptriggers_;
 
+    // Compiled triggers. Step filter checks the PC against bitmap of exact
+    // addresses and the list of ranges and runs the full triggers loop
+    // only if one of them may fire.
+    static const int TRIGGER_MAP_SZ = 64;       // 4096 bits
+    struct TriggerRangeType {
+        uint64_t lo;
+        uint64_t hi;
+    } *trigRange_;
+    volatile bool trigDirty_;
+    int trigExecTotal_;
+    int trigRangeTotal_;
+    int trigICountTotal_;
+    bool trigAlways_;       // hit is sticky or unsupported match type
+    uint64_t trigExecMap_[TRIGGER_MAP_SZ];
+
     uint64_t step_cnt_;
     volatile bool resumereq_;
     volatile bool haltreq_;
@@ -217,7 +275,6 @@ class CpuGeneric : public IService,
     uint64_t interrupt_pending_[2];
     bool do_not_cache_;         // Do not put instruction into ICache
 
-    mutex_def mutex_csr_;
     event_def eventConfigDone_;
     ClockAsyncTQueueType queue_;
 
@@ -245,6 +302,57 @@ class CpuGeneric : public IService,
 
     uint64_t cur_prv_level;
 
+    // Data watchpoints. Hashed map of 4 KB pages with watched bytes filters
+    // out the accesses before the list is checked.
+    static const int WATCHPOINTS_MAX = 16;
+    static const int WATCH_PAGE_SHIFT = 12;
+    static const int WATCH_PAGE_MAP_SZ = 64;    // 4096 bits
+    struct WatchpointType {
+        uint64_t addr;
+        volatile uint64_t len;
+        volatile uint32_t flags;    // 0 = dead slot, skipped by the check
+        uint64_t value;
+    } wp_[WATCHPOINTS_MAX];
+    volatile int wpTotal_;
+    uint64_t wpPageMap_[WATCH_PAGE_MAP_SZ];
+    bool wpPending_;            // halt before the next instruction
+    uint32_t wpHitFlags_;
+    uint64_t wpHitAddr_;
+    char wpDescr_[64];
+
+    // Call graph. Shadow call stack is updated on call/return instructions
+    // and the counters are accumulated into hashed function and caller-
+    // callee tables when frame is removed.
+    static const int CALL_GRAPH_DEPTH = 1024;
+    static const unsigned CALL_GRAPH_TABLE_MIN = 1024;     // power of 2
+    struct CallGraphFuncType {
+        uint64_t addr;
+        uint64_t calls;
+        uint64_t incl;
+        uint64_t excl;
+        bool used;
+    } *cgFunc_;
+    struct CallGraphEdgeType {
+        uint64_t caller;
+        uint64_t callee;
+        uint64_t calls;
+        uint64_t incl;
+        bool used;
+    } *cgEdge_;
+    struct CallGraphFrameType {
+        uint64_t addr;
+        uint64_t t_entry;       // step counter on call
+        uint64_t t_child;       // steps of the returned callees
+    } cgStack_[CALL_GRAPH_DEPTH];
+    bool cgEnabled_;
+    unsigned cgFuncSz_;
+    unsigned cgFuncUsed_;
+    unsigned cgEdgeSz_;
+    unsigned cgEdgeUsed_;
+    int cgDepth_;
+    int cgOverflow_;            // calls deeper than CALL_GRAPH_DEPTH
+    mutex_def mutexCallGraph_;
+
     struct trace_action_type {
         bool memop;             // 0=register; 1=memop
         int waddr;              // register addr
@@ -26,6 +26,7 @@ KeyGeneric::KeyGeneric(IService *parent, const char *name)
     keyName_.make_string(name);
     pressed_ = false;
     power_on_ = false;
+    irec_ = 0;
 
     briefDescr_.make_string("Press or release button.");
     detailedDescr_.make_string(
@@ -56,16 +57,44 @@ void KeyGeneric::exec(AttributeType *args, AttributeType *res) {
         return;
     }
     AttributeType &type = (*args)[1];
+    if (!type.is_equal("press") && !type.is_equal("release")) {
+        return;
+    }
+    AttributeType ev;
+    ev.make_list(1);
+    ev[0u] = type;
+    if (irec_ && irec_->putInput(static_cast<IInputSource *>(this), &ev)) {
+        // Applied at the simulation step
+        return;
+    }
+    applyInput(&ev);
+    res->make_boolean(pressed_);
+}
+
+void KeyGeneric::reset(IFace *isource) {
+    release();
+}
+
+void KeyGeneric::applyInput(AttributeType *event) {
+    AttributeType &type = (*event)[0u];
     if (type.is_equal("press") && !pressed_) {
         press();
     } else if (type.is_equal("release") && pressed_) {
         release();
     }
-    res->make_boolean(pressed_);
 }
 
-void KeyGeneric::reset(IFace *isource) {
-    release();
+void KeyGeneric::attachInputRecorder() {
+    AttributeType lstServ;
+    RISCV_get_services_with_iface(IFACE_INPUT_RECORDER, &lstServ);
+    if (lstServ.size() == 0) {
+        return;
+    }
+    IService *iserv = static_cast<IService *>(lstServ[0u].to_iface());
+    irec_ = static_cast<IInputRecorder *>(
+                        iserv->getInterface(IFACE_INPUT_RECORDER));
+    irec_->registerInputSource(keyName_.to_string(),
+                               static_cast<IInputSource *>(this));
 }
 
 void KeyGeneric::press() {
@@ -104,6 +133,7 @@ void KeyGeneric8::postinit() {
     }
     iport_->registerPortListener(static_cast<IIOPortListener8 *>(this));
     ikb_ = static_cast<IKeyboard *>(cmdParent_->getInterface(IFACE_KEYBOARD));
+    attachInputRecorder();
 }
 
 void KeyGeneric8::readData(uint8_t *val, uint8_t mask) {
@@ -147,6 +177,7 @@ void KeyGeneric32::postinit() {
     }
     iport_->registerPortListener(static_cast<IIOPortListener32 *>(this));
     ikb_ = static_cast<IKeyboard *>(cmdParent_->getInterface(IFACE_KEYBOARD));
+    attachInputRecorder();
 }
 
 void KeyGeneric32::readData(uint32_t *val, uint32_t mask) {
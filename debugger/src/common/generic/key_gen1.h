@@ -21,12 +21,14 @@
 #include "coreservices/icmdexec.h"
 #include "coreservices/ikeyboard.h"
 #include "coreservices/ireset.h"
+#include "coreservices/iinputrec.h"
 #include "generic/iotypes.h"
 
 namespace debugger {
 
 class KeyGeneric : public ICommand,
-                   public IResetListener {
+                   public IResetListener,
+                   public IInputSource {
  public:
     KeyGeneric(IService *parent, const char *keyname);
 
@@ -38,6 +40,9 @@ class KeyGeneric : public ICommand,
     /** IResetListener */
     virtual void reset(IFace *isource);
 
+    /** IInputSource */
+    virtual void applyInput(AttributeType *event);
+
  protected:
     IFace *getInterface(const char *name) {
         return cmdParent_->getInterface(name);
@@ -46,12 +51,14 @@ class KeyGeneric : public ICommand,
     // Common
     virtual void press();
     virtual void release();
+    void attachInputRecorder();
 
  protected:
     bool pressed_;
     bool power_on_;
     AttributeType keyName_;
     IKeyboard *ikb_;
+    IInputRecorder *irec_;
 };
 
 class KeyGeneric8 : public KeyGeneric,
@@ -32,12 +32,15 @@ MemoryGeneric::MemoryGeneric(const char *name)  : IService(name) {
 
 MemoryGeneric::~MemoryGeneric() {
     if (mem_) {
-        delete mem_;
+        delete [] mem_;
     }
 }
 
 void MemoryGeneric::postinitService() {
-    mem_ = new uint8_t[static_cast<unsigned>(length_.to_uint64())];
+    if (!mem_) {
+        // Child class may provide its own backing memory
+        mem_ = new uint8_t[static_cast<unsigned>(length_.to_uint64())];
+    }
 
     if (dpiClient_.is_string() && dpiClient_.size()) {
         idpi_ = static_cast<IDpi *>(
@@ -99,4 +102,19 @@ ETransStatus MemoryGeneric::b_transport(Axi4TransactionType *trans) {
     return TRANS_OK;
 }
 
+uint8_t *MemoryGeneric::getHostPointer(uint64_t addr, EAxi4Action action,
+                                       uint64_t *avail) {
+    if (!mem_ || idpi_) {
+        // DPI transactions and comparision require b_transport()
+        return 0;
+    }
+    if (action == MemAction_Write && readOnly_.to_bool()) {
+        // ROM is writable only through MemAction_Backdoor
+        return 0;
+    }
+    uint64_t off = (addr - getBaseAddress()) % length_.to_int();
+    *avail = length_.to_uint64() - off;
+    return &mem_[off];
+}
+
 }  // namespace debugger
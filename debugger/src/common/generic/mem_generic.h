@@ -35,6 +35,8 @@ class MemoryGeneric : public IService,
 
     /** IMemoryOperation */
     virtual ETransStatus b_transport(Axi4TransactionType *trans);
+    virtual uint8_t *getHostPointer(uint64_t addr, EAxi4Action action,
+                                    uint64_t *avail);
 
  protected:
     AttributeType readOnly_;
@@ -33,7 +33,8 @@ enum EHapType {
     HAP_Halt,               // CPU halted
     HAP_BreakSimulation,    // close and exit simulation
     HAP_CpuTurnON,
-    HAP_CpuTurnOFF
+    HAP_CpuTurnOFF,
+    HAP_CpuHalted           // CPU model halted, breakpoints aren't removed yet
 };
 
 class IHap : public IFace {
@@ -28,9 +28,31 @@ CpuCortex_Functional::CpuCortex_Functional(const char *name) :
     p_psr_ = reinterpret_cast<ProgramStatusRegsiterType *>(
             &R[Reg_cpsr]);
     PC_ = &R[Reg_pc];   // redefine location of PC register in bank
+
+    thumb16_ = new uint16_t[THUMB_TABLE_SIZE];
+    decodeCache_ = new DecodeCacheType[DECODE_CACHE_SIZE];
+    // Invalid mode value marks empty entries
+    memset(decodeCache_, 0xFF, DECODE_CACHE_SIZE * sizeof(DecodeCacheType));
+    initThumbTable();
 }
 
 CpuCortex_Functional::~CpuCortex_Functional() {
+    delete [] thumb16_;
+    delete [] decodeCache_;
+}
+
+void CpuCortex_Functional::initThumbTable() {
+    uint32_t tio;
+    for (int i = 0; i < THUMB_TABLE_SIZE; i++) {
+        // First halfword 0b11101, 0b11110, 0b11111 starts 32-bit opcode
+        if ((i & 0xF800) >= 0xE800) {
+            thumb16_[i] = THUMB_32BIT;
+        } else {
+            thumb16_[i] = static_cast<uint16_t>(
+                decoder_thumb(static_cast<uint32_t>(i), &tio,
+                              errmsg_, sizeof(errmsg_)));
+        }
+    }
 }
 
 void CpuCortex_Functional::postinitService() {
@@ -318,14 +340,14 @@ void CpuCortex_Functional::trackContextEnd() {
 GenericInstruction *CpuCortex_Functional::decodeInstruction(Reg64Type *cache) {
     GenericInstruction *instr = NULL;
     uint32_t ti = cacheline_[0].buf32[0];
+    EInstructionModes mode = getInstrMode();
 
-    EIsaArmV7 etype;
-    if (getInstrMode() == THUMB_mode) {
-        uint32_t tio;
-        etype = decoder_thumb(ti, &tio, errmsg_, sizeof(errmsg_));
-        //cacheline_[0].buf32[0] = tio;
-    } else {
-        etype = decoder_arm(ti, errmsg_, sizeof(errmsg_));
+    EIsaArmV7 etype = ARMV7_Total;
+    if (mode == THUMB_mode) {
+        etype = static_cast<EIsaArmV7>(thumb16_[ti & 0xFFFF]);
+    }
+    if (mode != THUMB_mode || etype == THUMB_32BIT) {
+        etype = decodeCached(ti, mode);
     }
 
     if (etype < ARMV7_Total) {
@@ -338,6 +360,29 @@ GenericInstruction *CpuCortex_Functional::decodeInstruction(Reg64Type *cache) {
     return instr;
 }
 
+EIsaArmV7 CpuCortex_Functional::decodeCached(uint32_t ti,
+                                             EInstructionModes mode) {
+    uint32_t idx = ((ti ^ (ti >> 16)) * 0x9E3779B1u) >> 20;
+    DecodeCacheType *p = &decodeCache_[idx & (DECODE_CACHE_SIZE - 1)];
+    if (p->opcode == ti && p->mode == static_cast<uint32_t>(mode)) {
+        return p->etype;
+    }
+
+    EIsaArmV7 etype;
+    if (mode == THUMB_mode) {
+        uint32_t tio;
+        etype = decoder_thumb(ti, &tio, errmsg_, sizeof(errmsg_));
+    } else {
+        etype = decoder_arm(ti, errmsg_, sizeof(errmsg_));
+    }
+    if (etype < ARMV7_Total) {
+        p->opcode = ti;
+        p->mode = static_cast<uint32_t>(mode);
+        p->etype = etype;
+    }
+    return etype;
+}
+
 void CpuCortex_Functional::generateIllegalOpcode() {
     //raiseSignal(EXCEPTION_InstrIllegal);
     RISCV_error("Illegal instruction at 0x%08" RV_PRI64 "x", getPC());
@@ -100,6 +100,8 @@ class CpuCortex_Functional : public CpuGeneric,
     void addThumb2Isa();
     unsigned addSupportedInstruction(ArmInstruction *instr);
     uint32_t hash32(uint32_t val) { return (val >> 24) & 0xf; }
+    void initThumbTable();
+    EIsaArmV7 decodeCached(uint32_t ti, EInstructionModes mode);
 
  private:
     AttributeType defaultMode_;
@@ -114,6 +116,19 @@ class CpuCortex_Functional : public CpuGeneric,
 
     char errmsg_[256];
 
+    // Decoder acceleration. 16-bit Thumb opcodes don't depend on the next
+    // halfword and are looked up in the table indexed by the first
+    // halfword, other opcodes are cached after the decoder cascade.
+    static const uint16_t THUMB_32BIT = 0xFFFF;
+    static const int THUMB_TABLE_SIZE = 1 << 16;
+    static const int DECODE_CACHE_SIZE = 1 << 12;
+    uint16_t *thumb16_;
+    struct DecodeCacheType {
+        uint32_t opcode;
+        uint32_t mode;
+        EIsaArmV7 etype;
+    } *decodeCache_;
+
     //CmdBrArm *pcmd_br_;
     //CmdRegArm *pcmd_reg_;
     //CmdRegsArm *pcmd_regs_;
@@ -44,9 +44,9 @@ class ArmSourceService : public IService,
 
     virtual void clearSymbols();
 
-    virtual void getSymbols(AttributeType *list) {
-        *list = symbolListSortByName_;
-    }
+    virtual void setSymbolTable(ISymbolTable *tbl) { isymtbl_ = tbl; }
+
+    virtual void getSymbols(AttributeType *list);
 
     virtual void addressToSymbol(uint64_t addr, AttributeType *info);
 
@@ -112,6 +112,7 @@ class ArmSourceService : public IService,
     AttributeType brList_;
     AttributeType symbolListSortByName_;
     AttributeType symbolListSortByAddr_;
+    ISymbolTable *isymtbl_;
 
     ICpuArm *iarm_;
 };
@@ -22,19 +22,78 @@
 
 namespace debugger {
 
-void ST7789VCmdType::getFrame(AttributeType *res, bool diff) {
+/**
+ * Frame buffer is stored by columns: pixel (x,y) has index x*HEIGHT + y.
+ * Without 'diff' the whole frame is returned as a data attribute.
+ * With 'diff' the response is a dictionary:
+ *     {Seq:n,Rects:[[x,y,w,h,data],...]}
+ * where rectangles cover all pixels modified after the frame 'seq' the
+ * client already has and 'data' uses the same column order as the full
+ * frame. No state is kept per request, so any number of clients may poll.
+ */
+void ST7789VCmdType::getFrame(AttributeType *res, bool diff, uint64_t seq) {
     ST7789V *p = static_cast<ST7789V *>(cmdParent_);
-    int t1 = p->last_modified_pixel_;
-    //if (diff && t1 == last_pixel_) {
-    //    res->make_nil();
-    //    return;
-    //}
-    last_pixel_ = t1;
+    if (!diff) {
+        if (!res->is_data() || res->size() != sizeof(p->frame_)) {
+            res->make_data(sizeof(p->frame_));
+        }
+        memcpy(res->data(), p->frame_, sizeof(p->frame_));
+        return;
+    }
+
+    uint64_t modcnt = p->modcnt_;
     RISCV_memory_barrier();
-    if (!res->is_data() || res->size() != sizeof(p->frame_)) {
-        res->make_data(sizeof(p->frame_));
+
+    res->make_dict();
+    AttributeType &rects = (*res)["Rects"];
+    rects.make_list(0);
+    if (seq == 0 || seq > modcnt) {
+        rects.make_list(1);
+        getRect(&rects[0u], 0, 0, ST7789V_WIDTH, ST7789V_HEIGHT);
+    } else if (modcnt != seq) {
+        // Rows bounding box is common for all columns' runs.
+        int y0 = ST7789V_HEIGHT;
+        int y1 = -1;
+        for (int y = 0; y < ST7789V_HEIGHT; y++) {
+            if (p->rowModified_[y] > seq) {
+                if (y0 > y) {
+                    y0 = y;
+                }
+                y1 = y;
+            }
+        }
+        int x = 0;
+        while (y1 >= 0 && x < ST7789V_WIDTH) {
+            if (p->colModified_[x] <= seq) {
+                x++;
+                continue;
+            }
+            int x0 = x;
+            while (x < ST7789V_WIDTH && p->colModified_[x] > seq) {
+                x++;
+            }
+            AttributeType rect;
+            getRect(&rect, x0, y0, x - x0, y1 - y0 + 1);
+            rects.add_to_list(&rect);
+        }
+    }
+    (*res)["Seq"].make_uint64(modcnt);
+}
+
+void ST7789VCmdType::getRect(AttributeType *res, int x, int y, int w, int h) {
+    ST7789V *p = static_cast<ST7789V *>(cmdParent_);
+    res->make_list(5);
+    (*res)[0u].make_int64(x);
+    (*res)[1].make_int64(y);
+    (*res)[2].make_int64(w);
+    (*res)[3].make_int64(h);
+    AttributeType &data = (*res)[4];
+    data.make_data(w * h * sizeof(uint32_t));
+    uint32_t *dst = reinterpret_cast<uint32_t *>(data.data());
+    for (int i = 0; i < w; i++) {
+        memcpy(&dst[i * h], &p->frame_[(x + i) * ST7789V_HEIGHT + y],
+               h * sizeof(uint32_t));
     }
-    memcpy(res->data(), p->frame_, sizeof(p->frame_));
 }
 
 ST7789V::ST7789V(const char *name) :
@@ -58,7 +117,9 @@ ST7789V::ST7789V(const char *name) :
     memset(frame_, 0, sizeof(frame_));
     m_x = 0;
     m_y = 0;
-    last_modified_pixel_ = 0;
+    modcnt_ = 1;
+    memset(colModified_, 0, sizeof(colModified_));
+    memset(rowModified_, 0, sizeof(rowModified_));
 }
 
 void ST7789V::postinitService() {
@@ -198,11 +259,22 @@ void ST7789V::madctl() {
 }
 
 void ST7789V::iled_setpixel(uint32_t rgb) {
-    int pix_idx = m_y*ST7789V_HEIGHT + ST7789V_HEIGHT-m_x-1;
-    if (frame_[pix_idx] != rgb) {
-        last_modified_pixel_ = pix_idx;
+    if (m_x >= ST7789V_HEIGHT || m_y >= ST7789V_WIDTH) {
+        return;
+    }
+    int row = ST7789V_HEIGHT - m_x - 1;
+    int pix_idx = m_y*ST7789V_HEIGHT + row;
+    if (frame_[pix_idx] == rgb) {
+        return;
     }
+    // Counter is published last so that getFrame() could not skip
+    // a pixel which modification is seen partially.
+    uint64_t cnt = modcnt_ + 1;
     frame_[pix_idx] = rgb;
+    colModified_[m_y] = cnt;
+    rowModified_[row] = cnt;
+    RISCV_memory_barrier();
+    modcnt_ = cnt;
 }
 
 
@@ -36,16 +36,16 @@ static const int ST7789V_HEIGHT = 240;
 class ST7789VCmdType : public GenericDisplayCmdType {
  public:
     ST7789VCmdType(IService *parent, const char *name)
-        : GenericDisplayCmdType(parent, name), last_pixel_(-1) {}
+        : GenericDisplayCmdType(parent, name) {}
 
  protected:
     virtual int getWidth() { return ST7789V_WIDTH; }
     virtual int getHeight() { return ST7789V_HEIGHT; }
     virtual uint32_t getBkgColor() { return 0; }
-    virtual void getFrame(AttributeType *res, bool diff);
+    virtual void getFrame(AttributeType *res, bool diff, uint64_t seq);
 
- protected:
-    int last_pixel_;
+ private:
+    void getRect(AttributeType *res, int x, int y, int w, int h);
 };
 
 class RD_PinType : public IOPinType32 {
@@ -179,7 +179,14 @@ class ST7789V : public IService,
     uint16_t cmdBuf_[8];
     uint8_t cmdBufPos_;
     uint32_t frame_[ST7789V_HEIGHT * ST7789V_WIDTH];
-    int last_modified_pixel_;
+    // Value of modcnt_ when the column or row of the frame was modified.
+    // Written only by the CPU thread, so the command reads them without
+    // lock: modcnt_ is updated after the pixel and its column/row marks.
+    // modcnt_ is reported as the frame 'Seq' and starts from 1, so that
+    // sequence 0 always means 'client has no frame'.
+    uint64_t modcnt_;
+    uint64_t colModified_[ST7789V_WIDTH];
+    uint64_t rowModified_[ST7789V_HEIGHT];
 };
 /*----------------------------------------------------------------------------*/
 
@@ -33,6 +33,8 @@ CpuRiver_Functional::CpuRiver_Functional(const char *name) :
 
     mmuReservatedAddr_ = 0;
     mmuReservedAddrWatchdog_ = 0;
+    csr_ = portCSR_.getpR64();
+    dbgCsrWr_.valid = false;
 }
 
 CpuRiver_Functional::~CpuRiver_Functional() {
@@ -92,15 +94,15 @@ unsigned CpuRiver_Functional::addSupportedInstruction(
 
 /** Check stack protection exceptions: */
 void CpuRiver_Functional::checkStackProtection() {
-    uint64_t mstackovr = readCSR(CSR_mstackovr);
-    uint64_t mstackund = readCSR(CSR_mstackund);
-    uint64_t sp = portRegs_.read(Reg_sp).val;
+    uint64_t mstackovr = csr_[CSR_mstackovr];
+    uint64_t mstackund = csr_[CSR_mstackund];
+    uint64_t sp = R[Reg_sp];
     if (mstackovr != 0 && sp < mstackovr) {
         generateException(EXCEPTION_StackOverflow, getPC());
-        writeCSR(CSR_mstackovr, 0);
+        csr_[CSR_mstackovr] = 0;
     } else if (mstackund != 0 && sp > mstackund) {
         generateException(EXCEPTION_StackUnderflow, getPC());
-        writeCSR(CSR_mstackund, 0);
+        csr_[CSR_mstackund] = 0;
     }
 }
 
@@ -118,7 +120,7 @@ void CpuRiver_Functional::handleException(int e) {
     }
 
     csr_dcsr_type dcsr;
-    dcsr.u64 = static_cast<uint32_t>(readCSR(CSR_dcsr));
+    dcsr.u64 = static_cast<uint32_t>(csr_[CSR_dcsr]);
     if (e == EXCEPTION_Breakpoint && dcsr.bits.ebreakm == 1) {
         setNPC(getPC());
         halt(HALT_CAUSE_EBREAK, "EBREAK Breakpoint");
@@ -127,7 +129,7 @@ void CpuRiver_Functional::handleException(int e) {
 
     switchContext(PRV_M);
 
-    uint64_t mtvec = readCSR(CSR_mtvec) & ~0x3ull;
+    uint64_t mtvec = csr_[CSR_mtvec] & ~0x3ull;
     setNPC(mtvec);
 }
 
@@ -135,13 +137,13 @@ void CpuRiver_Functional::handleInterrupts() {
     int ctx = 0;
     csr_mcause_type mcause;
     csr_mstatus_type mstatus;
-    mstatus.value = readCSR(CSR_mstatus);
+    mstatus.value = csr_[CSR_mstatus];
     if (mstatus.bits.MIE == 0) {
         return;
     }
 
     csr_mie_type mie;
-    mie.value = readCSR(CSR_mie);
+    mie.value = csr_[CSR_mie];
 
     // Check software interrupt
     mcause.value = 0;
@@ -171,11 +173,11 @@ void CpuRiver_Functional::handleInterrupts() {
     }
 
     if (mcause.bits.irq) {
-        writeCSR(CSR_mcause, mcause.value);
+        csr_[CSR_mcause] = mcause.value;
 
         switchContext(PRV_M);
 
-        uint64_t mtvec = readCSR(CSR_mtvec);
+        uint64_t mtvec = csr_[CSR_mtvec];
         uint64_t mtvecmode = mtvec & 0x3;
         mtvec &= ~0x3ull;
         // Vector table only for interrupts (not for exceptions):
@@ -192,15 +194,15 @@ void CpuRiver_Functional::switchContext(uint32_t prvnxt) {
     // doesn't setup other.
     // @todo delegating
     csr_mstatus_type mstatus;
-    mstatus.value = readCSR(CSR_mstatus);
+    mstatus.value = csr_[CSR_mstatus];
     mstatus.bits.MPP = cur_prv_level;
     mstatus.bits.MPIE = (mstatus.value >> cur_prv_level) & 0x1;
     mstatus.bits.MIE = 0;
     cur_prv_level = prvnxt;
-    writeCSR(CSR_mstatus, mstatus.value);
+    csr_[CSR_mstatus] = mstatus.value;
 
     int xepc = static_cast<int>((cur_prv_level << 8) + 0x41);
-    writeCSR(xepc, getNPC());
+    csr_[xepc] = getNPC();
 }
 
 void CpuRiver_Functional::reset(IFace *isource) {
@@ -304,10 +306,20 @@ void CpuRiver_Functional::traceOutput() {
 
 bool CpuRiver_Functional::isStepEnabled() {
     csr_dcsr_type dcsr;
-    dcsr.u64 = static_cast<uint32_t>(readCSR(CSR_dcsr));
+    dcsr.u64 = static_cast<uint32_t>(csr_[CSR_dcsr]);
     return dcsr.bits.step;
 }
 
+bool CpuRiver_Functional::updateState() {
+    if (dbgCsrWr_.valid) {
+        RISCV_memory_barrier();
+        writeCSR(dbgCsrWr_.regno, dbgCsrWr_.val);
+        RISCV_memory_barrier();
+        dbgCsrWr_.valid = false;
+    }
+    return CpuGeneric::updateState();
+}
+
 void CpuRiver_Functional::enterDebugMode(uint64_t v, uint32_t cause) {
     csr_dcsr_type dcsr;
     dcsr.u64 = static_cast<uint32_t>(readCSR(CSR_dcsr));
@@ -333,7 +345,23 @@ uint64_t CpuRiver_Functional::readRegDbg(uint32_t regno) {
 void CpuRiver_Functional::writeRegDbg(uint32_t regno, uint64_t val) {
     uint32_t region = regno >> 12;
     if (region == 0) {
-        writeCSR(regno, val);
+        // Single slot mailbox processed by the simulation thread in any
+        // state, so writeCSR() side effects are never run concurrently
+        while (dbgCsrWr_.valid && isEnabled()) {
+            RISCV_sleep_ms(0);
+        }
+        if (!isEnabled()) {
+            writeCSR(regno, val);
+            return;
+        }
+        dbgCsrWr_.regno = regno;
+        dbgCsrWr_.val = val;
+        RISCV_memory_barrier();
+        dbgCsrWr_.valid = true;
+        // Following debugger reads see the new value
+        while (dbgCsrWr_.valid && isEnabled()) {
+            RISCV_sleep_ms(0);
+        }
     } else if (region == 1) {
         writeGPR(regno & 0x3F, val);
     } else if (region == 0xc) {
@@ -398,9 +426,7 @@ uint64_t CpuRiver_Functional::readCSR(uint32_t regno) {
     default:;
     }
     if (rd_access) {
-        RISCV_mutex_lock(&mutex_csr_);
-        ret = portCSR_.read(regno).val;
-        RISCV_mutex_unlock(&mutex_csr_);
+        ret = csr_[regno];
     }
     return ret;
 }
@@ -440,6 +466,7 @@ void CpuRiver_Functional::writeCSR(uint32_t regno, uint64_t val) {
             tdata1.mcontrol_bits.maskmax = mcontrolMaskmax_.to_uint64();
         }
         ptriggers_[trigidx].data1.val = val;
+        invalidateTriggers();
         RISCV_info("[tdata1] <= %016" RV_PRI64 "x, type=%d",
             val, static_cast<uint32_t>(tdata1.bitsdef.type));
         val = tdata1.val;
@@ -447,11 +474,13 @@ void CpuRiver_Functional::writeCSR(uint32_t regno, uint64_t val) {
     case CSR_tdata2:
         trigidx = readCSR(CSR_tselect);
         ptriggers_[trigidx].data2 = val;
+        invalidateTriggers();
         RISCV_info("[tdata2] <= %016" RV_PRI64 "x", val);
         break;
     case CSR_textra:
         trigidx = readCSR(CSR_tselect);
         ptriggers_[trigidx].extra = val;
+        invalidateTriggers();
         RISCV_info("[textra] <= %016" RV_PRI64 "x", val);
         break;
     case CSR_flushi:
@@ -466,9 +495,7 @@ void CpuRiver_Functional::writeCSR(uint32_t regno, uint64_t val) {
     default:;
     }
     if (wr_access) {
-        RISCV_mutex_lock(&mutex_csr_);
-        portCSR_.write(regno, val);
-        RISCV_mutex_unlock(&mutex_csr_);
+        csr_[regno] = val;
     }
 }
 
@@ -81,6 +81,7 @@ class CpuRiver_Functional : public CpuGeneric,
 
  protected:
     /** CpuGeneric common methods */
+    virtual uint64_t getHartId() override { return hartid_.to_uint64(); }
     virtual EEndianessType endianess() { return LittleEndian; }
     virtual GenericInstruction *decodeInstruction(Reg64Type *cache);
     virtual void generateIllegalOpcode();
@@ -92,6 +93,7 @@ class CpuRiver_Functional : public CpuGeneric,
     virtual void traceOutput() override;
     virtual bool isStepEnabled() override;
     virtual void checkStackProtection() override;
+    virtual bool updateState() override;
 
     void addIsaUserRV64I();
     void addIsaPrivilegedRV64I();
@@ -128,6 +130,18 @@ class CpuRiver_Functional : public CpuGeneric,
 
     uint64_t mmuReservatedAddr_;
     int mmuReservedAddrWatchdog_;   // not exceed 64 instructions between LR/SC
+
+    /**
+     * CSR storage owned by the simulation thread. Debugger writes are
+     * passed through dbgCsrWr_ and applied by the simulation thread itself
+     * between instructions or while halted.
+     */
+    uint64_t *csr_;
+    struct DbgCsrRequestType {
+        volatile bool valid;
+        uint32_t regno;
+        uint64_t val;
+    } dbgCsrWr_;
 };
 
 DECLARE_CLASS(CpuRiver_Functional)
@@ -153,6 +153,7 @@ RiscvSourceService::RiscvSourceService(const char *name) : IService(name) {
     brList_.make_list(0);
     symbolListSortByName_.make_list(0);
     symbolListSortByAddr_.make_list(0);
+    isymtbl_ = 0;
 }
 
 RiscvSourceService::~RiscvSourceService() {
@@ -201,10 +202,27 @@ void RiscvSourceService::addSymbols(AttributeType *list) {
     symbolListSortByAddr_.sort(Symbol_Addr);
 }
 
+void RiscvSourceService::getSymbols(AttributeType *list) {
+    if (!isymtbl_) {
+        *list = symbolListSortByName_;
+        return;
+    }
+    isymtbl_->getSymbols(list);
+    if (symbolListSortByName_.size()) {
+        for (unsigned i = 0; i < symbolListSortByName_.size(); i++) {
+            list->add_to_list(&symbolListSortByName_[i]);
+        }
+        list->sort(Symbol_Name);
+    }
+}
+
 void RiscvSourceService::addressToSymbol(uint64_t addr, AttributeType *info) {
     uint64_t sadr, send;
     int sz = static_cast<int>(symbolListSortByAddr_.size());
 
+    if (isymtbl_ && isymtbl_->addressToSymbol(addr, info)) {
+        return;
+    }
     info->make_list(SymbInfo_Total);
     (*info)[SymbInfo_Name].make_string("");
     (*info)[SymbInfo_Address].make_uint64(0);
@@ -266,6 +284,9 @@ void RiscvSourceService::addressToSymbol(uint64_t addr, AttributeType *info) {
 }
 
 int RiscvSourceService::symbol2Address(const char *name, uint64_t *addr) {
+    if (isymtbl_ && isymtbl_->symbol2Address(name, addr) == 0) {
+        return 0;
+    }
     for (unsigned i = 0; i < symbolListSortByName_.size(); i++) {
         AttributeType &item = symbolListSortByName_[i];
         if (item[Symbol_Name].is_equal(name)) {
@@ -50,9 +50,9 @@ public:
 
     virtual void clearSymbols();
 
-    virtual void getSymbols(AttributeType *list) {
-        *list = symbolListSortByName_;
-    }
+    virtual void setSymbolTable(ISymbolTable *tbl) { isymtbl_ = tbl; }
+
+    virtual void getSymbols(AttributeType *list);
 
     virtual void addressToSymbol(uint64_t addr, AttributeType *info);
 
@@ -83,6 +83,7 @@ private:
     AttributeType brList_;
     AttributeType symbolListSortByName_;
     AttributeType symbolListSortByAddr_;
+    ISymbolTable *isymtbl_;
 };
 
 DECLARE_CLASS(RiscvSourceService)
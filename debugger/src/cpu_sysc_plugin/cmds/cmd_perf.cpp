@@ -0,0 +1,63 @@
+/*
+ *  Copyright 2018 Sergey Khabarov, sergeykhbr@gmail.com
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include "cmd_perf.h"
+
+namespace debugger {
+
+CmdPerf::CmdPerf(IService *parent, RtlPerfCounters *perf)
+    : ICommand(parent, "perf") {
+
+    briefDescr_.make_string("Read hardware performance counters of "
+                            "the RTL model");
+    detailedDescr_.make_string(
+        "Description:\n"
+        "    Read or clear cache, TLB, branch predictor and pipeline stall\n"
+        "    counters collected by the RTL model since the start or the\n"
+        "    last reset. Hit counts are Access - Miss for caches.\n"
+        "Usage:\n"
+        "    perf [reset]\n"
+        "Output format:\n"
+        "    {'cpu0':{'Cycles':i,'L1I_Access':i,...},'l2':{...}}\n"
+        "Example:\n"
+        "    perf\n"
+        "    perf reset\n");
+
+    perf_ = perf;
+}
+
+int CmdPerf::isValid(AttributeType *args) {
+    if (!cmdName_.is_equal((*args)[0u].to_string())) {
+        return CMD_INVALID;
+    }
+    if (args->size() == 1) {
+        return CMD_VALID;
+    }
+    if (args->size() == 2 && (*args)[1].is_string()
+        && (*args)[1].is_equal("reset")) {
+        return CMD_VALID;
+    }
+    return CMD_WRONG_ARGS;
+}
+
+void CmdPerf::exec(AttributeType *args, AttributeType *res) {
+    perf_->getCounters(res);
+    if (args->size() == 2) {
+        perf_->reset();
+    }
+}
+
+}  // namespace debugger
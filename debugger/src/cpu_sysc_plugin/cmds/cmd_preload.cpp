@@ -0,0 +1,192 @@
+/*
+ *  Copyright 2018 Sergey Khabarov, sergeykhbr@gmail.com
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include <string.h>
+#include "cmd_preload.h"
+#include "coreservices/ielfreader.h"
+
+namespace debugger {
+
+CmdPreload::CmdPreload(IService *parent, IMemoryOperation *ibus)
+    : ICommand(parent, "preload") {
+
+    briefDescr_.make_string("Load image directly into the simulated "
+                            "memories");
+    detailedDescr_.make_string(
+        "Description:\n"
+        "    Copy ELF-file loadable segments or binary file into RAM/ROM\n"
+        "    backing storage without DMI and simulated bus transactions.\n"
+        "    Binary file is loaded at the specified address. ELF-file\n"
+        "    symbols become available as after 'loadelf'.\n"
+        "    Use it while CPU is halted or in reset: cached lines aren't\n"
+        "    updated. Attribute PreloadFile does the same at time zero.\n"
+        "Usage:\n"
+        "    preload filename [address]\n"
+        "Output format:\n"
+        "    Number of loaded bytes or error if a part of the image\n"
+        "    doesn't map to any device\n"
+        "Example:\n"
+        "    preload /home/riscv/image.elf\n"
+        "    preload /home/riscv/image.bin 0x80000000\n");
+
+    ibus_ = ibus;
+    loaded_ = 0;
+    skipped_ = 0;
+    skippedAddr_ = 0;
+}
+
+int CmdPreload::isValid(AttributeType *args) {
+    if (!cmdName_.is_equal((*args)[0u].to_string())) {
+        return CMD_INVALID;
+    }
+    if ((args->size() == 2 || args->size() == 3) && (*args)[1].is_string()) {
+        return CMD_VALID;
+    }
+    return CMD_WRONG_ARGS;
+}
+
+void CmdPreload::exec(AttributeType *args, AttributeType *res) {
+    uint64_t binaddr = 0;
+    if (args->size() == 3) {
+        binaddr = (*args)[2].to_uint64();
+    }
+    load((*args)[1].to_string(), binaddr, res);
+}
+
+void CmdPreload::load(const char *filename, uint64_t binaddr,
+                      AttributeType *res) {
+    uint64_t fsz;
+    uint8_t *img;
+    bool is_elf;
+
+    res->attr_free();
+    res->make_nil();
+    loaded_ = 0;
+    skipped_ = 0;
+    skippedAddr_ = 0;
+
+    img = reinterpret_cast<uint8_t *>(RISCV_file_map(filename, &fsz));
+    if (!img) {
+        generateError(res, "Cannot open file");
+        return;
+    }
+    is_elf = fsz >= 4 && memcmp(img, "\x7F" "ELF", 4) == 0;
+    if (!is_elf) {
+        write(binaddr, img, fsz);
+    }
+    RISCV_file_unmap(img, fsz);
+
+    if (is_elf && !loadElf(filename, res)) {
+        return;
+    }
+    if (skipped_) {
+        char tstr[128];
+        RISCV_sprintf(tstr, sizeof(tstr),
+            "%" RV_PRI64 "d bytes not loaded: no device at 0x%08" RV_PRI64
+            "x", skipped_, skippedAddr_);
+        generateError(res, tstr);
+        return;
+    }
+    res->make_uint64(loaded_);
+}
+
+bool CmdPreload::loadElf(const char *filename, AttributeType *res) {
+    AttributeType lstServ;
+    RISCV_get_services_with_iface(IFACE_ELFREADER, &lstServ);
+    if (lstServ.size() == 0) {
+        generateError(res, "Elf-service not found");
+        return false;
+    }
+    IService *iserv = static_cast<IService *>(lstServ[0u].to_iface());
+    IElfReader *elf = static_cast<IElfReader *>(
+                        iserv->getInterface(IFACE_ELFREADER));
+    if (elf->readFile(filename) < 0) {
+        generateError(res, "Cannot read ELF-file");
+        return false;
+    }
+
+    if (elf->loadableSegmentTotal()) {
+        uint64_t addr;
+        for (unsigned i = 0; i < elf->loadableSegmentTotal(); i++) {
+            if (elf->segmentMemSize(i) < elf->segmentFileSize(i)) {
+                generateError(res, "Segment memsz is less than filesz");
+                return false;
+            }
+            addr = elf->segmentAddress(i);
+            write(addr, elf->segmentData(i), elf->segmentFileSize(i));
+            write(addr + elf->segmentFileSize(i), 0,
+                  elf->segmentMemSize(i) - elf->segmentFileSize(i));
+        }
+        return true;
+    }
+
+    for (unsigned i = 0; i < elf->loadableSectionTotal(); i++) {
+        write(elf->sectionAddress(i), elf->sectionData(i),
+              elf->sectionSize(i));
+    }
+    return true;
+}
+
+void CmdPreload::write(uint64_t addr, const uint8_t *buf, uint64_t sz) {
+    Axi4TransactionType tr;
+    uint8_t *phost;
+    uint64_t avail;
+    uint64_t n;
+
+    while (sz) {
+        avail = 0;
+        phost = ibus_->getHostPointer(addr, MemAction_Backdoor, &avail);
+        if (phost && avail) {
+            n = sz < avail ? sz : avail;
+            if (buf) {
+                memcpy(phost, buf, static_cast<size_t>(n));
+            } else {
+                memset(phost, 0, static_cast<size_t>(n));
+            }
+        } else {
+            // Device without host memory: aligned 8-bytes transactions
+            n = PAYLOAD_MAX_BYTES - (addr & (PAYLOAD_MAX_BYTES - 1));
+            if (n > sz) {
+                n = sz;
+            }
+            memset(&tr, 0, sizeof(tr));
+            tr.action = MemAction_Write;
+            tr.addr = addr;
+            tr.xsize = static_cast<uint32_t>(n);
+            tr.wstrb = (1u << n) - 1;
+            if (buf) {
+                memcpy(tr.wpayload.b8, buf, static_cast<size_t>(n));
+            }
+            if (ibus_->b_transport(&tr) == TRANS_ERROR
+                || tr.response == MemResp_Error) {
+                // Unmapped region, skip the rest of it
+                if (skipped_ == 0) {
+                    skippedAddr_ = addr;
+                }
+                skipped_ += sz;
+                return;
+            }
+        }
+        addr += n;
+        sz -= n;
+        loaded_ += n;
+        if (buf) {
+            buf += n;
+        }
+    }
+}
+
+}  // namespace debugger
@@ -0,0 +1,62 @@
+/*
+ *  Copyright 2018 Sergey Khabarov, sergeykhbr@gmail.com
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#ifndef __DEBUGGER_SRC_CPU_SYSC_PLUGIN_CMDS_CMD_PRELOAD_H__
+#define __DEBUGGER_SRC_CPU_SYSC_PLUGIN_CMDS_CMD_PRELOAD_H__
+
+#include "api_core.h"
+#include "iservice.h"
+#include "coreservices/icommand.h"
+#include "coreservices/imemop.h"
+
+namespace debugger {
+
+/**
+ * @brief Backdoor image loader into the memories of the system bus.
+ * @details ELF PT_LOAD segments (or loadable sections) or a raw binary are
+ *          copied directly into the backing storage of RAM/ROM devices
+ *          using IMemoryOperation::getHostPointer(), devices without host
+ *          memory get b_transport() writes. Nothing goes through DMI or
+ *          the simulated clock, so multi-megabyte images are loaded in
+ *          milliseconds. ROM is loaded too using MemAction_Backdoor.
+ *          Bytes at unmapped addresses are reported as an error.
+ */
+class CmdPreload : public ICommand {
+ public:
+    CmdPreload(IService *parent, IMemoryOperation *ibus);
+
+    /** ICommand */
+    virtual int isValid(AttributeType *args);
+    virtual void exec(AttributeType *args, AttributeType *res);
+
+    /** Number of loaded bytes or error description is returned in 'res' */
+    void load(const char *filename, uint64_t binaddr, AttributeType *res);
+
+ private:
+    bool loadElf(const char *filename, AttributeType *res);
+    /** buf = 0 fills the region with zeros. Stops on the bus error */
+    void write(uint64_t addr, const uint8_t *buf, uint64_t sz);
+
+ private:
+    IMemoryOperation *ibus_;
+    uint64_t loaded_;
+    uint64_t skipped_;          // bytes that don't map to any device
+    uint64_t skippedAddr_;      // the first unmapped address
+};
+
+}  // namespace debugger
+
+#endif  // __DEBUGGER_SRC_CPU_SYSC_PLUGIN_CMDS_CMD_PRELOAD_H__
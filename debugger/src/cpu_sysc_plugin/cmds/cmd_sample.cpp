@@ -0,0 +1,401 @@
+/*
+ *  Copyright 2018 Sergey Khabarov, sergeykhbr@gmail.com
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include <riscv-isa.h>
+#include "coreservices/icpuriscv.h"
+#include "cmd_sample.h"
+
+namespace debugger {
+
+/** CSRs that define architectural state of a bare-metal or OS program */
+static const uint16_t SAMPLE_CSR_LIST[] = {
+    ICpuRiscV::CSR_fcsr,
+    ICpuRiscV::CSR_mstatus,
+    ICpuRiscV::CSR_medeleg,
+    ICpuRiscV::CSR_mideleg,
+    ICpuRiscV::CSR_mie,
+    ICpuRiscV::CSR_mtvec,
+    ICpuRiscV::CSR_mscratch,
+    ICpuRiscV::CSR_mepc,
+    ICpuRiscV::CSR_mcause,
+    ICpuRiscV::CSR_mtval,
+    0x105,                          // stvec
+    0x140,                          // sscratch
+    ICpuRiscV::CSR_sepc,
+    0x142,                          // scause
+    0x143,                          // stval
+    ICpuRiscV::CSR_satp,
+    ICpuRiscV::CSR_mstackovr,
+    ICpuRiscV::CSR_mstackund,
+    0
+};
+
+/** Functional model and River use the same DMI register numbers */
+static const uint32_t SAMPLE_REGNO_GPR = 0x1000;
+static const uint32_t SAMPLE_REGS_TOTAL =
+    ICpuRiscV::RegFpu_Offset + ICpuRiscV::RegFpu_Total;
+static const int SAMPLE_HALT_WATCHDOG = 100;
+
+CmdSample::CmdSample(IService *parent, IJtag *ijtag, IClock *irtlclk,
+                     IService *iss)
+    : ICommandRiscv(parent, "sample", ijtag), IClockListener() {
+
+    briefDescr_.make_string("Sampled simulation: functional fast-forward "
+                            "with RTL measurement windows");
+    detailedDescr_.make_string(
+        "Description:\n"
+        "    Run functional model up to the specified instruction count or\n"
+        "    symbol, transfer architectural state (GPR, FPR, CSR, PC and\n"
+        "    privilege level) into the RTL core, run the RTL core for\n"
+        "    <window> clock cycles and measure CPI. The state is copied\n"
+        "    back into the functional model and the RTL core is held in\n"
+        "    reset until the next sample. Memory is shared via system bus.\n"
+        "Usage:\n"
+        "    sample <steps|symbol> <window> [<count>]\n"
+        "Output format:\n"
+        "    [d,[[i,i,i,d],...]]\n"
+        "         d - Mean CPI over all windows (double).\n"
+        "         i - PC value at the window start (uint64_t).\n"
+        "         i - RTL clock cycles in the window (uint64_t).\n"
+        "         i - RTL instructions retired in the window (uint64_t).\n"
+        "         d - CPI of the window (double).\n"
+        "Example:\n"
+        "    sample 1000000 20000\n"
+        "    sample 1000000 20000 10\n"
+        "    sample main 50000\n");
+
+    irtlclk_ = irtlclk;
+    issclk_ = static_cast<IClock *>(iss->getInterface(IFACE_CLOCK));
+    issdport_ = static_cast<IDPort *>(iss->getInterface(IFACE_DPORT));
+    issfunc_ = static_cast<ICpuFunctional *>(
+                    iss->getInterface(IFACE_CPU_FUNCTIONAL));
+    ffActive_ = false;
+
+    AttributeType lstServ;
+    RISCV_get_services_with_iface(IFACE_SOURCE_CODE, &lstServ);
+    isrc_ = 0;
+    if (lstServ.size() != 0) {
+        IService *iserv = static_cast<IService *>(lstServ[0u].to_iface());
+        isrc_ = static_cast<ISourceCode *>(
+                            iserv->getInterface(IFACE_SOURCE_CODE));
+    }
+}
+
+int CmdSample::isValid(AttributeType *args) {
+    if (!cmdName_.is_equal((*args)[0u].to_string())) {
+        return CMD_INVALID;
+    }
+    if (!issclk_ || !issdport_ || !issfunc_) {
+        return CMD_INVALID;
+    }
+    if (args->size() < 3 || args->size() > 4) {
+        return CMD_WRONG_ARGS;
+    }
+    if (!(*args)[1].is_integer() && !(*args)[1].is_string()) {
+        return CMD_WRONG_ARGS;
+    }
+    if (!(*args)[2].is_integer()) {
+        return CMD_WRONG_ARGS;
+    }
+    if (args->size() == 4 && !(*args)[3].is_integer()) {
+        return CMD_WRONG_ARGS;
+    }
+    return CMD_VALID;
+}
+
+void CmdSample::exec(AttributeType *args, AttributeType *res) {
+    uint64_t window = (*args)[2].to_uint64();
+    unsigned count = 1;
+    uint64_t cycles_total = 0;
+    uint64_t instr_total = 0;
+    Reg64Type cycle0, cycle1, insret0, insret1;
+    AttributeType item;
+    if (args->size() == 4) {
+        count = (*args)[3].to_uint32();
+    }
+
+    res->make_list(2);
+    (*res)[0u].make_floating(0);
+    (*res)[1].make_list(0);
+
+    issHalt();
+    rtlHoldReset();
+
+    for (unsigned i = 0; i < count; i++) {
+        if (!fastForward(&(*args)[1])) {
+            generateError(res, "Cannot fast-forward functional model");
+            return;
+        }
+        if (!rtlHaltOnReset()) {
+            generateError(res, "Cannot halt RTL core after reset");
+            return;
+        }
+        issToRtl();
+
+        get_reg("cycle", &cycle0);
+        get_reg("insret", &insret0);
+        uint64_t t_end = irtlclk_->getStepCounter() + window;
+        if (!rtlResume()) {
+            generateError(res, "Cannot resume RTL core");
+            return;
+        }
+        while (irtlclk_->getStepCounter() < t_end) {
+            RISCV_sleep_ms(1);
+        }
+        if (!rtlHalt()) {
+            generateError(res, "Cannot halt RTL core");
+            return;
+        }
+        get_reg("cycle", &cycle1);
+        get_reg("insret", &insret1);
+
+        item.make_list(4);
+        item[0u].make_uint64(issdport_->readRegDbg(ICpuRiscV::CSR_dpc));
+        item[1].make_uint64(cycle1.val - cycle0.val);
+        item[2].make_uint64(insret1.val - insret0.val);
+        if (item[2].to_uint64()) {
+            item[3].make_floating(static_cast<double>(item[1].to_uint64())
+                                / static_cast<double>(item[2].to_uint64()));
+        } else {
+            item[3].make_floating(0);
+        }
+        (*res)[1].add_to_list(&item);
+        cycles_total += item[1].to_uint64();
+        instr_total += item[2].to_uint64();
+
+        rtlFlush();
+        rtlToIss();
+        rtlHoldReset();
+    }
+
+    if (instr_total) {
+        (*res)[0u].make_floating(static_cast<double>(cycles_total)
+                               / static_cast<double>(instr_total));
+    }
+}
+
+void CmdSample::stepCallback(uint64_t t) {
+    if (ffActive_) {
+        issdport_->haltreq();
+    }
+}
+
+bool CmdSample::fastForward(AttributeType *ff) {
+    TriggerData1Type tdata1;
+    uint64_t addr;
+    uint64_t t0 = issclk_->getStepCounter();
+
+    if (ff->is_integer()) {
+        if (ff->to_uint64() == 0) {
+            return true;
+        }
+        ffActive_ = true;
+        issclk_->registerStepCallback(static_cast<IClockListener *>(this),
+                                      t0 + ff->to_uint64());
+    } else {
+        if (!isrc_ || isrc_->symbol2Address(ff->to_string(), &addr) < 0) {
+            return false;
+        }
+        // Hardware breakpoint on the first instruction of the symbol
+        tdata1.val = 0;
+        tdata1.mcontrol_bits.type = 2;      // TriggerType_AddrDataMatch
+        tdata1.mcontrol_bits.dmode = 1;
+        tdata1.mcontrol_bits.action = 1;    // enter Debug Mode
+        tdata1.mcontrol_bits.execute = 1;
+        tdata1.mcontrol_bits.m = 1;
+        tdata1.mcontrol_bits.s = 1;
+        tdata1.mcontrol_bits.u = 1;
+        issdport_->writeRegDbg(ICpuRiscV::CSR_tselect, 0);
+        issdport_->writeRegDbg(ICpuRiscV::CSR_tdata1, tdata1.val);
+        issdport_->writeRegDbg(ICpuRiscV::CSR_tdata2, addr);
+    }
+
+    issdport_->resumereq();
+    while (issdport_->isHalted() && issclk_->getStepCounter() == t0) {
+        RISCV_sleep_ms(1);
+    }
+    while (!issdport_->isHalted()) {
+        RISCV_sleep_ms(1);
+    }
+    ffActive_ = false;
+
+    if (!ff->is_integer()) {
+        issdport_->writeRegDbg(ICpuRiscV::CSR_tdata1, 0);
+    }
+    return true;
+}
+
+void CmdSample::issHalt() {
+    if (issdport_->isHalted()) {
+        return;
+    }
+    issdport_->haltreq();
+    while (!issdport_->isHalted()) {
+        RISCV_sleep_ms(1);
+    }
+}
+
+void CmdSample::rtlHoldReset() {
+    IJtag::dmi_dmcontrol_type dmcontrol;
+    dmcontrol.u32 = 0;
+    dmcontrol.bits.dmactive = 1;
+    dmcontrol.bits.ndmreset = 1;
+    write_dmi(IJtag::DMI_DMCONTROL, dmcontrol.u32);
+}
+
+bool CmdSample::rtlHaltOnReset() {
+    IJtag::dmi_dmstatus_type dmstatus;
+    IJtag::dmi_dmcontrol_type dmcontrol;
+    int watchdog = 0;
+
+    // Release reset with halt-on-reset so no instruction is executed
+    dmcontrol.u32 = 0;
+    dmcontrol.bits.dmactive = 1;
+    dmcontrol.bits.ndmreset = 1;
+    dmcontrol.bits.setresethaltreq = 1;
+    write_dmi(IJtag::DMI_DMCONTROL, dmcontrol.u32);
+
+    dmcontrol.u32 = 0;
+    dmcontrol.bits.dmactive = 1;
+    write_dmi(IJtag::DMI_DMCONTROL, dmcontrol.u32);
+
+    do {
+        dmstatus.u32 = read_dmi(IJtag::DMI_DMSTATUS);
+    } while (dmstatus.bits.allhalted == 0
+            && watchdog++ < SAMPLE_HALT_WATCHDOG);
+
+    dmcontrol.u32 = 0;
+    dmcontrol.bits.dmactive = 1;
+    dmcontrol.bits.clrresethaltreq = 1;
+    write_dmi(IJtag::DMI_DMCONTROL, dmcontrol.u32);
+    return dmstatus.bits.allhalted == 1;
+}
+
+bool CmdSample::rtlResume() {
+    IJtag::dmi_dmstatus_type dmstatus;
+    IJtag::dmi_dmcontrol_type dmcontrol;
+    int watchdog = 0;
+
+    dmcontrol.u32 = 0;
+    dmcontrol.bits.dmactive = 1;
+    dmcontrol.bits.resumereq = 1;
+    write_dmi(IJtag::DMI_DMCONTROL, dmcontrol.u32);
+
+    do {
+        dmstatus.u32 = read_dmi(IJtag::DMI_DMSTATUS);
+    } while (dmstatus.bits.allrunning == 0
+            && watchdog++ < SAMPLE_HALT_WATCHDOG);
+
+    dmcontrol.u32 = 0;
+    dmcontrol.bits.dmactive = 1;
+    write_dmi(IJtag::DMI_DMCONTROL, dmcontrol.u32);
+    return dmstatus.bits.allrunning == 1;
+}
+
+bool CmdSample::rtlHalt() {
+    IJtag::dmi_dmstatus_type dmstatus;
+    IJtag::dmi_dmcontrol_type dmcontrol;
+    int watchdog = 0;
+
+    dmcontrol.u32 = 0;
+    dmcontrol.bits.dmactive = 1;
+    dmcontrol.bits.haltreq = 1;
+    write_dmi(IJtag::DMI_DMCONTROL, dmcontrol.u32);
+
+    do {
+        dmstatus.u32 = read_dmi(IJtag::DMI_DMSTATUS);
+    } while (dmstatus.bits.allhalted == 0
+            && watchdog++ < SAMPLE_HALT_WATCHDOG);
+
+    dmcontrol.u32 = 0;
+    dmcontrol.bits.dmactive = 1;
+    write_dmi(IJtag::DMI_DMCONTROL, dmcontrol.u32);
+    return dmstatus.bits.allhalted == 1;
+}
+
+/** Write back dirty D-cache lines so that memory is coherent for the ISS */
+void CmdSample::rtlFlush() {
+    IJtag::dmi_command_type command;
+
+    write_dmi(IJtag::DMI_PROGBUF0, OPCODE_FENCE_I);
+    write_dmi(IJtag::DMI_PROGBUF1, OPCODE_FENCE);
+    write_dmi(IJtag::DMI_PROGBUF2, OPCODE_EBREAK);
+
+    command.u32 = 0;
+    command.regaccess.cmdtype = 0;
+    command.regaccess.aarsize = IJtag::CMD_AAxSIZE_32BITS;
+    command.regaccess.postexec = 1;
+    command.regaccess.regno = SAMPLE_REGNO_GPR;
+    write_dmi(IJtag::DMI_COMMAND, command.u32);
+    wait_dmi();
+}
+
+void CmdSample::issToRtl() {
+    csr_dcsr_type dcsr;
+
+    for (uint32_t i = 1; i < SAMPLE_REGS_TOTAL; i++) {
+        rtlWriteReg(SAMPLE_REGNO_GPR + i,
+                    issdport_->readRegDbg(SAMPLE_REGNO_GPR + i));
+    }
+    for (const uint16_t *pcsr = SAMPLE_CSR_LIST; *pcsr; pcsr++) {
+        rtlWriteReg(*pcsr, issdport_->readRegDbg(*pcsr));
+    }
+    rtlWriteReg(ICpuRiscV::CSR_dpc,
+                issdport_->readRegDbg(ICpuRiscV::CSR_dpc));
+
+    dcsr.u64 = rtlReadReg(ICpuRiscV::CSR_dcsr);
+    dcsr.bits.prv = issfunc_->getPrvLevel();
+    rtlWriteReg(ICpuRiscV::CSR_dcsr, dcsr.u64);
+}
+
+void CmdSample::rtlToIss() {
+    csr_dcsr_type dcsr;
+    uint64_t pc;
+
+    for (uint32_t i = 1; i < SAMPLE_REGS_TOTAL; i++) {
+        issdport_->writeRegDbg(SAMPLE_REGNO_GPR + i,
+                               rtlReadReg(SAMPLE_REGNO_GPR + i));
+    }
+    for (const uint16_t *pcsr = SAMPLE_CSR_LIST; *pcsr; pcsr++) {
+        issdport_->writeRegDbg(*pcsr, rtlReadReg(*pcsr));
+    }
+
+    // Functional model continues from npc on resume
+    pc = rtlReadReg(ICpuRiscV::CSR_dpc);
+    issdport_->writeRegDbg(ICpuRiscV::CSR_dpc, pc);
+    issfunc_->setNPC(pc);
+
+    dcsr.u64 = rtlReadReg(ICpuRiscV::CSR_dcsr);
+    issfunc_->setPrvLevel(dcsr.bits.prv);
+
+    // RTL could modify instruction memory
+    issfunc_->flush(~0ull);
+}
+
+uint64_t CmdSample::rtlReadReg(uint32_t regno) {
+    Reg64Type t;
+    t.val = 0;
+    get_reg(regno, IJtag::CMD_AAxSIZE_64BITS, &t);
+    return t.val;
+}
+
+void CmdSample::rtlWriteReg(uint32_t regno, uint64_t val) {
+    Reg64Type t;
+    t.val = val;
+    set_reg(regno, IJtag::CMD_AAxSIZE_64BITS, &t);
+}
+
+}  // namespace debugger
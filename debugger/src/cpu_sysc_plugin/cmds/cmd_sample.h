@@ -0,0 +1,78 @@
+/*
+ *  Copyright 2018 Sergey Khabarov, sergeykhbr@gmail.com
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#ifndef __DEBUGGER_SRC_CPU_SYSC_PLUGIN_CMDS_CMD_SAMPLE_H__
+#define __DEBUGGER_SRC_CPU_SYSC_PLUGIN_CMDS_CMD_SAMPLE_H__
+
+#include "api_core.h"
+#include "iservice.h"
+#include "coreservices/icommand.h"
+#include "coreservices/iclock.h"
+#include "coreservices/idport.h"
+#include "coreservices/icpufunctional.h"
+#include "coreservices/isrccode.h"
+
+namespace debugger {
+
+/**
+ * @brief Sampled simulation: functional fast-forward plus RTL windows.
+ * @details Functional model runs up to the specified point, then its
+ *          architectural state is loaded into the RTL core via DMI and
+ *          the RTL core is executed for the measurement window. Afterwards
+ *          the state is copied back and the RTL core is held in reset.
+ */
+class CmdSample : public ICommandRiscv,
+                  public IClockListener {
+ public:
+    CmdSample(IService *parent, IJtag *ijtag, IClock *irtlclk,
+              IService *iss);
+
+    /** ICommand */
+    virtual int isValid(AttributeType *args);
+    virtual void exec(AttributeType *args, AttributeType *res);
+
+    /** IClockListener, called from the functional model thread */
+    virtual void stepCallback(uint64_t t);
+
+ private:
+    bool fastForward(AttributeType *ff);
+    void issHalt();
+    void rtlHoldReset();
+    bool rtlHaltOnReset();
+    bool rtlResume();
+    bool rtlHalt();
+    void rtlFlush();
+    void issToRtl();
+    void rtlToIss();
+    uint64_t rtlReadReg(uint32_t regno);
+    void rtlWriteReg(uint32_t regno, uint64_t val);
+
+ private:
+    static const uint32_t OPCODE_FENCE = 0x0000000f;
+    static const uint32_t OPCODE_FENCE_I = 0x0000100f;
+    static const uint32_t OPCODE_EBREAK = 0x00100073;
+
+    IClock *irtlclk_;
+    IClock *issclk_;
+    IDPort *issdport_;
+    ICpuFunctional *issfunc_;
+    ISourceCode *isrc_;
+    volatile bool ffActive_;
+};
+
+}  // namespace debugger
+
+#endif  // __DEBUGGER_SRC_CPU_SYSC_PLUGIN_CMDS_CMD_SAMPLE_H__
@@ -0,0 +1,72 @@
+/*
+ *  Copyright 2018 Sergey Khabarov, sergeykhbr@gmail.com
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include "cmd_wave.h"
+
+namespace debugger {
+
+CmdWave::CmdWave(IService *parent, WaveTraceFile *wave)
+    : ICommand(parent, "wave") {
+
+    briefDescr_.make_string("Control waveform capture of the RTL model");
+    detailedDescr_.make_string(
+        "Description:\n"
+        "    Open or close capture window of the waveform file defined by\n"
+        "    the WaveFile attribute. Without arguments returns the capture\n"
+        "    status.\n"
+        "Usage:\n"
+        "    wave [on|off]\n"
+        "Output format:\n"
+        "    [b,i,i]\n"
+        "         b - Capture window is opened.\n"
+        "         i - Number of captured signals.\n"
+        "         i - Bytes written into the file.\n"
+        "Example:\n"
+        "    wave on\n"
+        "    wave off\n");
+
+    wave_ = wave;
+}
+
+int CmdWave::isValid(AttributeType *args) {
+    if (!cmdName_.is_equal((*args)[0u].to_string())) {
+        return CMD_INVALID;
+    }
+    if (args->size() == 1) {
+        return CMD_VALID;
+    }
+    if (args->size() == 2 && (*args)[1].is_string()
+        && ((*args)[1].is_equal("on") || (*args)[1].is_equal("off"))) {
+        return CMD_VALID;
+    }
+    return CMD_WRONG_ARGS;
+}
+
+void CmdWave::exec(AttributeType *args, AttributeType *res) {
+    if (args->size() == 2) {
+        if ((*args)[1].is_equal("on")) {
+            wave_->enable();
+        } else {
+            wave_->disable();
+        }
+    }
+    res->make_list(3);
+    (*res)[0u].make_boolean(wave_->isEnabled());
+    (*res)[1].make_uint64(wave_->getSignalsTotal());
+    (*res)[2].make_uint64(wave_->getBytesWritten());
+}
+
+}  // namespace debugger
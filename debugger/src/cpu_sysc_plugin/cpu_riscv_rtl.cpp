@@ -19,7 +19,19 @@
 
 namespace debugger {
 
-CpuRiscV_RTL::CpuRiscV_RTL(const char *name)  
+#ifdef SC_MAX_NBITS
+// Fast build: widest River signals must fit into fixed-size sc_biguint
+static_assert(SC_MAX_NBITS >= 32 * CFG_PROGBUF_REG_TOTAL,
+              "SC_MAX_NBITS is less than progbuf width");
+static_assert(SC_MAX_NBITS >= L1CACHE_LINE_BITS + 32,
+              "SC_MAX_NBITS is less than L1 cache line width");
+static_assert(SC_MAX_NBITS >= L2CACHE_LINE_BITS,
+              "SC_MAX_NBITS is less than L2 cache line width");
+static_assert(SC_MAX_NBITS >= CFG_REG_TAG_WIDTH * REGS_TOTAL,
+              "SC_MAX_NBITS is less than register tags width");
+#endif
+
+CpuRiscV_RTL::CpuRiscV_RTL(const char *name)
     : IService(name), IHap(HAP_ConfigDone) {
     registerInterface(static_cast<IThread *>(this));
     registerInterface(static_cast<IClock *>(this));
@@ -36,11 +48,42 @@ CpuRiscV_RTL::CpuRiscV_RTL(const char *name)
     registerAttribute("FreqHz", &freqHz_);
     registerAttribute("InVcdFile", &InVcdFile_);
     registerAttribute("OutVcdFile", &OutVcdFile_);
+    registerAttribute("FastForwardCpu", &fastForwardCpu_);
+    registerAttribute("Jtag", &jtag_);
+    registerAttribute("WaveFile", &waveFile_);
+    registerAttribute("WaveFilter", &waveFilter_);
+    registerAttribute("WaveStart", &waveStart_);
+    registerAttribute("WaveStop", &waveStop_);
+    registerAttribute("WaveTrigger", &waveTrigger_);
+    registerAttribute("WaveTriggerValue", &waveTriggerValue_);
+    registerAttribute("WaveLength", &waveLength_);
+    registerAttribute("PerfCounters", &perfCounters_);
+    registerAttribute("PreloadFile", &preloadFile_);
+    registerAttribute("PreloadAddress", &preloadAddress_);
 
     bus_.make_string("");
     freqHz_.make_uint64(1);
     InVcdFile_.make_string("");
     OutVcdFile_.make_string("");
+    fastForwardCpu_.make_string("");
+    jtag_.make_string("");
+    waveFile_.make_string("");
+    waveFilter_.make_list(0);
+    waveStart_.make_uint64(0);
+    waveStop_.make_uint64(0);
+    waveTrigger_.make_string("");
+    waveTriggerValue_.make_uint64(0);
+    waveLength_.make_uint64(0);
+    perfCounters_.make_dict();
+    preloadFile_.make_string("");
+    preloadAddress_.make_uint64(0);
+    pcmdSample_ = 0;
+    pcmdWave_ = 0;
+    pcmdPerf_ = 0;
+    pcmdPreload_ = 0;
+    wave_ = 0;
+    perf_ = 0;
+    haltntf_ = 0;
     RISCV_event_create(&config_done_, "riscv_sysc_config_done");
     RISCV_register_hap(static_cast<IHap *>(this));
 }
@@ -111,6 +154,49 @@ void CpuRiscV_RTL::postinitService() {
     dmislv_->setLength(4096);
     group0_->generateVCD(i_vcd_, o_vcd_);
 
+    if (waveFile_.size()) {
+        wave_ = new WaveTraceFile(waveFile_.to_string(), &waveFilter_);
+        if (!wave_->isOpened()) {
+            RISCV_error("Cannot open file '%s'", waveFile_.to_string());
+        }
+        sc_time period(1.0 / getFreqHz(), SC_SEC);
+        wave_->setWindow(period.value(),
+                         waveStart_.to_uint64(), waveStop_.to_uint64());
+        wave_->setTrigger(waveTrigger_.to_string(),
+                          waveTriggerValue_.to_uint64(),
+                          waveLength_.to_uint64());
+        wrapper_->generateVCD(0, wave_);
+        group0_->generateVCD(0, wave_);
+        pcmdWave_ = new CmdWave(this, wave_);
+        icmdexec_->registerCommand(pcmdWave_);
+    }
+
+    perf_ = new RtlPerfCounters();
+    group0_->generateVCD(0, perf_);
+    pcmdPerf_ = new CmdPerf(this, perf_);
+    icmdexec_->registerCommand(pcmdPerf_);
+
+    haltntf_ = new RtlHaltNotifier(hartid_.to_uint64());
+    group0_->generateVCD(0, haltntf_);
+
+    pcmdPreload_ = new CmdPreload(this, ibus_);
+    icmdexec_->registerCommand(pcmdPreload_);
+
+    if (fastForwardCpu_.size()) {
+        IService *iss = static_cast<IService *>(
+            RISCV_get_service(fastForwardCpu_.to_string()));
+        IJtag *ijtag = static_cast<IJtag *>(
+            RISCV_get_service_iface(jtag_.to_string(), IFACE_JTAG));
+        if (!iss || !ijtag) {
+            RISCV_error("Cannot enable sampling with ISS '%s' and Jtag '%s'",
+                        fastForwardCpu_.to_string(), jtag_.to_string());
+        } else {
+            pcmdSample_ = new CmdSample(this, ijtag,
+                                        static_cast<IClock *>(this), iss);
+            icmdexec_->registerCommand(pcmdSample_);
+        }
+    }
+
     if (!run()) {
         RISCV_error("Can't create thread.", NULL);
         return;
@@ -118,6 +204,29 @@ void CpuRiscV_RTL::postinitService() {
 }
 
 void CpuRiscV_RTL::predeleteService() {
+    if (pcmdSample_) {
+        icmdexec_->unregisterCommand(pcmdSample_);
+        delete pcmdSample_;
+    }
+    if (pcmdWave_) {
+        icmdexec_->unregisterCommand(pcmdWave_);
+        delete pcmdWave_;
+    }
+    if (pcmdPerf_) {
+        icmdexec_->unregisterCommand(pcmdPerf_);
+        delete pcmdPerf_;
+    }
+    if (pcmdPreload_) {
+        icmdexec_->unregisterCommand(pcmdPreload_);
+        delete pcmdPreload_;
+    }
+}
+
+IAttribute *CpuRiscV_RTL::getAttribute(const char *name) {
+    if (perf_ && strcmp(name, "PerfCounters") == 0) {
+        perf_->getCounters(&perfCounters_);
+    }
+    return IService::getAttribute(name);
 }
 
 void CpuRiscV_RTL::createSystemC() {
@@ -194,9 +303,6 @@ void CpuRiscV_RTL::createSystemC() {
 #ifdef DBG_DCACHE_LRU_TB
     DCacheLru_tb *tb = new DCacheLru_tb("tb");
 #endif
-#ifdef DBG_IDIV_TB
-    IntDiv_tb *tb = new IntDiv_tb("tb");
-#endif
 
     //sc_start(0, SC_NS);
     sc_initialize();
@@ -223,6 +329,19 @@ void CpuRiscV_RTL::stop() {
 void CpuRiscV_RTL::busyLoop() {
     RISCV_event_wait(&config_done_);
 
+    if (pcmdPreload_ && preloadFile_.size()) {
+        AttributeType res;
+        pcmdPreload_->load(preloadFile_.to_string(),
+                           preloadAddress_.to_uint64(), &res);
+        if (res.is_list()) {
+            RISCV_error("Preload '%s': %s", preloadFile_.to_string(),
+                        res[2].to_string());
+        } else {
+            RISCV_info("Preloaded %" RV_PRI64 "d bytes from '%s'",
+                       res.to_uint64(), preloadFile_.to_string());
+        }
+    }
+
     sc_start();
 
     if (i_vcd_) {
@@ -231,6 +350,21 @@ void CpuRiscV_RTL::busyLoop() {
     if (o_vcd_) {
         sc_close_vcd_trace_file(o_vcd_);
     }
+    if (wave_) {
+        sc_get_curr_simcontext()->remove_trace_file(wave_);
+        delete wave_;
+        wave_ = 0;
+    }
+    if (perf_) {
+        sc_get_curr_simcontext()->remove_trace_file(perf_);
+        delete perf_;
+        perf_ = 0;
+    }
+    if (haltntf_) {
+        sc_get_curr_simcontext()->remove_trace_file(haltntf_);
+        delete haltntf_;
+        haltntf_ = 0;
+    }
 }
 
 }  // namespace debugger
@@ -18,6 +18,17 @@
  *                           trace files to compare them with functional model
  *             InVcdFile   - Stimulus VCD file
  *             OutVcdFile  - Reference VCD file with any number of signals
+ *             WaveFile    - Compact binary waveform file (see WaveTraceFile)
+ *             WaveFilter  - List of hierarchical name substrings to capture
+ *             WaveStart, WaveStop - Capture window in clock cycles
+ *             WaveTrigger, WaveTriggerValue, WaveLength - Open capture
+ *                           window for WaveLength cycles when the signal
+ *                           equals to the value
+ *             PerfCounters - Read-only cache, TLB, branch predictor and
+ *                           stall counters (see RtlPerfCounters)
+ *             PreloadFile - ELF or binary image copied into the bus
+ *                           memories at time zero (see CmdPreload)
+ *             PreloadAddress - Load address of the binary PreloadFile
  *
  * @note       When GenerateRef is true Core uses step counter instead 
  *             of clock counter to generate callbacks.
@@ -36,9 +47,16 @@
 #include "coreservices/icmdexec.h"
 #include "coreservices/iirq.h"
 #include "cmds/cmd_br_riscv.h"
+#include "cmds/cmd_sample.h"
+#include "cmds/cmd_wave.h"
+#include "cmds/cmd_perf.h"
+#include "cmds/cmd_preload.h"
 #include "rtl_wrapper.h"
 #include "tap_bitbang.h"
 #include "bus_slv.h"
+#include "wave_trace.h"
+#include "rtl_perf.h"
+#include "rtl_halt.h"
 #include "ambalib/types_amba.h"
 #include "ambalib/axi2apb.h"
 #include "riverlib/workgroup.h"
@@ -58,6 +76,7 @@ class CpuRiscV_RTL : public IService,
     virtual void initService(const AttributeType *args) override;
     virtual void postinitService() override;
     virtual void predeleteService() override ;
+    virtual IAttribute *getAttribute(const char *name) override;
 
     /** IClock */
     virtual uint64_t getStepCounter() {
@@ -105,12 +124,28 @@ class CpuRiscV_RTL : public IService,
     AttributeType freqHz_;
     AttributeType InVcdFile_;
     AttributeType OutVcdFile_;
+    AttributeType fastForwardCpu_;
+    AttributeType jtag_;
+    AttributeType waveFile_;
+    AttributeType waveFilter_;
+    AttributeType waveStart_;
+    AttributeType waveStop_;
+    AttributeType waveTrigger_;
+    AttributeType waveTriggerValue_;
+    AttributeType waveLength_;
+    AttributeType perfCounters_;
+    AttributeType preloadFile_;
+    AttributeType preloadAddress_;
     event_def config_done_;
 
     IIrqController *iirqloc_;
     IIrqController *iirqext_;
     ICmdExecutor *icmdexec_;
     IMemoryOperation *ibus_;
+    CmdSample *pcmdSample_;
+    CmdWave *pcmdWave_;
+    CmdPerf *pcmdPerf_;
+    CmdPreload *pcmdPreload_;
 
     sc_signal<bool> w_clk;
     sc_signal<bool> w_sys_nrst;
@@ -150,6 +185,9 @@ class CpuRiscV_RTL : public IService,
 
     sc_trace_file *i_vcd_;      // stimulus pattern
     sc_trace_file *o_vcd_;      // reference pattern for comparision
+    WaveTraceFile *wave_;       // run-time controlled compact waveform
+    RtlPerfCounters *perf_;     // hardware performance counters
+    RtlHaltNotifier *haltntf_;  // pushes HAP_CpuHalted on haltsum change
     RtlWrapper *wrapper_;
     TapBitBang *tapbb_;
     BusSlave *dmislv_;
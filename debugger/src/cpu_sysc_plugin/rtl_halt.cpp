@@ -0,0 +1,76 @@
+/*
+ *  Copyright 2018 Sergey Khabarov, sergeykhbr@gmail.com
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include "rtl_halt.h"
+#include <string.h>
+
+namespace debugger {
+
+static const char *HALTED_SUFFIX = ".dmi0.i_halted";
+
+RtlHaltNotifier::RtlHaltNotifier(uint64_t hartbase) {
+    memset(&clk_, 0, sizeof(clk_));
+    memset(&halted_, 0, sizeof(halted_));
+    hartbase_ = hartbase;
+    haltsum_ = 0;
+    clkLevel_ = false;
+
+    sc_get_curr_simcontext()->add_trace_file(this);
+}
+
+void RtlHaltNotifier::addSignal(const void *obj, ESignalKind kind, int bits,
+                                const std::string &name) {
+    SignalType sig;
+    const char *s = name.c_str();
+    const char *dot = strchr(s, '.');
+    size_t len = strlen(s);
+    size_t sfx = strlen(HALTED_SUFFIX);
+    sig.obj = obj;
+    sig.kind = kind;
+    sig.bits = bits;
+    sig.nbytes = (bits + 7) / 8;
+    sig.offset = 0;
+
+    if (!clk_.obj && dot && strcmp(dot, ".i_clk") == 0) {
+        // Clock input of the top level module
+        clk_ = sig;
+    } else if (len > sfx && strcmp(&s[len - sfx], HALTED_SUFFIX) == 0) {
+        halted_ = sig;
+    }
+}
+
+void RtlHaltNotifier::cycle(bool delta_cycle) {
+    if (delta_cycle || !clk_.obj || !halted_.obj) {
+        return;
+    }
+    bool clk = sampleUInt64(&clk_) != 0;
+    bool posedge = clk && !clkLevel_;
+    clkLevel_ = clk;
+    if (!posedge) {
+        return;
+    }
+    uint64_t haltsum = sampleUInt64(&halted_);
+    uint64_t rise = haltsum & ~haltsum_;
+    haltsum_ = haltsum;
+    for (int i = 0; rise != 0 && i < CFG_CPU_MAX; i++, rise >>= 1) {
+        if (rise & 1) {
+            RISCV_trigger_hap(HAP_CpuHalted, hartbase_ + i,
+                              "DMI haltsum is set");
+        }
+    }
+}
+
+}  // namespace debugger
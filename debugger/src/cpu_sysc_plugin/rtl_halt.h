@@ -0,0 +1,52 @@
+/*
+ *  Copyright 2018 Sergey Khabarov, sergeykhbr@gmail.com
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#pragma once
+
+#include <api_core.h>
+#include <ihap.h>
+#include "signal_trace.h"
+#include "riverlib/river_cfg.h"
+
+namespace debugger {
+
+/**
+ * @brief Pushes HAP_CpuHalted when a bit of the DMI halt summary rises.
+ * @details Watches 'i_halted' input of the RTL debug module that forms
+ *          haltsum registers, so CpuMonitor restores breakpoints and
+ *          notifies run-control listeners without polling 'status' via DMI.
+ */
+class RtlHaltNotifier : public SignalTraceFile {
+ public:
+    explicit RtlHaltNotifier(uint64_t hartbase);
+    virtual ~RtlHaltNotifier() {}
+
+ protected:
+    /** Called by the SystemC kernel on each time step */
+    virtual void cycle(bool delta_cycle);
+    /** SignalTraceFile */
+    virtual void addSignal(const void *obj, ESignalKind kind, int bits,
+                           const std::string &name);
+
+ private:
+    SignalType clk_;
+    SignalType halted_;
+    uint64_t hartbase_;
+    uint64_t haltsum_;
+    bool clkLevel_;
+};
+
+}  // namespace debugger
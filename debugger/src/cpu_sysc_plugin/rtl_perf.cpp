@@ -0,0 +1,316 @@
+/*
+ *  Copyright 2018 Sergey Khabarov, sergeykhbr@gmail.com
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include "rtl_perf.h"
+#include <string.h>
+
+namespace debugger {
+
+/** Signal names relative to the RiverAmba instance 'cpux<N>' */
+static const char *CORE_PROBE_NAMES[] = {
+    "river0.cache0.i1.i_req_valid",
+    "river0.cache0.i1.o_req_ready",
+    "river0.cache0.i1.r_state",
+    "river0.cache0.d0.i_req_valid",
+    "river0.cache0.d0.o_req_ready",
+    "river0.cache0.d0.r_state",
+    "river0.cache0.d0.r_write_first",
+    "river0.proc0.immu0.r_state",
+    "river0.proc0.immu0.r_tlb_hit",
+    "river0.proc0.dmmu0.r_state",
+    "river0.proc0.dmmu0.r_tlb_hit",
+    "river0.proc0.predic0.i_e_jmp",
+    "river0.proc0.predic0.i_e_npc",
+    "river0.proc0.predic0.i_d_pc",
+    "river0.proc0.predic0.i_f_fetched_pc",
+    "river0.proc0.predic0.i_f_fetching_pc",
+    "river0.proc0.predic0.i_f_requested_pc",
+    "river0.proc0.exec0.r_state",
+    "river0.proc0.exec0.o_valid",
+};
+
+static const char *L2_PROBE_NAMES[] = {
+    "l2cache.cache0.i_req_valid",
+    "l2cache.cache0.o_req_ready",
+    "l2cache.cache0.r_state",
+    "l2cache.cache0.r_write_first",
+};
+
+static const char *CORE_COUNTER_NAMES[] = {
+    "Cycles",
+    "Instructions",
+    "L1I_Access",
+    "L1I_Miss",
+    "L1D_Access",
+    "L1D_Miss",
+    "L1D_Evict",
+    "ITLB_Hit",
+    "ITLB_Walk",
+    "DTLB_Hit",
+    "DTLB_Walk",
+    "Jumps",
+    "Mispredicts",
+    "Stall_NoInstr",
+    "Stall_Memory",
+    "Stall_MultiCycle",
+    "Stall_Csr",
+    "Stall_Amo",
+    "Wfi",
+    "Halted",
+};
+
+static const char *L2_COUNTER_NAMES[] = {
+    "L2_Access",
+    "L2_Miss",
+    "L2_Evict",
+};
+
+// State encoding of icache_lru, dcache_lru and l2cache_lru
+static const uint64_t CACHE_CheckHit = 1;
+static const uint64_t CACHE_TranslateAddress = 2;
+static const uint64_t CACHE_WaitGrant = 3;
+static const uint64_t CACHE_WriteBus = 7;
+// State encoding of mmu
+static const uint64_t MMU_WaitRespLast = 2;
+static const uint64_t MMU_CheckTlb = 3;
+static const uint64_t MMU_CacheReq = 4;
+// State encoding of execute
+static const uint64_t EXEC_Idle = 0;
+static const uint64_t EXEC_WaitMemAcces = 1;
+static const uint64_t EXEC_WaitMulti = 2;
+static const uint64_t EXEC_Amo = 5;
+static const uint64_t EXEC_Csr = 6;
+static const uint64_t EXEC_Halted = 7;
+static const uint64_t EXEC_Wfi = 0xf;
+
+RtlPerfCounters::RtlPerfCounters() {
+    memset(&clk_, 0, sizeof(clk_));
+    memset(core_, 0, sizeof(core_));
+    memset(l2_, 0, sizeof(l2_));
+    memset(prev_, 0, sizeof(prev_));
+    memset(cnt_, 0, sizeof(cnt_));
+    memset(l2cnt_, 0, sizeof(l2cnt_));
+    l2prev_ = 0;
+    clkLevel_ = false;
+    resetRequest_ = false;
+
+    sc_get_curr_simcontext()->add_trace_file(this);
+}
+
+void RtlPerfCounters::addSignal(const void *obj, ESignalKind kind, int bits,
+                                const std::string &name) {
+    SignalType sig;
+    const char *s = name.c_str();
+    const char *cpux = strstr(s, ".cpux");
+    const char *dot = strchr(s, '.');
+    sig.obj = obj;
+    sig.kind = kind;
+    sig.bits = bits;
+    sig.nbytes = (bits + 7) / 8;
+    sig.offset = 0;
+
+    if (!clk_.obj && dot && strcmp(dot, ".i_clk") == 0) {
+        // Clock input of the top level module
+        clk_ = sig;
+        return;
+    }
+
+    if (cpux) {
+        int idx = 0;
+        const char *rel = strchr(cpux + 1, '.');
+        RISCV_sscanf(cpux + 5, "%d", &idx);
+        if (!rel || idx < 0 || idx >= CFG_CPU_MAX) {
+            return;
+        }
+        for (int i = 0; i < CoreProbe_Total; i++) {
+            if (strcmp(rel + 1, CORE_PROBE_NAMES[i]) == 0) {
+                core_[idx][i] = sig;
+                return;
+            }
+        }
+        return;
+    }
+
+    size_t len = strlen(s);
+    for (int i = 0; i < L2Probe_Total; i++) {
+        size_t sfx = strlen(L2_PROBE_NAMES[i]);
+        if (len > sfx && s[len - sfx - 1] == '.'
+            && strcmp(&s[len - sfx], L2_PROBE_NAMES[i]) == 0) {
+            l2_[i] = sig;
+            return;
+        }
+    }
+}
+
+void RtlPerfCounters::getCounters(AttributeType *res) {
+    char tstr[64];
+    res->make_dict();
+    for (int n = 0; n < CFG_CPU_MAX; n++) {
+        if (!core_[n][Probe_Exec_State].obj) {
+            continue;
+        }
+        RISCV_sprintf(tstr, sizeof(tstr), "cpu%d", n);
+        AttributeType &core = (*res)[tstr];
+        core.make_dict();
+        for (int i = 0; i < CoreCounter_Total; i++) {
+            core[CORE_COUNTER_NAMES[i]].make_uint64(cnt_[n][i]);
+        }
+    }
+    if (l2_[Probe_L2_State].obj) {
+        AttributeType &l2 = (*res)["l2"];
+        l2.make_dict();
+        for (int i = 0; i < L2Counter_Total; i++) {
+            l2[L2_COUNTER_NAMES[i]].make_uint64(l2cnt_[i]);
+        }
+    }
+}
+
+void RtlPerfCounters::cacheCycle(SignalType *valid, SignalType *ready,
+                                 SignalType *state, SignalType *write_first,
+                                 uint64_t *prev_state, uint64_t *cnt_access,
+                                 uint64_t *cnt_miss, uint64_t *cnt_evict) {
+    if (!state->obj) {
+        return;
+    }
+    uint64_t st = sampleUInt64(state);
+    if (isHigh(valid) && isHigh(ready)) {
+        (*cnt_access)++;
+    }
+    if (*prev_state == CACHE_CheckHit && st == CACHE_TranslateAddress) {
+        (*cnt_miss)++;
+    }
+    if (cnt_evict && *prev_state == CACHE_WaitGrant && st == CACHE_WriteBus
+        && isHigh(write_first)) {
+        (*cnt_evict)++;
+    }
+    *prev_state = st;
+}
+
+void RtlPerfCounters::mmuCycle(SignalType *probe_state, SignalType *probe_hit,
+                               uint64_t *prev_state, uint64_t *cnt_hit,
+                               uint64_t *cnt_walk) {
+    if (!probe_state->obj) {
+        return;
+    }
+    uint64_t st = sampleUInt64(probe_state);
+    if (st == MMU_WaitRespLast && *prev_state != MMU_WaitRespLast) {
+        // The same page as the last translated one
+        (*cnt_hit)++;
+    } else if (*prev_state == MMU_CheckTlb && st == MMU_CacheReq) {
+        if (isHigh(probe_hit)) {
+            (*cnt_hit)++;
+        } else {
+            (*cnt_walk)++;
+        }
+    }
+    *prev_state = st;
+}
+
+void RtlPerfCounters::coreCycle(int idx) {
+    SignalType *p = core_[idx];
+    uint64_t *cnt = cnt_[idx];
+    CoreStateType *prev = &prev_[idx];
+
+    cnt[Cnt_Cycles]++;
+    cacheCycle(&p[Probe_L1I_ReqValid], &p[Probe_L1I_ReqReady],
+               &p[Probe_L1I_State], 0, &prev->l1i_state,
+               &cnt[Cnt_L1I_Access], &cnt[Cnt_L1I_Miss], 0);
+    cacheCycle(&p[Probe_L1D_ReqValid], &p[Probe_L1D_ReqReady],
+               &p[Probe_L1D_State], &p[Probe_L1D_WriteFirst],
+               &prev->l1d_state, &cnt[Cnt_L1D_Access], &cnt[Cnt_L1D_Miss],
+               &cnt[Cnt_L1D_Evict]);
+    mmuCycle(&p[Probe_IMmu_State], &p[Probe_IMmu_TlbHit], &prev->immu_state,
+             &cnt[Cnt_ITlb_Hit], &cnt[Cnt_ITlb_Walk]);
+    mmuCycle(&p[Probe_DMmu_State], &p[Probe_DMmu_TlbHit], &prev->dmmu_state,
+             &cnt[Cnt_DTlb_Hit], &cnt[Cnt_DTlb_Walk]);
+
+    if (isHigh(&p[Probe_Bp_Jmp])) {
+        // Misprediction: jump target isn't in the fetch pipeline
+        uint64_t npc = sampleUInt64(&p[Probe_Bp_Npc]) >> 2;
+        bool predicted = false;
+        for (int i = Probe_Bp_DPc; i <= Probe_Bp_RequestedPc; i++) {
+            if (p[i].obj && (sampleUInt64(&p[i]) >> 2) == npc) {
+                predicted = true;
+            }
+        }
+        cnt[Cnt_Jumps]++;
+        if (!predicted) {
+            cnt[Cnt_Mispredict]++;
+        }
+    }
+
+    if (isHigh(&p[Probe_Exec_Valid])) {
+        cnt[Cnt_Instructions]++;
+    }
+    switch (sampleUInt64(&p[Probe_Exec_State])) {
+    case EXEC_Idle:
+        if (!isHigh(&p[Probe_Exec_Valid])) {
+            cnt[Cnt_Stall_NoInstr]++;
+        }
+        break;
+    case EXEC_WaitMemAcces:
+        cnt[Cnt_Stall_Memory]++;
+        break;
+    case EXEC_WaitMulti:
+        cnt[Cnt_Stall_MultiCycle]++;
+        break;
+    case EXEC_Amo:
+        cnt[Cnt_Stall_Amo]++;
+        break;
+    case EXEC_Csr:
+        cnt[Cnt_Stall_Csr]++;
+        break;
+    case EXEC_Halted:
+        cnt[Cnt_Halted]++;
+        break;
+    case EXEC_Wfi:
+        cnt[Cnt_Wfi]++;
+        break;
+    default:;
+    }
+}
+
+void RtlPerfCounters::l2Cycle() {
+    cacheCycle(&l2_[Probe_L2_ReqValid], &l2_[Probe_L2_ReqReady],
+               &l2_[Probe_L2_State], &l2_[Probe_L2_WriteFirst], &l2prev_,
+               &l2cnt_[Cnt_L2_Access], &l2cnt_[Cnt_L2_Miss],
+               &l2cnt_[Cnt_L2_Evict]);
+}
+
+void RtlPerfCounters::cycle(bool delta_cycle) {
+    if (delta_cycle || !clk_.obj) {
+        return;
+    }
+    bool clk = isHigh(&clk_);
+    bool posedge = clk && !clkLevel_;
+    clkLevel_ = clk;
+    if (!posedge) {
+        return;
+    }
+    if (resetRequest_) {
+        resetRequest_ = false;
+        memset(cnt_, 0, sizeof(cnt_));
+        memset(l2cnt_, 0, sizeof(l2cnt_));
+    }
+    for (int i = 0; i < CFG_CPU_MAX; i++) {
+        if (core_[i][Probe_Exec_State].obj) {
+            coreCycle(i);
+        }
+    }
+    l2Cycle();
+}
+
+}  // namespace debugger
@@ -0,0 +1,147 @@
+/*
+ *  Copyright 2018 Sergey Khabarov, sergeykhbr@gmail.com
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#pragma once
+
+#include <api_core.h>
+#include <attribute.h>
+#include "signal_trace.h"
+#include "riverlib/river_cfg.h"
+
+namespace debugger {
+
+/**
+ * @brief Hardware performance counters of the River RTL model.
+ * @details Counters are computed on each rising edge of the workgroup clock
+ *          from the state registers and handshake ports that each module
+ *          exposes via generateVCD(), so RTL sources stay untouched:
+ *             - L1I/L1D/L2 accesses, misses and dirty line evictions;
+ *             - I/D MMU TLB hits and page table walks;
+ *             - executed jumps and mispredictions (jump target is absent
+ *               in the fetch pipeline);
+ *             - execution stage stall cycles by cause.
+ */
+class RtlPerfCounters : public SignalTraceFile {
+ public:
+    RtlPerfCounters();
+    virtual ~RtlPerfCounters() {}
+
+    void getCounters(AttributeType *res);
+    void reset() { resetRequest_ = true; }
+
+ protected:
+    /** Called by the SystemC kernel on each time step */
+    virtual void cycle(bool delta_cycle);
+    /** SignalTraceFile */
+    virtual void addSignal(const void *obj, ESignalKind kind, int bits,
+                           const std::string &name);
+
+ private:
+    enum ECoreProbe {
+        Probe_L1I_ReqValid,
+        Probe_L1I_ReqReady,
+        Probe_L1I_State,
+        Probe_L1D_ReqValid,
+        Probe_L1D_ReqReady,
+        Probe_L1D_State,
+        Probe_L1D_WriteFirst,
+        Probe_IMmu_State,
+        Probe_IMmu_TlbHit,
+        Probe_DMmu_State,
+        Probe_DMmu_TlbHit,
+        Probe_Bp_Jmp,
+        Probe_Bp_Npc,
+        Probe_Bp_DPc,
+        Probe_Bp_FetchedPc,
+        Probe_Bp_FetchingPc,
+        Probe_Bp_RequestedPc,
+        Probe_Exec_State,
+        Probe_Exec_Valid,
+        CoreProbe_Total
+    };
+
+    enum EL2Probe {
+        Probe_L2_ReqValid,
+        Probe_L2_ReqReady,
+        Probe_L2_State,
+        Probe_L2_WriteFirst,
+        L2Probe_Total
+    };
+
+    enum ECoreCounter {
+        Cnt_Cycles,
+        Cnt_Instructions,
+        Cnt_L1I_Access,
+        Cnt_L1I_Miss,
+        Cnt_L1D_Access,
+        Cnt_L1D_Miss,
+        Cnt_L1D_Evict,
+        Cnt_ITlb_Hit,
+        Cnt_ITlb_Walk,
+        Cnt_DTlb_Hit,
+        Cnt_DTlb_Walk,
+        Cnt_Jumps,
+        Cnt_Mispredict,
+        Cnt_Stall_NoInstr,
+        Cnt_Stall_Memory,
+        Cnt_Stall_MultiCycle,
+        Cnt_Stall_Csr,
+        Cnt_Stall_Amo,
+        Cnt_Wfi,
+        Cnt_Halted,
+        CoreCounter_Total
+    };
+
+    enum EL2Counter {
+        Cnt_L2_Access,
+        Cnt_L2_Miss,
+        Cnt_L2_Evict,
+        L2Counter_Total
+    };
+
+    struct CoreStateType {
+        uint64_t l1i_state;
+        uint64_t l1d_state;
+        uint64_t immu_state;
+        uint64_t dmmu_state;
+    };
+
+    void cacheCycle(SignalType *valid, SignalType *ready, SignalType *state,
+                    SignalType *write_first, uint64_t *prev_state,
+                    uint64_t *cnt_access, uint64_t *cnt_miss,
+                    uint64_t *cnt_evict);
+    void mmuCycle(SignalType *probe_state, SignalType *probe_hit,
+                  uint64_t *prev_state, uint64_t *cnt_hit,
+                  uint64_t *cnt_walk);
+    void coreCycle(int idx);
+    void l2Cycle();
+    bool isHigh(SignalType *sig) {
+        return sig->obj && sampleUInt64(sig) != 0;
+    }
+
+ private:
+    SignalType clk_;
+    SignalType core_[CFG_CPU_MAX][CoreProbe_Total];
+    SignalType l2_[L2Probe_Total];
+    CoreStateType prev_[CFG_CPU_MAX];
+    uint64_t l2prev_;
+    uint64_t cnt_[CFG_CPU_MAX][CoreCounter_Total];
+    uint64_t l2cnt_[L2Counter_Total];
+    bool clkLevel_;
+    volatile bool resetRequest_;
+};
+
+}  // namespace debugger
@@ -58,6 +58,8 @@ RtlWrapper::RtlWrapper(IFace *parent, sc_module_name name) : sc_module(name),
     w_seip = 0;
     iirqloc_ = 0;
     iirqext_ = 0;
+    ibus_ = 0;
+    memset(dmi_, 0, sizeof(dmi_));
 
     SC_METHOD(comb);
     sensitive << w_interrupt;
@@ -303,6 +305,7 @@ void RtlWrapper::sys_bus_proc() {
     w_w_error = 0;
 
     uint64_t toff;
+    uint8_t *phost;
     switch (r.state.read()) {
     case State_Read:
         trans.action = MemAction_Read;
@@ -310,7 +313,13 @@ void RtlWrapper::sys_bus_proc() {
         trans.xsize = 8;
         trans.wstrb = 0;
         trans.wpayload.b64[0] = 0;
-        resp = ibus_->b_transport(&trans);
+        phost = getDirectPointer(MemAction_Read, trans.addr, trans.xsize);
+        if (phost) {
+            memcpy(trans.rpayload.b8, phost, trans.xsize);
+            resp = TRANS_OK;
+        } else {
+            resp = ibus_->b_transport(&trans);
+        }
 
         w_resp_valid = 1;
         toff = r.req_addr.read()(CFG_LOG2_SYSBUS_DATA_BYTES - 1, 0);
@@ -330,7 +339,13 @@ void RtlWrapper::sys_bus_proc() {
         trans.xsize = mask2size(strob >> offset);
         trans.wstrb = (1 << trans.xsize) - 1;
         trans.wpayload.b64[0] = wb_wdata.read() >> (8*offset);
-        resp = ibus_->b_transport(&trans);
+        phost = getDirectPointer(MemAction_Write, trans.addr, trans.xsize);
+        if (phost) {
+            memcpy(phost, trans.wpayload.b8, trans.xsize);
+            resp = TRANS_OK;
+        } else {
+            resp = ibus_->b_transport(&trans);
+        }
 
         w_resp_valid = 1;
         if (resp == TRANS_ERROR) {
@@ -363,6 +378,24 @@ uint32_t RtlWrapper::mask2size(uint8_t mask) {
     return bytes;
 }
 
+uint8_t *RtlWrapper::getDirectPointer(EAxi4Action action, uint64_t addr,
+                                      uint32_t sz) {
+    DirectRegionType *p = &dmi_[action];
+    if (p->ptr && addr >= p->addr && (addr + sz) <= (p->addr + p->size)) {
+        return &p->ptr[addr - p->addr];
+    }
+    // New region is requested once per burst or even less often
+    uint64_t avail = 0;
+    uint8_t *ptr = ibus_->getHostPointer(addr, action, &avail);
+    if (!ptr || avail < sz) {
+        return 0;
+    }
+    p->addr = addr;
+    p->size = avail;
+    p->ptr = ptr;
+    return ptr;
+}
+
 void RtlWrapper::setClockHz(double hz) {
     sc_time dt = sc_get_time_resolution();
     clockCycles_ = static_cast<int>((1.0 / hz) / dt.to_seconds() + 0.5);
@@ -139,6 +139,7 @@ class RtlWrapper : public sc_module,
     IFace *getInterface(const char *name) { return iparent_; }
     uint64_t mask2offset(uint8_t mask);
     uint32_t mask2size(uint8_t mask);       // nask with removed offset
+    uint8_t *getDirectPointer(EAxi4Action action, uint64_t addr, uint32_t sz);
 
  private:
     IIrqController *iirqloc_;
@@ -148,6 +149,14 @@ class RtlWrapper : public sc_module,
     int clockCycles_;   // default in [ps]
     ClockAsyncTQueueType step_queue_;
 
+    /** Last host memory region returned by the bus for direct access, so
+        that burst beats are served without bus map lookups and locking */
+    struct DirectRegionType {
+        uint64_t addr;
+        uint64_t size;
+        uint8_t *ptr;
+    } dmi_[MemAction_Total];
+
     sc_uint<32> t_trans_idx_up;
     sc_uint<32> t_trans_idx_down;
 };
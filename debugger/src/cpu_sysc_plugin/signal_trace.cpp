@@ -0,0 +1,236 @@
+/*
+ *  Copyright 2018 Sergey Khabarov, sergeykhbr@gmail.com
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include "signal_trace.h"
+#include <string.h>
+
+namespace debugger {
+
+void SignalTraceFile::trace(const bool &object, const std::string &name) {
+    addSignal(&object, Kind_Bool, 1, name);
+}
+
+void SignalTraceFile::trace(const sc_dt::sc_bit &object,
+                            const std::string &name) {
+    addSignal(&object, Kind_Bit, 1, name);
+}
+
+void SignalTraceFile::trace(const sc_dt::sc_logic &object,
+                            const std::string &name) {
+    addSignal(&object, Kind_Logic, 2, name);
+}
+
+void SignalTraceFile::trace(const unsigned char &object,
+                            const std::string &name, int width) {
+    addSignal(&object, Kind_UChar, width, name);
+}
+
+void SignalTraceFile::trace(const unsigned short &object,
+                            const std::string &name, int width) {
+    addSignal(&object, Kind_UShort, width, name);
+}
+
+void SignalTraceFile::trace(const unsigned int &object,
+                            const std::string &name, int width) {
+    addSignal(&object, Kind_UInt, width, name);
+}
+
+void SignalTraceFile::trace(const unsigned long &object,
+                            const std::string &name, int width) {
+    addSignal(&object, Kind_ULong, width, name);
+}
+
+void SignalTraceFile::trace(const char &object,
+                            const std::string &name, int width) {
+    addSignal(&object, Kind_UChar, width, name);
+}
+
+void SignalTraceFile::trace(const short &object,
+                            const std::string &name, int width) {
+    addSignal(&object, Kind_UShort, width, name);
+}
+
+void SignalTraceFile::trace(const int &object,
+                            const std::string &name, int width) {
+    addSignal(&object, Kind_UInt, width, name);
+}
+
+void SignalTraceFile::trace(const long &object,
+                            const std::string &name, int width) {
+    addSignal(&object, Kind_ULong, width, name);
+}
+
+void SignalTraceFile::trace(const sc_dt::int64 &object,
+                            const std::string &name, int width) {
+    addSignal(&object, Kind_UInt64, width, name);
+}
+
+void SignalTraceFile::trace(const sc_dt::uint64 &object,
+                            const std::string &name, int width) {
+    addSignal(&object, Kind_UInt64, width, name);
+}
+
+void SignalTraceFile::trace(const float &object, const std::string &name) {
+    addSignal(&object, Kind_Float, 32, name);
+}
+
+void SignalTraceFile::trace(const double &object, const std::string &name) {
+    addSignal(&object, Kind_Double, 64, name);
+}
+
+void SignalTraceFile::trace(const sc_dt::sc_int_base &object,
+                            const std::string &name) {
+    addSignal(&object, Kind_IntBase, object.length(), name);
+}
+
+void SignalTraceFile::trace(const sc_dt::sc_uint_base &object,
+                            const std::string &name) {
+    addSignal(&object, Kind_UIntBase, object.length(), name);
+}
+
+void SignalTraceFile::trace(const sc_dt::sc_signed &object,
+                            const std::string &name) {
+    addSignal(&object, Kind_Signed, object.length(), name);
+}
+
+void SignalTraceFile::trace(const sc_dt::sc_unsigned &object,
+                            const std::string &name) {
+    addSignal(&object, Kind_Unsigned, object.length(), name);
+}
+
+void SignalTraceFile::trace(const sc_dt::sc_bv_base &object,
+                            const std::string &name) {
+    addSignal(&object, Kind_BvBase, object.length(), name);
+}
+
+void SignalTraceFile::trace(const sc_dt::sc_lv_base &object,
+                            const std::string &name) {
+    // X and Z states are not stored, only the data plane
+    addSignal(&object, Kind_LvBase, object.length(), name);
+}
+
+void SignalTraceFile::trace(const unsigned int &object,
+                            const std::string &name,
+                            const char **enum_literals) {
+    addSignal(&object, Kind_UInt, 32, name);
+}
+
+static void put_le(uint8_t *out, uint64_t v, int nbytes) {
+    for (int i = 0; i < nbytes && i < 8; i++) {
+        out[i] = static_cast<uint8_t>(v >> (8 * i));
+    }
+}
+
+void SignalTraceFile::sample(const SignalType *sig, uint8_t *out) {
+    uint64_t v = 0;
+    memset(out, 0, sig->nbytes);
+    switch (sig->kind) {
+    case Kind_Bool:
+        v = *static_cast<const bool *>(sig->obj) ? 1 : 0;
+        break;
+    case Kind_Bit:
+        v = static_cast<const sc_dt::sc_bit *>(sig->obj)->to_bool();
+        break;
+    case Kind_Logic:
+        v = static_cast<const sc_dt::sc_logic *>(sig->obj)->value();
+        break;
+    case Kind_UChar:
+        v = *static_cast<const uint8_t *>(sig->obj);
+        break;
+    case Kind_UShort:
+        v = *static_cast<const uint16_t *>(sig->obj);
+        break;
+    case Kind_UInt:
+        v = *static_cast<const uint32_t *>(sig->obj);
+        break;
+    case Kind_ULong:
+        v = *static_cast<const unsigned long *>(sig->obj);
+        break;
+    case Kind_UInt64:
+        v = *static_cast<const uint64_t *>(sig->obj);
+        break;
+    case Kind_Float:
+        memcpy(out, sig->obj, sizeof(float));
+        return;
+    case Kind_Double:
+        memcpy(out, sig->obj, sizeof(double));
+        return;
+    case Kind_IntBase:
+        v = static_cast<const sc_dt::sc_int_base *>(sig->obj)->value();
+        break;
+    case Kind_UIntBase:
+        v = static_cast<const sc_dt::sc_uint_base *>(sig->obj)->value();
+        break;
+    case Kind_Signed: {
+        const sc_dt::sc_signed *p =
+            static_cast<const sc_dt::sc_signed *>(sig->obj);
+        for (int i = 0; i < sig->bits; i++) {
+            if (p->test(i)) {
+                out[i >> 3] |= static_cast<uint8_t>(1 << (i & 0x7));
+            }
+        }
+        return;
+    }
+    case Kind_Unsigned: {
+        const sc_dt::sc_unsigned *p =
+            static_cast<const sc_dt::sc_unsigned *>(sig->obj);
+        for (int i = 0; i < sig->bits; i++) {
+            if (p->test(i)) {
+                out[i >> 3] |= static_cast<uint8_t>(1 << (i & 0x7));
+            }
+        }
+        return;
+    }
+    case Kind_BvBase:
+    case Kind_LvBase: {
+        int words = (sig->bits + 31) / 32;
+        for (int i = 0; i < words; i++) {
+            uint32_t w;
+            if (sig->kind == Kind_BvBase) {
+                w = static_cast<const sc_dt::sc_bv_base *>(
+                    sig->obj)->get_word(i);
+            } else {
+                w = static_cast<const sc_dt::sc_lv_base *>(
+                    sig->obj)->get_word(i);
+            }
+            int nb = sig->nbytes - 4 * i;
+            put_le(&out[4 * i], w, nb < 4 ? nb : 4);
+        }
+        return;
+    }
+    default:;
+    }
+    put_le(out, v, sig->nbytes);
+}
+
+uint64_t SignalTraceFile::sampleUInt64(const SignalType *sig) {
+    uint8_t buf[8];
+    uint64_t v = 0;
+    if (sig->nbytes > 8) {
+        uint8_t *tbuf = new uint8_t[sig->nbytes];
+        sample(sig, tbuf);
+        memcpy(buf, tbuf, 8);
+        delete [] tbuf;
+    } else {
+        sample(sig, buf);
+    }
+    for (int i = 0; i < sig->nbytes && i < 8; i++) {
+        v |= static_cast<uint64_t>(buf[i]) << (8 * i);
+    }
+    return v;
+}
+
+}  // namespace debugger
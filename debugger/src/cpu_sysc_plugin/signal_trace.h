@@ -0,0 +1,126 @@
+/*
+ *  Copyright 2018 Sergey Khabarov, sergeykhbr@gmail.com
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#pragma once
+
+#include <api_core.h>
+#include <systemc.h>
+
+namespace debugger {
+
+/**
+ * @brief Base class for trace files that capture signal references.
+ * @details Implements every sc_trace() overload and passes the reference
+ *          on the traced value into addSignal(). Derived classes select
+ *          signals by hierarchical name and read their values in cycle()
+ *          that is called by the SystemC kernel on each time step.
+ */
+class SignalTraceFile : public sc_trace_file {
+ public:
+    /** sc_trace_file interface */
+    virtual void trace(const bool &object, const std::string &name);
+    virtual void trace(const sc_dt::sc_bit &object, const std::string &name);
+    virtual void trace(const sc_dt::sc_logic &object,
+                       const std::string &name);
+    virtual void trace(const unsigned char &object,
+                       const std::string &name, int width);
+    virtual void trace(const unsigned short &object,
+                       const std::string &name, int width);
+    virtual void trace(const unsigned int &object,
+                       const std::string &name, int width);
+    virtual void trace(const unsigned long &object,
+                       const std::string &name, int width);
+    virtual void trace(const char &object,
+                       const std::string &name, int width);
+    virtual void trace(const short &object,
+                       const std::string &name, int width);
+    virtual void trace(const int &object,
+                       const std::string &name, int width);
+    virtual void trace(const long &object,
+                       const std::string &name, int width);
+    virtual void trace(const sc_dt::int64 &object,
+                       const std::string &name, int width);
+    virtual void trace(const sc_dt::uint64 &object,
+                       const std::string &name, int width);
+    virtual void trace(const float &object, const std::string &name);
+    virtual void trace(const double &object, const std::string &name);
+    virtual void trace(const sc_dt::sc_int_base &object,
+                       const std::string &name);
+    virtual void trace(const sc_dt::sc_uint_base &object,
+                       const std::string &name);
+    virtual void trace(const sc_dt::sc_signed &object,
+                       const std::string &name);
+    virtual void trace(const sc_dt::sc_unsigned &object,
+                       const std::string &name);
+    virtual void trace(const sc_dt::sc_fxval &object,
+                       const std::string &name) {}
+    virtual void trace(const sc_dt::sc_fxval_fast &object,
+                       const std::string &name) {}
+    virtual void trace(const sc_dt::sc_fxnum &object,
+                       const std::string &name) {}
+    virtual void trace(const sc_dt::sc_fxnum_fast &object,
+                       const std::string &name) {}
+    virtual void trace(const sc_dt::sc_bv_base &object,
+                       const std::string &name);
+    virtual void trace(const sc_dt::sc_lv_base &object,
+                       const std::string &name);
+    virtual void trace(const unsigned int &object, const std::string &name,
+                       const char **enum_literals);
+#if SYSTEMC_VERSION >= 20171012
+    virtual void trace(const sc_event &object, const std::string &name) {}
+    virtual void trace(const sc_time &object, const std::string &name) {}
+#endif
+    virtual void write_comment(const std::string &comment) {}
+    virtual void set_time_unit(double v, sc_time_unit tu) {}
+
+ protected:
+    enum ESignalKind {
+        Kind_Bool,
+        Kind_Bit,
+        Kind_Logic,
+        Kind_UChar,
+        Kind_UShort,
+        Kind_UInt,
+        Kind_ULong,
+        Kind_UInt64,
+        Kind_Float,
+        Kind_Double,
+        Kind_IntBase,
+        Kind_UIntBase,
+        Kind_Signed,
+        Kind_Unsigned,
+        Kind_BvBase,
+        Kind_LvBase,
+    };
+
+    struct SignalType {
+        const void *obj;
+        ESignalKind kind;
+        int bits;
+        int nbytes;
+        int offset;     // free for use by derived class
+    };
+
+    virtual void addSignal(const void *obj, ESignalKind kind, int bits,
+                           const std::string &name) = 0;
+
+    /** Write value as little-endian array of (bits + 7) / 8 bytes */
+    void sample(const SignalType *sig, uint8_t *out);
+    /** Low 64 bits of the value */
+    uint64_t sampleUInt64(const SignalType *sig);
+};
+
+}  // namespace debugger
@@ -0,0 +1,254 @@
+/*
+ *  Copyright 2018 Sergey Khabarov, sergeykhbr@gmail.com
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include "wave_trace.h"
+#include <string.h>
+
+namespace debugger {
+
+static const char WAVE_MAGIC[8] = {'R', 'V', 'W', 'A', 'V', 'E', '1', '\n'};
+static const int WAVE_FILE_BUFFER = 1 << 20;
+
+WaveTraceFile::WaveTraceFile(const char *filename,
+                             const AttributeType *filter) {
+    fd_ = fopen(filename, "wb");
+    if (fd_) {
+        setvbuf(fd_, 0, _IOFBF, WAVE_FILE_BUFFER);
+    }
+    filter_ = *filter;
+    names_.make_list(0);
+    sigmax_ = 256;
+    sigcnt_ = 0;
+    sigs_ = new SignalType[sigmax_];
+    snapshot_ = 0;
+    tmpval_ = 0;
+    snapsize_ = 0;
+    headerDone_ = false;
+
+    period_ = 0;
+    tstart_ = 0;
+    tstop_ = 0;
+    memset(&trig_, 0, sizeof(trig_));
+    trigValue_ = 0;
+    trigLength_ = 0;
+    trigName_.make_string("");
+
+    enaRequest_ = false;
+    disRequest_ = false;
+    enabled_ = false;
+    tlast_ = 0;
+    written_ = 0;
+
+    sc_get_curr_simcontext()->add_trace_file(this);
+}
+
+WaveTraceFile::~WaveTraceFile() {
+    close();
+    delete [] sigs_;
+    if (snapshot_) {
+        delete [] snapshot_;
+        delete [] tmpval_;
+    }
+}
+
+void WaveTraceFile::close() {
+    if (!fd_) {
+        return;
+    }
+    fclose(fd_);
+    fd_ = 0;
+}
+
+void WaveTraceFile::setWindow(uint64_t period, uint64_t start,
+                              uint64_t stop) {
+    period_ = period;
+    tstart_ = start * period;
+    tstop_ = stop * period;
+}
+
+void WaveTraceFile::setTrigger(const char *signame, uint64_t value,
+                               uint64_t length) {
+    trigName_.make_string(signame);
+    trigValue_ = value;
+    trigLength_ = length;
+}
+
+bool WaveTraceFile::isFiltered(const std::string &name) {
+    if (filter_.size() == 0) {
+        return true;
+    }
+    for (unsigned i = 0; i < filter_.size(); i++) {
+        if (name.find(filter_[i].to_string()) != std::string::npos) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void WaveTraceFile::addSignal(const void *obj, ESignalKind kind, int bits,
+                              const std::string &name) {
+    SignalType sig;
+    if (headerDone_ || bits <= 0) {
+        return;
+    }
+    sig.obj = obj;
+    sig.kind = kind;
+    sig.bits = bits;
+    sig.nbytes = (bits + 7) / 8;
+    sig.offset = 0;
+
+    if (trigName_.size() && !trig_.obj && trigName_.is_equal(name.c_str())) {
+        trig_ = sig;
+    }
+    if (!isFiltered(name)) {
+        return;
+    }
+
+    if (sigcnt_ == sigmax_) {
+        SignalType *t = new SignalType[2 * sigmax_];
+        memcpy(t, sigs_, sigmax_ * sizeof(SignalType));
+        delete [] sigs_;
+        sigs_ = t;
+        sigmax_ *= 2;
+    }
+    sig.offset = snapsize_;
+    snapsize_ += sig.nbytes;
+    sigs_[sigcnt_++] = sig;
+
+    AttributeType item;
+    item.make_string(name.c_str());
+    names_.add_to_list(&item);
+}
+
+void WaveTraceFile::writeVarint(uint64_t v) {
+    uint8_t buf[10];
+    int sz = 0;
+    do {
+        buf[sz] = static_cast<uint8_t>(v & 0x7F);
+        v >>= 7;
+        if (v) {
+            buf[sz] |= 0x80;
+        }
+        sz++;
+    } while (v);
+    fwrite(buf, 1, sz, fd_);
+    written_ += sz;
+}
+
+void WaveTraceFile::writeHeader() {
+    uint64_t resolution = static_cast<uint64_t>(
+        sc_get_time_resolution().to_seconds() * 1e15 + 0.5);
+    uint32_t cnt = static_cast<uint32_t>(sigcnt_);
+
+    headerDone_ = true;
+    snapshot_ = new uint8_t[snapsize_ + 1];
+    tmpval_ = new uint8_t[snapsize_ + 1];
+    memset(snapshot_, 0, snapsize_ + 1);
+
+    fwrite(WAVE_MAGIC, 1, sizeof(WAVE_MAGIC), fd_);
+    fwrite(&resolution, 1, sizeof(resolution), fd_);
+    fwrite(&cnt, 1, sizeof(cnt), fd_);
+    written_ += sizeof(WAVE_MAGIC) + sizeof(resolution) + sizeof(cnt);
+    for (int i = 0; i < sigcnt_; i++) {
+        uint32_t bits = static_cast<uint32_t>(sigs_[i].bits);
+        uint16_t len = static_cast<uint16_t>(names_[i].size());
+        fwrite(&bits, 1, sizeof(bits), fd_);
+        fwrite(&len, 1, sizeof(len), fd_);
+        fwrite(names_[i].to_string(), 1, len, fd_);
+        written_ += sizeof(bits) + sizeof(len) + len;
+    }
+    names_.make_list(0);
+}
+
+void WaveTraceFile::writeRecord(uint64_t t, bool full) {
+    bool changed = false;
+    for (int i = 0; i < sigcnt_; i++) {
+        SignalType *sig = &sigs_[i];
+        sample(sig, tmpval_);
+        if (!full && memcmp(tmpval_, &snapshot_[sig->offset],
+                            sig->nbytes) == 0) {
+            continue;
+        }
+        if (!changed) {
+            writeVarint(t - tlast_);
+            tlast_ = t;
+            changed = true;
+        }
+        memcpy(&snapshot_[sig->offset], tmpval_, sig->nbytes);
+        writeVarint(static_cast<uint64_t>(i) + 1);
+        fwrite(tmpval_, 1, sig->nbytes, fd_);
+        written_ += sig->nbytes;
+    }
+    if (changed) {
+        writeVarint(0);
+    }
+}
+
+void WaveTraceFile::cycle(bool delta_cycle) {
+    if (delta_cycle || !fd_) {
+        return;
+    }
+    if (!headerDone_) {
+        writeHeader();
+    }
+    uint64_t t = sc_time_stamp().value();
+    bool open = enabled_;
+
+    if (period_ && tstart_ != tstop_) {
+        if (t >= tstart_ && (t < tstop_ || tstop_ == 0)) {
+            open = true;
+        } else if (tstop_ && t >= tstop_) {
+            // Range passed: close once and allow other controls later
+            open = false;
+            tstart_ = tstop_ = 0;
+        }
+    }
+
+    if (trig_.obj) {
+        if (sampleUInt64(&trig_) == trigValue_) {
+            // Single shot trigger
+            trig_.obj = 0;
+            open = true;
+            if (trigLength_ && period_) {
+                tstart_ = t;
+                tstop_ = t + trigLength_ * period_;
+            }
+        }
+    }
+
+    if (enaRequest_) {
+        enaRequest_ = false;
+        open = true;
+    }
+    if (disRequest_) {
+        disRequest_ = false;
+        open = false;
+        tstart_ = tstop_ = 0;
+    }
+
+    if (open) {
+        writeRecord(t, !enabled_);
+        enabled_ = true;
+    } else if (enabled_) {
+        // End of window marker: time delta with empty change list
+        writeVarint(t - tlast_);
+        writeVarint(0);
+        tlast_ = t;
+        enabled_ = false;
+    }
+}
+
+}  // namespace debugger
@@ -0,0 +1,103 @@
+/*
+ *  Copyright 2018 Sergey Khabarov, sergeykhbr@gmail.com
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#pragma once
+
+#include <api_core.h>
+#include <attribute.h>
+#include <stdio.h>
+#include "signal_trace.h"
+
+namespace debugger {
+
+/**
+ * @brief Compact binary waveform writer controlled at run time.
+ * @details Only signals whose hierarchical name contains one of the filter
+ *          strings are registered, all others are dropped at sc_trace()
+ *          time and cost nothing during simulation. Values are written
+ *          only while the capture window is open:
+ *             - cycle range [start, stop);
+ *             - trigger signal equals to the specified value (for example
+ *               "group0.cpux0.proc0.exec0.r_pc"), then for <length> cycles;
+ *             - explicit enable()/disable() from the debugger command.
+ *
+ * File format (little-endian, decode with scripts/wave2vcd.py):
+ *     "RVWAVE1\n"
+ *     u64 time resolution in fs
+ *     u32 number of signals, then for each: u32 bits, u16 len, name[len]
+ *     records: varint time delta, {varint (idx + 1), value bytes}, varint 0
+ *
+ *     The first record of each window contains all signals, next records
+ *     only the changed ones. A record with an empty change list marks the
+ *     end of the window.
+ */
+class WaveTraceFile : public SignalTraceFile {
+ public:
+    WaveTraceFile(const char *filename, const AttributeType *filter);
+    virtual ~WaveTraceFile();
+
+    bool isOpened() { return fd_ != 0; }
+    /** Window in clock cycles, stop = 0 means endless window */
+    void setWindow(uint64_t period, uint64_t start, uint64_t stop);
+    void setTrigger(const char *signame, uint64_t value, uint64_t length);
+    void enable() { enaRequest_ = true; }
+    void disable() { disRequest_ = true; }
+    bool isEnabled() { return enabled_; }
+    uint64_t getSignalsTotal() { return sigcnt_; }
+    uint64_t getBytesWritten() { return written_; }
+    void close();
+
+ protected:
+    /** Called by the SystemC kernel on each time step */
+    virtual void cycle(bool delta_cycle);
+    /** SignalTraceFile */
+    virtual void addSignal(const void *obj, ESignalKind kind, int bits,
+                           const std::string &name);
+
+ private:
+    bool isFiltered(const std::string &name);
+    void writeHeader();
+    void writeVarint(uint64_t v);
+    void writeRecord(uint64_t t, bool full);
+
+ private:
+    FILE *fd_;
+    AttributeType filter_;
+    AttributeType names_;
+    SignalType *sigs_;
+    int sigcnt_;
+    int sigmax_;
+    uint8_t *snapshot_;
+    uint8_t *tmpval_;
+    int snapsize_;
+    bool headerDone_;
+
+    uint64_t period_;
+    uint64_t tstart_;
+    uint64_t tstop_;
+    SignalType trig_;
+    uint64_t trigValue_;
+    uint64_t trigLength_;
+    AttributeType trigName_;
+
+    volatile bool enaRequest_;
+    volatile bool disRequest_;
+    volatile bool enabled_;
+    uint64_t tlast_;
+    uint64_t written_;
+};
+
+}  // namespace debugger
@@ -33,8 +33,9 @@ LedDisplay::LedDisplay(IGui *gui, QWidget *parent, const char *objname)
     RISCV_sprintf(tstr, sizeof(tstr), "%s config", objname);
     cmdconfig_.make_string(tstr);
 
-    RISCV_sprintf(tstr, sizeof(tstr), "%s frame diff", objname);
-    cmdframe_.make_string(tstr);
+    // Frame sequence 0 requests the whole frame
+    objname_.make_string(objname);
+    frameSeq_ = 0;
 
     const AttributeType &cfgDisplay = 
         (*igui_->getpConfig())["DemoM4Widgets"]["Display"];
@@ -78,7 +79,7 @@ void LedDisplay::handleResponse(const char *cmd) {
     if (strcmp(cmd, cmdconfig_.to_string()) == 0) {
         emit signalConfigurate();
     } else if (strcmp(cmd, cmdframe_.to_string()) == 0) {
-        if (respFrame_.is_data()) {
+        if (respFrame_.is_dict() && respFrame_["Rects"].size()) {
             emit signalHandleResponse();
         } else {
             requested_ = false;
@@ -108,6 +109,10 @@ void LedDisplay::slotUpdateByTimer() {
     if (requested_) {
         return;
     }
+    char tstr[256];
+    RISCV_sprintf(tstr, sizeof(tstr), "%s frame diff %" RV_PRI64 "d",
+                  objname_.to_string(), frameSeq_);
+    cmdframe_.make_string(tstr);
     igui_->registerCommand(static_cast<IGuiCmdHandler *>(this),
                           cmdframe_.to_string(), &respFrame_, true);
     requested_ = true;
@@ -119,19 +124,34 @@ void LedDisplay::slotHandleResponse() {
     p.setRenderHint(QPainter::Antialiasing, false);
     p2.setRenderHint(QPainter::Antialiasing, false);
 
-    uint32_t *pframe = reinterpret_cast<uint32_t *>(respFrame_.data());
-    unsigned sz = respFrame_.size() / sizeof(uint32_t);
+    // Only modified rectangles are received, pixels are column ordered.
+    AttributeType &rects = respFrame_["Rects"];
+    QRect dirty;
     FrameItemType pix;
-    for (unsigned i = 0; i < sz; i++) {
-        pix.x = i / height_;
-        pix.y = i - height_ * pix.x;
-        pix.rgb = pframe[i];
-        drawPixel(&p, &pix, scale_);
-        drawPixel(&p2, &pix, screenshot_scale_);
+    for (unsigned n = 0; n < rects.size(); n++) {
+        AttributeType &rect = rects[n];
+        int x0 = rect[0u].to_int();
+        int y0 = rect[1].to_int();
+        int w = rect[2].to_int();
+        int h = rect[3].to_int();
+        uint32_t *pframe = reinterpret_cast<uint32_t *>(rect[4].data());
+        if (w <= 0 || h <= 0
+            || rect[4].size() < w * h * sizeof(uint32_t)) {
+            continue;
+        }
+        for (int i = 0; i < w * h; i++) {
+            pix.x = x0 + i / h;
+            pix.y = y0 + i % h;
+            pix.rgb = pframe[i];
+            drawPixel(&p, &pix, scale_);
+            drawPixel(&p2, &pix, screenshot_scale_);
+        }
+        dirty |= QRect(scale_ * x0, scale_ * y0, scale_ * w, scale_ * h);
     }
     p2.end();
     p.end();
-    update();
+    update(dirty);
+    frameSeq_ = respFrame_["Seq"].to_uint64();
 
     RISCV_memory_barrier();
     requested_ = false;
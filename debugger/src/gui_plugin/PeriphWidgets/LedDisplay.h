@@ -63,6 +63,7 @@ class LedDisplay : public QWidget,
 
 private:
     IGui *igui_;
+    AttributeType objname_;
     AttributeType cmdconfig_;
     AttributeType cmdframe_;
     AttributeType respConfig_;
@@ -76,6 +77,7 @@ private:
     int height_;
     int scale_;
     int screenshot_scale_;
+    uint64_t frameSeq_;     // 'Seq' of the last drawn frame, 0 = none
 
     bool requested_;
 };
@@ -22,6 +22,7 @@
 #include "services/debug/edcl.h"
 #include "services/debug/cpumonitor.h"
 #include "services/debug/codecov_generic.h"
+#include "services/debug/inputrec.h"
 #include "services/debug/greth.h"
 #include "services/debug/jtag.h"
 #include "services/elfloader/elfreader.h"
@@ -88,6 +89,7 @@ extern "C" int RISCV_init() {
     REGISTER_CLASS_IDX(Greth, 17)
     REGISTER_CLASS_IDX(TcpJtagBitBangClient, 18);
     REGISTER_CLASS_IDX(JTAG, 19);
+    REGISTER_CLASS_IDX(InputRecorder, 20);
 
     pcore_->load_plugins();
     return 0;
@@ -618,7 +620,7 @@ extern "C" void* RISCV_memshare_map(sharemem_def h, int sz) {
                         sz);
 #else
     ret = mmap(NULL, sz + 1, PROT_READ|PROT_WRITE, MAP_SHARED, h, 0);
-    if (ret < 0) {
+    if (ret == MAP_FAILED) {
         ret = 0;
     }
 #endif
@@ -644,6 +646,61 @@ extern "C" void RISCV_memshare_delete(sharemem_def h) {
 #endif
 }
 
+extern "C" void *RISCV_file_map(const char *filename, uint64_t *sz) {
+    void *ret = 0;
+    *sz = 0;
+#if defined(_WIN32) || defined(__CYGWIN__)
+    HANDLE hfile = CreateFileA(filename, GENERIC_READ, FILE_SHARE_READ, NULL,
+                               OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (hfile == INVALID_HANDLE_VALUE) {
+        return 0;
+    }
+    LARGE_INTEGER fsz;
+    if (!GetFileSizeEx(hfile, &fsz) || fsz.QuadPart == 0) {
+        CloseHandle(hfile);
+        return 0;
+    }
+    HANDLE hmap = CreateFileMappingA(hfile, NULL, PAGE_WRITECOPY, 0, 0, NULL);
+    if (hmap) {
+        ret = MapViewOfFile(hmap, FILE_MAP_COPY, 0, 0, 0);
+        // The view keeps a reference on the mapping object
+        CloseHandle(hmap);
+    }
+    CloseHandle(hfile);
+    if (ret) {
+        *sz = static_cast<uint64_t>(fsz.QuadPart);
+    }
+#else
+    int fd = open(filename, O_RDONLY);
+    if (fd < 0) {
+        return 0;
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size == 0) {
+        close(fd);
+        return 0;
+    }
+    ret = mmap(NULL, st.st_size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (ret == MAP_FAILED) {
+        return 0;
+    }
+    *sz = static_cast<uint64_t>(st.st_size);
+#endif
+    return ret;
+}
+
+extern "C" void RISCV_file_unmap(void *buf, uint64_t sz) {
+    if (!buf) {
+        return;
+    }
+#if defined(_WIN32) || defined(__CYGWIN__)
+    UnmapViewOfFile(buf);
+#else
+    munmap(buf, sz);
+#endif
+}
+
 extern "C" int RISCV_mutex_init(mutex_def *mutex) {
 #if defined(_WIN32) || defined(__CYGWIN__)
     InitializeCriticalSection(mutex);
@@ -734,21 +791,31 @@ extern "C" int RISCV_get_core_folderw(wchar_t* out, int sz) {
     return 0;
 }
 
-extern "C" void RISCV_set_current_dir() {
+extern "C" int RISCV_get_exe_path(char *out, int sz) {
 #if defined(_WIN32) || defined(__CYGWIN__)
     HMODULE hMod = GetModuleHandle(NULL);
-    char path[MAX_PATH] = "";
-    GetModuleFileNameA(hMod, path, MAX_PATH);
+    DWORD n = GetModuleFileNameA(hMod, out, static_cast<DWORD>(sz));
+    if (n == 0 || n >= static_cast<DWORD>(sz)) {
+        out[0] = 0;
+        return -1;
+    }
 #else         // Linux
+    ssize_t n = readlink("/proc/self/exe", out, sz - 1);
+    if (n == -1) {
+        out[0] = 0;
+        return -1;
+    }
+    out[n] = 0;
+#endif
+    return 0;
+}
+
+extern "C" void RISCV_set_current_dir() {
     // Get path of executable.
     char path[1024];
-    ssize_t n = readlink("/proc/self/exe", path,
-                         sizeof(path)/sizeof(path[0]) - 1);
-    if (n == -1) {
+    if (RISCV_get_exe_path(path, sizeof(path)) != 0) {
         return;
     }
-    path[n] = 0;
-#endif
 
     size_t i;
     for(i = strlen(path) - 1; i > 0 && path[i] != '/' && path[i] != '\\'; --i);
@@ -15,9 +15,20 @@
  */
 
 #include "codecov_generic.h"
+#include "coreservices/ielfreader.h"
+#include <stdio.h>
 
 namespace debugger {
 
+static int popcount64(uint64_t v) {
+    int ret = 0;
+    while (v) {
+        v &= v - 1;
+        ret++;
+    }
+    return ret;
+}
+
 int CoverageCmdType::isValid(AttributeType *args) {
     if (!(*args)[0u].is_equal("coverage")) {
         return CMD_INVALID;
@@ -32,6 +43,24 @@ void CoverageCmdType::exec(AttributeType *args, AttributeType *res) {
             p->getCoverageDetailed(res);
             return;
         }
+        if ((*args)[1].is_equal("elf")) {
+            if (p->regionsFromElf() == 0) {
+                generateError(res, "No executable sections");
+                return;
+            }
+        }
+    } else if (args->size() == 3 && (*args)[1].is_string()
+            && (*args)[2].is_string()) {
+        int err = 0;
+        if ((*args)[1].is_equal("save")) {
+            err = p->saveBinary((*args)[2].to_string());
+        } else if ((*args)[1].is_equal("lcov")) {
+            err = p->saveLcov((*args)[2].to_string());
+        }
+        if (err) {
+            generateError(res, "Cannot write file");
+            return;
+        }
     }
     res->make_floating(p->getCoverage());
 }
@@ -41,9 +70,29 @@ GenericCodeCoverage::GenericCodeCoverage(const char *name) : IService(name) {
     registerInterface(static_cast<ICoverageTracker *>(this));
     registerAttribute("CmdExecutor", static_cast<IAttribute *>(&cmdexec_));
     registerAttribute("SourceCode", static_cast<IAttribute *>(&src_));
-    registerAttribute("Paged", static_cast<IAttribute *>(&paged_));
     registerAttribute("Regions", static_cast<IAttribute *>(&regions_));
-    track_sz_ = 0;
+    iexec_ = 0;
+    isrc_ = 0;
+    pcmd_ = 0;
+    pages_ = 0;
+    pageTotal_ = 0;
+    pageMax_ = 0;
+    lastPage_ = 0;
+    lastReadPage_ = 0;
+    lastMiss_ = ~0ull;
+    trackedSlots_ = 0;
+    usedSlots_ = 0;
+    RISCV_mutex_init(&mutexPages_);
+}
+
+GenericCodeCoverage::~GenericCodeCoverage() {
+    for (unsigned i = 0; i < pageTotal_; i++) {
+        delete pages_[i];
+    }
+    if (pages_) {
+        delete [] pages_;
+    }
+    RISCV_mutex_destroy(&mutexPages_);
 }
 
 void GenericCodeCoverage::postinitService() {
@@ -66,18 +115,12 @@ void GenericCodeCoverage::postinitService() {
     pcmd_ = new CoverageCmdType(static_cast<IService *>(this));
     iexec_->registerCommand(static_cast<ICommand *>(pcmd_));
 
-    // Compute Total regions size
     if (!regions_.is_list()) {
         RISCV_error("Regions attribute of wrong format",
                     src_.to_string());
-        return;
-    }
-    track_sz_ = 0;
-    for (unsigned i = 0; i < regions_.size(); i++) {
-        AttributeType &item = regions_[i];
-        track_sz_ += item[1].to_uint64() - item[0u].to_uint64() + 1;
+        regions_.make_list(0);
     }
-    memset(flash_, 0, sizeof(flash_));
+    setRegions();
 }
 
 void GenericCodeCoverage::predeleteService() {
@@ -86,81 +129,163 @@ void GenericCodeCoverage::predeleteService() {
     }
 }
 
-void GenericCodeCoverage::markAddress(uint64_t addr, uint8_t oplen) {
-    addr = paged2flat(addr);
-    if (addr < sizeof(flash_)) {
-        flash_[addr] = oplen;
+void GenericCodeCoverage::setRegions() {
+    CoveragePageType *page;
+    uint64_t slot;
+    uint64_t bit;
+
+    RISCV_mutex_lock(&mutexPages_);
+    for (unsigned i = 0; i < pageTotal_; i++) {
+        memset(pages_[i]->tracked, 0, sizeof(pages_[i]->tracked));
+    }
+    for (unsigned i = 0; i < regions_.size(); i++) {
+        AttributeType &item = regions_[i];
+        uint64_t addr = item[0u].to_uint64() & ~((1ull << SLOT_BITS) - 1);
+        uint64_t end = item[1].to_uint64();
+        page = 0;
+        while (addr <= end) {
+            if (!page || page->base != (addr & ~PAGE_MASK)) {
+                page = findPage(addr, true);
+            }
+            slot = (addr & PAGE_MASK) >> SLOT_BITS;
+            bit = 1ull << (slot & 0x3F);
+            page->tracked[slot >> 6] |= bit;
+            addr += 1ull << SLOT_BITS;
+        }
+    }
+
+    // Recompute counters. Previously executed slots are kept.
+    trackedSlots_ = 0;
+    usedSlots_ = 0;
+    for (unsigned i = 0; i < pageTotal_; i++) {
+        page = pages_[i];
+        for (int n = 0; n < PAGE_WORDS; n++) {
+            trackedSlots_ += popcount64(page->tracked[n]);
+            usedSlots_ += popcount64(page->tracked[n] & page->marked[n]);
+        }
     }
+    lastMiss_ = ~0ull;
+    RISCV_mutex_unlock(&mutexPages_);
 }
 
-uint64_t GenericCodeCoverage::paged2flat(uint64_t addr) {
-    if (!paged_.to_bool()) {
-        return addr;
+GenericCodeCoverage::CoveragePageType *
+GenericCodeCoverage::findPage(uint64_t addr, bool create) {
+    uint64_t base = addr & ~PAGE_MASK;
+    int lo = 0;
+    int hi = static_cast<int>(pageTotal_) - 1;
+    int mid;
+    while (lo <= hi) {
+        mid = (lo + hi) / 2;
+        if (pages_[mid]->base == base) {
+            return pages_[mid];
+        } else if (pages_[mid]->base < base) {
+            lo = mid + 1;
+        } else {
+            hi = mid - 1;
+        }
+    }
+    if (!create) {
+        return 0;
+    }
+
+    if (pageTotal_ == pageMax_) {
+        pageMax_ = pageMax_ ? 2 * pageMax_ : 64;
+        CoveragePageType **t = new CoveragePageType *[pageMax_];
+        if (pages_) {
+            memcpy(t, pages_, pageTotal_ * sizeof(CoveragePageType *));
+            delete [] pages_;
+        }
+        pages_ = t;
+    }
+    CoveragePageType *page = new CoveragePageType;
+    memset(page, 0, sizeof(CoveragePageType));
+    page->base = base;
+    for (int i = static_cast<int>(pageTotal_); i > lo; i--) {
+        pages_[i] = pages_[i - 1];
     }
-    return addr % sizeof(flash_);
+    pages_[lo] = page;
+    pageTotal_++;
+    return page;
 }
 
-double GenericCodeCoverage::getCoverage() {
-    uint64_t used = 0;
-    uint64_t off = 0;
-    uint64_t inc_bytes;
-    double ret;
+bool GenericCodeCoverage::isMarked(uint64_t addr) {
+    if (!lastReadPage_ || lastReadPage_->base != (addr & ~PAGE_MASK)) {
+        lastReadPage_ = findPage(addr, false);
+        if (!lastReadPage_) {
+            return false;
+        }
+    }
+    uint64_t slot = (addr & PAGE_MASK) >> SLOT_BITS;
+    return (lastReadPage_->marked[slot >> 6] >> (slot & 0x3F)) & 0x1;
+}
 
-    for (unsigned i = 0; i < regions_.size(); i++) {
-        AttributeType &item = regions_[i];
-        uint64_t sec_start = paged2flat(item[0u].to_uint32());
-        uint64_t sec_end = paged2flat(item[1].to_uint32());
-        uint64_t sec_sz = sec_end - sec_start + 1;
-        off = 0;
-        while (off < sec_sz) {
-            if (!flash_[sec_start + off]) {
-                off++;
-            } else {
-                inc_bytes = flash_[sec_start + off];
-                if ((sec_start + off + inc_bytes) > sec_end) {
-                    inc_bytes = 1 + sec_end - (sec_start + off);
-                }
-                used += inc_bytes;
-                off += inc_bytes;
+void GenericCodeCoverage::markAddress(uint64_t addr, uint8_t oplen) {
+    CoveragePageType *page = lastPage_;
+    uint64_t slot;
+    uint64_t bit;
+    int cnt = (oplen + (1 << SLOT_BITS) - 1) >> SLOT_BITS;
+
+    for (int i = 0; i < cnt; i++, addr += (1ull << SLOT_BITS)) {
+        if (!page || page->base != (addr & ~PAGE_MASK)) {
+            // Slow path: another page or address outside of regions
+            if ((addr & ~PAGE_MASK) == lastMiss_) {
+                continue;
+            }
+            // Miss is cached under the lock so that setRegions() reset
+            // isn't overwritten for a page it has just created
+            RISCV_mutex_lock(&mutexPages_);
+            page = findPage(addr, false);
+            if (!page) {
+                lastMiss_ = addr & ~PAGE_MASK;
             }
+            RISCV_mutex_unlock(&mutexPages_);
+            if (!page) {
+                continue;
+            }
+            lastPage_ = page;
+        }
+        slot = (addr & PAGE_MASK) >> SLOT_BITS;
+        bit = 1ull << (slot & 0x3F);
+        if (page->marked[slot >> 6] & bit) {
+            continue;
         }
+        // Each slot is marked only once, counters are shared with
+        // setRegions() and updated under the same lock
+        RISCV_mutex_lock(&mutexPages_);
+        page->marked[slot >> 6] |= bit;
+        if (page->tracked[slot >> 6] & bit) {
+            usedSlots_++;
+        }
+        RISCV_mutex_unlock(&mutexPages_);
     }
+}
 
-    ret = 100.0*static_cast<double>(used)/track_sz_;
-    return ret;
+double GenericCodeCoverage::getCoverage() {
+    if (trackedSlots_ == 0) {
+        return 0;
+    }
+    return 100.0*static_cast<double>(usedSlots_)/trackedSlots_;
 }
 
 void GenericCodeCoverage::getCoverageDetailed(AttributeType *resp) {
     resp->attr_free();
     resp->make_list(0);
-    unsigned off;
-    uint8_t marked;
+    uint64_t off;
+    bool marked;
     AttributeType item;
     AttributeType symbol;
-    bool split_section;
-    enum EStage {
-        SectionMarked,
-        SectionCleared,
-    } estage;
     char tstr[256];
     item.make_list(4);
 
+    RISCV_mutex_lock(&mutexPages_);
     for (unsigned i = 0; i < regions_.size(); i++) {
         AttributeType &region = regions_[i];
-        unsigned sec_start = region[0u].to_uint32();
-        unsigned sec_end = region[1].to_uint32();
-        unsigned sec_sz = sec_end - sec_start + 1;
-        unsigned sec_cnt = 0;
-        off = sec_start;
-        marked = flash_[paged2flat(sec_start)];
+        uint64_t sec_start = region[0u].to_uint64();
+        uint64_t sec_end = region[1].to_uint64();
 
-        if (flash_[paged2flat(off)]) {
-            item[0u].make_boolean(true);
-            estage = SectionMarked;
-        } else {
-            item[0u].make_boolean(false);
-            estage = SectionCleared;
-        }
+        off = sec_start;
+        marked = isMarked(off);
+        item[0u].make_boolean(marked);
         item[1].make_uint64(sec_start);        // start addess initial value
         item[2].make_uint64(sec_start);        // end address initial value
         isrc_->addressToSymbol(sec_start, &symbol);
@@ -168,55 +293,172 @@ void GenericCodeCoverage::getCoverageDetailed(AttributeType *resp) {
                         symbol[0u].to_string(), symbol[1].to_uint32());
         item[3].make_string(tstr);
 
-        while (sec_cnt < sec_sz) {
-            marked = flash_[paged2flat(off)];
-            split_section = false;
-
-            switch (estage) {
-            case SectionMarked:
-                if (!marked) {
-                    estage = SectionCleared;
-                    split_section = true;
-                }
-                break;
-            case SectionCleared:
-                if (marked) {
-                    estage = SectionMarked;
-                    split_section = true;
-                }
-                break;
-            default:;
-            }
-
-            if (split_section) {
+        while (off <= sec_end) {
+            if (isMarked(off) != marked) {
                 resp->add_to_list(&item);
 
                 // init attribute for the next sections
-                item[0u].make_boolean(marked ? true: false);
+                marked = !marked;
+                item[0u].make_boolean(marked);
                 item[1].make_uint64(off);               // start address
-                item[2].make_uint64(off);               // end address initial value
                 isrc_->addressToSymbol(off, &symbol);
                 RISCV_sprintf(tstr, sizeof(tstr), "%s+0x%x",
                               symbol[0u].to_string(), symbol[1].to_uint32());
                 item[3].make_string(tstr);
             }
-
-            if (marked) {
-                for (uint8_t n = 0; n < marked; n++) {
-                    if (sec_cnt < sec_sz) {
-                        item[2].make_uint64(off);   // end address update
-                    }
-                    off++;
-                    sec_cnt++;
-                }
+            off = (off | ((1ull << SLOT_BITS) - 1)) + 1;
+            if (off - 1 <= sec_end) {
+                item[2].make_uint64(off - 1);   // end address update
             } else {
-                item[2].make_uint64(off);           // end address update
-                off++;
-                sec_cnt++;
+                item[2].make_uint64(sec_end);
             }
         }
         resp->add_to_list(&item);
     }
+    RISCV_mutex_unlock(&mutexPages_);
+}
+
+int GenericCodeCoverage::regionsFromElf() {
+    AttributeType lstServ;
+    AttributeType region;
+    RISCV_get_services_with_iface(IFACE_ELFREADER, &lstServ);
+    if (lstServ.size() == 0) {
+        return 0;
+    }
+    IService *iserv = static_cast<IService *>(lstServ[0u].to_iface());
+    IElfReader *elf = static_cast<IElfReader *>(
+                        iserv->getInterface(IFACE_ELFREADER));
+
+    regions_.make_list(0);
+    region.make_list(2);
+    for (unsigned i = 0; i < elf->loadableSectionTotal(); i++) {
+        if (!elf->sectionExecutable(i) || elf->sectionSize(i) == 0) {
+            continue;
+        }
+        region[0u].make_uint64(elf->sectionAddress(i));
+        region[1].make_uint64(elf->sectionAddress(i)
+                              + elf->sectionSize(i) - 1);
+        regions_.add_to_list(&region);
+    }
+    setRegions();
+    return static_cast<int>(regions_.size());
+}
+
+/**
+ * Binary format (little-endian):
+ *      char[8]     "COVMAP1"
+ *      uint32_t    slot size in bytes
+ *      uint32_t    number of regions
+ *      Per region:
+ *          uint64_t    start address
+ *          uint64_t    end address (inclusive)
+ *          uint8_t[]   bit per slot, (slots + 7) / 8 bytes
+ */
+int GenericCodeCoverage::saveBinary(const char *filename) {
+    FILE *fp = fopen(filename, "wb");
+    if (!fp) {
+        return -1;
+    }
+    char magic[8] = "COVMAP1";
+    uint32_t slot_sz = 1u << SLOT_BITS;
+    uint32_t total = regions_.size();
+    fwrite(magic, 1, sizeof(magic), fp);
+    fwrite(&slot_sz, 1, sizeof(slot_sz), fp);
+    fwrite(&total, 1, sizeof(total), fp);
+
+    RISCV_mutex_lock(&mutexPages_);
+    for (unsigned i = 0; i < regions_.size(); i++) {
+        uint64_t start = regions_[i][0u].to_uint64();
+        uint64_t end = regions_[i][1].to_uint64();
+        fwrite(&start, 1, sizeof(start), fp);
+        fwrite(&end, 1, sizeof(end), fp);
+
+        uint8_t byte = 0;
+        int bitcnt = 0;
+        for (uint64_t addr = start; addr <= end; addr += slot_sz) {
+            byte |= static_cast<uint8_t>(isMarked(addr)) << bitcnt;
+            if (++bitcnt == 8) {
+                fwrite(&byte, 1, 1, fp);
+                byte = 0;
+                bitcnt = 0;
+            }
+        }
+        if (bitcnt) {
+            fwrite(&byte, 1, 1, fp);
+        }
+    }
+    RISCV_mutex_unlock(&mutexPages_);
+    fclose(fp);
+    return 0;
+}
+
+/**
+ * lcov tracefile without source information: every region is a 'file'
+ * and every instruction slot is a 'line' numbered from 1.
+ */
+int GenericCodeCoverage::saveLcov(const char *filename) {
+    FILE *fp = fopen(filename, "w");
+    if (!fp) {
+        return -1;
+    }
+    AttributeType symbols;
+    if (isrc_) {
+        isrc_->getSymbols(&symbols);
+    }
+    uint64_t slot_sz = 1ull << SLOT_BITS;
+
+    RISCV_mutex_lock(&mutexPages_);
+    fprintf(fp, "TN:%s\n", getObjName());
+    for (unsigned i = 0; i < regions_.size(); i++) {
+        uint64_t start = regions_[i][0u].to_uint64();
+        uint64_t end = regions_[i][1].to_uint64();
+        unsigned fnf = 0;
+        unsigned fnh = 0;
+        unsigned lh = 0;
+        unsigned lf = 0;
+
+        fprintf(fp, "SF:0x%" RV_PRI64 "x-0x%" RV_PRI64 "x\n", start, end);
+        for (unsigned n = 0; n < symbols.size(); n++) {
+            AttributeType &symb = symbols[n];
+            uint64_t faddr = symb[Symbol_Addr].to_uint64();
+            if (symb[Symbol_Type].to_uint64() != SYMBOL_TYPE_FUNCTION
+                || faddr < start || faddr > end) {
+                continue;
+            }
+            fprintf(fp, "FN:%" RV_PRI64 "u,%s\n",
+                    (faddr - start) / slot_sz + 1,
+                    symb[Symbol_Name].to_string());
+        }
+        for (unsigned n = 0; n < symbols.size(); n++) {
+            AttributeType &symb = symbols[n];
+            uint64_t faddr = symb[Symbol_Addr].to_uint64();
+            uint64_t fend = faddr + symb[Symbol_Size].to_uint64();
+            if (symb[Symbol_Type].to_uint64() != SYMBOL_TYPE_FUNCTION
+                || faddr < start || faddr > end) {
+                continue;
+            }
+            int hit = 0;
+            for (uint64_t addr = faddr; addr < fend && !hit; addr += slot_sz) {
+                hit = isMarked(addr);
+            }
+            fprintf(fp, "FNDA:%d,%s\n", hit, symb[Symbol_Name].to_string());
+            fnf++;
+            fnh += hit;
+        }
+        fprintf(fp, "FNF:%u\nFNH:%u\n", fnf, fnh);
+
+        for (uint64_t addr = start; addr <= end; addr += slot_sz) {
+            int hit = isMarked(addr);
+            fprintf(fp, "DA:%" RV_PRI64 "u,%d\n",
+                    (addr - start) / slot_sz + 1, hit);
+            lf++;
+            lh += hit;
+        }
+        fprintf(fp, "LF:%u\nLH:%u\nend_of_record\n", lf, lh);
+    }
+    RISCV_mutex_unlock(&mutexPages_);
+    fclose(fp);
+    return 0;
 }
 
 }  // namespace debugger
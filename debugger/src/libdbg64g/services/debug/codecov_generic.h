@@ -39,9 +39,15 @@ class CoverageCmdType : public ICommand {
             "        coverage ranges\n"
             "    3. Read list with detailed information and symbol names:\n"
             "        coverage detailed\n"
+            "    4. Track executable sections of the loaded ELF-file:\n"
+            "        coverage elf\n"
+            "    5. Save bit-map into binary file or lcov tracefile:\n"
+            "        coverage save filename\n"
+            "        coverage lcov filename\n"
             "Example:\n"
             "    coverage\n"
-            "    coverage detailed");
+            "    coverage detailed\n"
+            "    coverage lcov fw.info");
     }
 
     /** ICommand */
@@ -54,6 +60,7 @@ class GenericCodeCoverage : public IService,
                             public ICoverageTracker {
  public:
     explicit GenericCodeCoverage(const char *name);
+    virtual ~GenericCodeCoverage();
  
     /** IService interface */
     virtual void postinitService();
@@ -65,22 +72,52 @@ class GenericCodeCoverage : public IService,
     /** Common commands access methods */
     virtual double getCoverage();
     virtual void getCoverageDetailed(AttributeType *resp);
+    virtual int regionsFromElf();
+    virtual int saveBinary(const char *filename);
+    virtual int saveLcov(const char *filename);
 
  protected:
-    uint64_t paged2flat(uint64_t addr);
+    /** 4 KB page with 1 bit per 2-bytes instruction slot */
+    static const int PAGE_BITS = 12;
+    static const uint64_t PAGE_MASK = (1ull << PAGE_BITS) - 1;
+    static const int SLOT_BITS = 1;
+    static const int PAGE_SLOTS = 1 << (PAGE_BITS - SLOT_BITS);
+    static const int PAGE_WORDS = PAGE_SLOTS / 64;
+
+    struct CoveragePageType {
+        uint64_t base;
+        uint64_t tracked[PAGE_WORDS];   // slots inside of regions
+        uint64_t marked[PAGE_WORDS];    // executed slots
+    };
+
+    void setRegions();
+    CoveragePageType *findPage(uint64_t addr, bool create);
+    bool isMarked(uint64_t addr);
 
  protected:
     AttributeType cmdexec_;
     AttributeType src_;
     AttributeType regions_;
-    AttributeType paged_;
 
     ICmdExecutor *iexec_;
     ISourceCode *isrc_;
     CoverageCmdType *pcmd_;
 
-    uint64_t track_sz_;
-    uint8_t flash_[128*1024];
+    /**
+     * Pages sorted by base address. Pages are never released while the
+     * service is alive so that the cached lastPage_ stays valid without
+     * locking the CPU thread.
+     */
+    CoveragePageType **pages_;
+    unsigned pageTotal_;
+    unsigned pageMax_;
+    CoveragePageType *lastPage_;        // CPU thread cache
+    CoveragePageType *lastReadPage_;    // commands cache
+    uint64_t lastMiss_;
+    mutex_def mutexPages_;
+
+    uint64_t trackedSlots_;
+    uint64_t usedSlots_;
 };
 
 DECLARE_CLASS(GenericCodeCoverage)
@@ -20,6 +20,7 @@
 #include <string.h>
 #include "cpumonitor.h"
 #include "coreservices/isrccode.h"
+#include "coreservices/iclock.h"
 
 namespace debugger {
 
@@ -31,13 +32,18 @@ CpuMonitor::CpuMonitor(const char *name)
     registerAttribute("PollingMs", &pollingMs_);
 
     RISCV_event_create(&config_done_, "cpumonitor_config_done");
+    RISCV_event_create(&event_halted_, "cpumonitor_halted");
     RISCV_mutex_init(&mutex_resume_);
     RISCV_register_hap(static_cast<IHap *>(this));
     hartsel_ = 0;
+    haltsum_ = 0;
+    haltPending_ = 0;
+    haltNotifier_ = false;
 }
 
 CpuMonitor::~CpuMonitor() {
     RISCV_event_close(&config_done_);
+    RISCV_event_close(&event_halted_);
     RISCV_mutex_destroy(&mutex_resume_);
 }
 
@@ -50,6 +56,13 @@ void CpuMonitor::postinitService() {
         return;
     }
 
+    // Simulated CPU models (functional and RTL haltsum watcher) trigger
+    // HAP_CpuHalted directly from the simulation thread, so DMI polling is
+    // used only with the real hardware.
+    AttributeType lstCpu;
+    RISCV_get_services_with_iface(IFACE_CLOCK, &lstCpu);
+    haltNotifier_ = lstCpu.size() != 0;
+
     if (!run()) {
         RISCV_error("Can't create thread.", NULL);
         return;
@@ -68,6 +81,12 @@ void CpuMonitor::hapTriggered(EHapType type,
         RISCV_mutex_lock(&mutex_resume_);
         haltsum_ &= ~(1ull << (hartsel_ & 0x3f));
         RISCV_mutex_unlock(&mutex_resume_);
+    } else if (type == HAP_CpuHalted && haltNotifier_) {
+        RISCV_mutex_lock(&mutex_resume_);
+        haltsum_ |= 1ull << (param & 0x3f);
+        haltPending_ |= 1ull << (param & 0x3f);
+        RISCV_mutex_unlock(&mutex_resume_);
+        RISCV_event_set(&event_halted_);
     }
 }
 
@@ -75,8 +94,34 @@ void CpuMonitor::busyLoop() {
     uint64_t status;
     uint64_t mask;
     uint64_t t1;
+    uint64_t pending;
     RISCV_event_wait(&config_done_);
 
+    while (isEnabled() && haltNotifier_) {
+        // Wait halt notification, timeout only to check thread enable flag
+        if (RISCV_event_wait_ms(&event_halted_, pollingMs_.to_int()) != 0) {
+            continue;
+        }
+        RISCV_event_clear(&event_halted_);
+
+        RISCV_mutex_lock(&mutex_resume_);
+        mask = 1ull << (hartsel_ & 0x3f);
+        pending = haltPending_;
+        haltPending_ = 0;
+        RISCV_mutex_unlock(&mutex_resume_);
+
+        // Listeners read memory, so the original instructions are restored
+        // before HAP_Halt the same way as with polling
+        if (pending & mask) {
+            removeBreakpoints();
+        }
+        for (uint64_t i = 0; pending != 0; i++, pending >>= 1) {
+            if (pending & 1) {
+                RISCV_trigger_hap(HAP_Halt, i, "Core is halted");
+            }
+        }
+    }
+
     while (isEnabled()) {
         status = getStatus();
         RISCV_sleep_ms(pollingMs_.to_int());
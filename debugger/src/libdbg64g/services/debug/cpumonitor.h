@@ -57,9 +57,12 @@ class CpuMonitor : public IService,
     ICmdExecutor *icmdexec_;
 
     event_def config_done_;
+    event_def event_halted_;
     mutex_def mutex_resume_;
     uint64_t hartsel_;      // context switched Hart index
     uint64_t haltsum_;
+    uint64_t haltPending_;  // HAP_CpuHalted received, HAP_Halt not sent yet
+    bool haltNotifier_;     // CPU triggers HAP_CpuHalted, polling disabled
 };
 
 DECLARE_CLASS(CpuMonitor)
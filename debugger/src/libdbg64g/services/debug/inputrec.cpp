@@ -0,0 +1,258 @@
+/*
+ *  Copyright 2023 Sergey Khabarov, sergeykhbr@gmail.com
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include <api_core.h>
+#include <string.h>
+#include <stdlib.h>
+#include <autobuffer.h>
+#include "inputrec.h"
+
+namespace debugger {
+
+InputRecorder::InputRecorder(const char *name)
+    : IService(name), IHap(HAP_ConfigDone) {
+    registerInterface(static_cast<IInputRecorder *>(this));
+    registerInterface(static_cast<IClockListener *>(this));
+    registerAttribute("Mode", &mode_);
+    registerAttribute("LogFile", &logFile_);
+    registerAttribute("Clock", &clock_);
+
+    iclk_ = 0;
+    emode_ = Mode_Off;
+    flog_ = 0;
+    scheduled_ = false;
+    replayIdx_ = 0;
+    sources_.make_list(0);
+    pending_.make_list(0);
+    replay_.make_list(0);
+    RISCV_mutex_init(&mutex_);
+    RISCV_register_hap(static_cast<IHap *>(this));
+}
+
+InputRecorder::~InputRecorder() {
+    RISCV_mutex_destroy(&mutex_);
+}
+
+void InputRecorder::postinitService() {
+    if (mode_.is_equal("record")) {
+        emode_ = Mode_Record;
+    } else if (mode_.is_equal("replay")) {
+        emode_ = Mode_Replay;
+    } else {
+        return;
+    }
+
+    iclk_ = static_cast<IClock *>(
+        RISCV_get_service_iface(clock_.to_string(), IFACE_CLOCK));
+    if (!iclk_) {
+        RISCV_error("Can't find IClock interface %s", clock_.to_string());
+        emode_ = Mode_Off;
+        return;
+    }
+
+    if (emode_ == Mode_Record) {
+        flog_ = fopen(logFile_.to_string(), "wb");
+        if (!flog_) {
+            RISCV_error("Can't create file %s", logFile_.to_string());
+            emode_ = Mode_Off;
+        }
+    } else if (readLog()) {
+        RISCV_error("Can't read file %s", logFile_.to_string());
+        emode_ = Mode_Off;
+    } else {
+        RISCV_info("%d input events to replay", replay_.size());
+    }
+}
+
+void InputRecorder::predeleteService() {
+    if (flog_) {
+        fclose(flog_);
+        flog_ = 0;
+    }
+}
+
+void InputRecorder::hapTriggered(EHapType type, uint64_t param,
+                                 const char *descr) {
+    RISCV_unregister_hap(static_cast<IHap *>(this));
+    // All sources registered in postinit, start replay
+    if (emode_ == Mode_Replay) {
+        replayNext();
+    }
+}
+
+void InputRecorder::registerInputSource(const char *name,
+                                        IInputSource *src) {
+    AttributeType item;
+    item.make_list(2);
+    item[0u].make_string(name);
+    item[1].make_iface(src);
+    RISCV_mutex_lock(&mutex_);
+    sources_.add_to_list(&item);
+    RISCV_mutex_unlock(&mutex_);
+}
+
+void InputRecorder::unregisterInputSource(IInputSource *src) {
+    RISCV_mutex_lock(&mutex_);
+    for (unsigned i = 0; i < sources_.size(); i++) {
+        if (sources_[i][1].to_iface() == src) {
+            sources_.remove_from_list(i);
+            break;
+        }
+    }
+    RISCV_mutex_unlock(&mutex_);
+}
+
+const char *InputRecorder::sourceName(IInputSource *src) {
+    for (unsigned i = 0; i < sources_.size(); i++) {
+        if (sources_[i][1].to_iface() == src) {
+            return sources_[i][0u].to_string();
+        }
+    }
+    return 0;
+}
+
+IInputSource *InputRecorder::sourceByName(const char *name) {
+    for (unsigned i = 0; i < sources_.size(); i++) {
+        if (sources_[i][0u].is_equal(name)) {
+            return static_cast<IInputSource *>(sources_[i][1].to_iface());
+        }
+    }
+    return 0;
+}
+
+bool InputRecorder::putInput(IInputSource *src, AttributeType *event) {
+    if (emode_ == Mode_Off) {
+        return false;
+    }
+    RISCV_mutex_lock(&mutex_);
+    const char *name = sourceName(src);
+    if (!name) {
+        RISCV_mutex_unlock(&mutex_);
+        return false;
+    }
+    if (emode_ == Mode_Replay) {
+        RISCV_mutex_unlock(&mutex_);
+        RISCV_info("Input of '%s' ignored in replay mode", name);
+        return true;
+    }
+
+    AttributeType item;
+    item.make_list(2);
+    item[0u].make_string(name);
+    item[1] = *event;
+    pending_.add_to_list(&item);
+    bool schedule = !scheduled_;
+    scheduled_ = true;
+    RISCV_mutex_unlock(&mutex_);
+
+    // Applied at the end of the current step or while halted at this step
+    if (schedule) {
+        iclk_->registerStepCallback(static_cast<IClockListener *>(this),
+                                    iclk_->getStepCounter());
+    }
+    return true;
+}
+
+void InputRecorder::stepCallback(uint64_t t) {
+    if (emode_ == Mode_Replay) {
+        while (replayIdx_ < replay_.size()
+            && replay_[replayIdx_][Event_Step].to_uint64() <= t) {
+            AttributeType &item = replay_[replayIdx_++];
+            IInputSource *src = sourceByName(item[Event_Source].to_string());
+            if (!src) {
+                RISCV_error("Input source '%s' not found",
+                            item[Event_Source].to_string());
+                continue;
+            }
+            src->applyInput(&item[Event_Data]);
+        }
+        replayNext();
+        return;
+    }
+
+    AttributeType events;
+    RISCV_mutex_lock(&mutex_);
+    events = pending_;
+    pending_.make_list(0);
+    scheduled_ = false;
+    RISCV_mutex_unlock(&mutex_);
+
+    AttributeType t1;
+    for (unsigned i = 0; i < events.size(); i++) {
+        AttributeType &item = events[i];
+        IInputSource *src = sourceByName(item[0u].to_string());
+        if (src) {
+            src->applyInput(&item[1]);
+        }
+        t1 = item[1];
+        t1.to_config();
+        fprintf(flog_, "%" RV_PRI64 "d %s %s\n",
+                t, item[0u].to_string(), t1.to_string());
+    }
+    // The log must be complete if the simulation crashes
+    fflush(flog_);
+}
+
+void InputRecorder::replayNext() {
+    if (replayIdx_ < replay_.size()) {
+        iclk_->registerStepCallback(static_cast<IClockListener *>(this),
+                    replay_[replayIdx_][Event_Step].to_uint64());
+    }
+}
+
+int InputRecorder::readLog() {
+    uint64_t sz;
+    char *buf = reinterpret_cast<char *>(
+        RISCV_file_map(logFile_.to_string(), &sz));
+    if (!buf) {
+        return -1;
+    }
+    AutoBuffer line;
+    AttributeType item;
+    uint64_t pos = 0;
+    while (pos < sz) {
+        uint64_t end = pos;
+        while (end < sz && buf[end] != '\n') {
+            end++;
+        }
+        if (end == pos) {
+            pos++;
+            continue;
+        }
+        line.clear();
+        line.write_bin(&buf[pos], static_cast<int>(end - pos));
+        pos = end + 1;
+
+        // "<step> <source> <event>"
+        char *step = line.getBuffer();
+        char *name = strchr(step, ' ');
+        char *data = name ? strchr(name + 1, ' ') : 0;
+        if (!data) {
+            continue;
+        }
+        *name++ = '\0';
+        *data++ = '\0';
+        item.make_list(Event_Total);
+        item[Event_Step].make_uint64(strtoull(step, 0, 0));
+        item[Event_Source].make_string(name);
+        item[Event_Data].from_config(data);
+        replay_.add_to_list(&item);
+    }
+    RISCV_file_unmap(buf, sz);
+    return 0;
+}
+
+}  // namespace debugger
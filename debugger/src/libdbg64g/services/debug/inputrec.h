@@ -0,0 +1,98 @@
+/*
+ *  Copyright 2023 Sergey Khabarov, sergeykhbr@gmail.com
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#pragma once
+
+#include <iclass.h>
+#include <iservice.h>
+#include "ihap.h"
+#include "coreservices/iclock.h"
+#include "coreservices/iinputrec.h"
+#include <stdio.h>
+
+namespace debugger {
+
+/**
+ * @brief Deterministic record/replay of the asynchronous inputs.
+ * @details In 'record' mode input events are moved into the step queue of
+ *          the clock, applied from the simulation thread and written into
+ *          the log as lines "<step> <source> <event>". In 'replay' mode
+ *          the live inputs are ignored and the logged events are applied
+ *          at the same steps.
+ */
+class InputRecorder : public IService,
+                      public IInputRecorder,
+                      public IClockListener,
+                      public IHap {
+ public:
+    explicit InputRecorder(const char *name);
+    virtual ~InputRecorder();
+
+    /** IService interface */
+    virtual void postinitService() override;
+    virtual void predeleteService() override;
+
+    /** IInputRecorder */
+    virtual void registerInputSource(const char *name, IInputSource *src);
+    virtual void unregisterInputSource(IInputSource *src);
+    virtual bool putInput(IInputSource *src, AttributeType *event);
+    virtual bool isReplay() { return emode_ == Mode_Replay; }
+
+    /** IClockListener */
+    virtual void stepCallback(uint64_t t);
+
+    /** IHap */
+    virtual void hapTriggered(EHapType type, uint64_t param,
+                              const char *descr);
+
+ private:
+    const char *sourceName(IInputSource *src);
+    IInputSource *sourceByName(const char *name);
+    int readLog();
+    void replayNext();
+
+ private:
+    enum EMode {
+        Mode_Off,
+        Mode_Record,
+        Mode_Replay
+    };
+
+    enum EEventItem {
+        Event_Step,
+        Event_Source,
+        Event_Data,
+        Event_Total
+    };
+
+    AttributeType mode_;
+    AttributeType logFile_;
+    AttributeType clock_;
+
+    IClock *iclk_;
+    EMode emode_;
+    FILE *flog_;
+    AttributeType sources_;     // [[name, iface], ...]
+    AttributeType pending_;     // record: [[name, event], ...]
+    bool scheduled_;
+    AttributeType replay_;      // [[step, name, event], ...]
+    unsigned replayIdx_;
+    mutex_def mutex_;
+};
+
+DECLARE_CLASS(InputRecorder)
+
+}  // namespace debugger
@@ -47,7 +47,7 @@ void JTAG::postinitService() {
                                     IFACE_JTAG_BITBANG));
     }
     if (ibb_ == 0) {
-        RISCV_error("Cannot get IJtagBitBang interface");
+        RISCV_error("Cannot get %s interface", IFACE_JTAG_BITBANG);
     }
 }
 
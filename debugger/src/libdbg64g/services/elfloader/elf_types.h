@@ -144,10 +144,12 @@ class ElfHeaderType {
                 e_shoff_ = SwapBytes(h->e_shoff);
                 e_shnum_ = SwapBytes(h->e_shnum);
                 e_phoff_ = SwapBytes(h->e_phoff);
+                e_phnum_ = SwapBytes(h->e_phnum);
             } else {
                 e_shoff_ = h->e_shoff;
                 e_shnum_ = h->e_shnum;
                 e_phoff_ = h->e_phoff;
+                e_phnum_ = h->e_phnum;
             }
         } else {
             Elf64_Ehdr *h = reinterpret_cast<Elf64_Ehdr *>(pimg_);
@@ -155,20 +157,24 @@ class ElfHeaderType {
                 e_shoff_ = SwapBytes(h->e_shoff);
                 e_shnum_ = SwapBytes(h->e_shnum);
                 e_phoff_ = SwapBytes(h->e_phoff);
+                e_phnum_ = SwapBytes(h->e_phnum);
             } else {
                 e_shoff_ = h->e_shoff;
                 e_shnum_ = h->e_shnum;
                 e_phoff_ = h->e_phoff;
+                e_phnum_ = h->e_phnum;
             }
         }
     }
 
+    virtual ~ElfHeaderType() {}
     virtual bool isElf() { return isElf_; }
     virtual bool isElf32() { return is32b_; }
     virtual bool isElfMsb() { return isMsb_; }
     virtual uint64_t get_shoff() { return e_shoff_; }
     virtual ElfHalf get_shnum() { return e_shnum_; }
     virtual uint64_t get_phoff() { return e_phoff_; }
+    virtual ElfHalf get_phnum() { return e_phnum_; }
  protected:
     uint8_t *pimg_;
     bool isElf_;
@@ -177,6 +183,7 @@ class ElfHeaderType {
     uint64_t e_shoff_;
     ElfHalf e_shnum_;
     uint64_t e_phoff_;
+    ElfHalf e_phnum_;
 };
 
    
@@ -274,6 +281,7 @@ class SectionHeaderType {
             }
         }
     }
+    virtual ~SectionHeaderType() {}
     virtual ElfWord get_name() { return sh_name_; }
     virtual ElfWord get_type() { return sh_type_; }
     virtual uint64_t get_offset() { return sh_offset_; }
@@ -381,29 +389,76 @@ static const ElfWord PT_PHDR     = 6;
 static const ElfWord PT_LOPROC   = 0x70000000;
 static const ElfWord PT_HIPROC   = 0x7fffffff;
 
-typedef struct ProgramHeaderType64
-{
-  uint32_t    p_type;
-  uint32_t    p_offset;
-  uint64_t    p_vaddr;
-  uint64_t    p_paddr;
-    ElfDWord	p_filesz;
-    ElfDWord	p_memsz;
-    ElfDWord	p_flags;
-    ElfDWord	p_align;
-} ProgramHeaderType64;
-
-typedef struct ProgramHeaderType32
-{
-  uint32_t    p_type;
-  uint32_t    p_offset;
-  ElfAddr32    p_vaddr;
-  ElfAddr32    p_paddr;
-  ElfWord	p_filesz;
-  ElfWord	p_memsz;
-  ElfWord	p_flags;
-  ElfWord	p_align;
-} ProgramHeaderType32;
+struct Elf32_Phdr {
+    ElfWord    p_type;
+    ElfOff32   p_offset;
+    ElfAddr32  p_vaddr;
+    ElfAddr32  p_paddr;
+    ElfWord    p_filesz;
+    ElfWord    p_memsz;
+    ElfWord    p_flags;
+    ElfWord    p_align;
+};
+
+struct Elf64_Phdr {
+    ElfWord    p_type;
+    ElfWord    p_flags;
+    ElfOff64   p_offset;
+    ElfAddr64  p_vaddr;
+    ElfAddr64  p_paddr;
+    ElfDWord   p_filesz;
+    ElfDWord   p_memsz;
+    ElfDWord   p_align;
+};
+
+class ProgramHeaderType {
+ public:
+    ProgramHeaderType(uint8_t *img, ElfHeaderType *h) {
+        if (h->isElf32()) {
+            Elf32_Phdr *ph = reinterpret_cast<Elf32_Phdr *>(img);
+            if (h->isElfMsb()) {
+                p_type_ = SwapBytes(ph->p_type);
+                p_offset_ = SwapBytes(ph->p_offset);
+                p_paddr_ = SwapBytes(ph->p_paddr);
+                p_filesz_ = SwapBytes(ph->p_filesz);
+                p_memsz_ = SwapBytes(ph->p_memsz);
+            } else {
+                p_type_ = ph->p_type;
+                p_offset_ = ph->p_offset;
+                p_paddr_ = ph->p_paddr;
+                p_filesz_ = ph->p_filesz;
+                p_memsz_ = ph->p_memsz;
+            }
+        } else {
+            Elf64_Phdr *ph = reinterpret_cast<Elf64_Phdr *>(img);
+            if (h->isElfMsb()) {
+                p_type_ = SwapBytes(ph->p_type);
+                p_offset_ = SwapBytes(ph->p_offset);
+                p_paddr_ = SwapBytes(ph->p_paddr);
+                p_filesz_ = SwapBytes(ph->p_filesz);
+                p_memsz_ = SwapBytes(ph->p_memsz);
+            } else {
+                p_type_ = ph->p_type;
+                p_offset_ = ph->p_offset;
+                p_paddr_ = ph->p_paddr;
+                p_filesz_ = ph->p_filesz;
+                p_memsz_ = ph->p_memsz;
+            }
+        }
+    }
+    virtual ~ProgramHeaderType() {}
+    virtual ElfWord get_type() { return p_type_; }
+    virtual uint64_t get_offset() { return p_offset_; }
+    virtual uint64_t get_paddr() { return p_paddr_; }
+    virtual uint64_t get_filesz() { return p_filesz_; }
+    virtual uint64_t get_memsz() { return p_memsz_; }
+ protected:
+    ElfWord p_type_;
+    uint64_t p_offset_;
+    uint64_t p_paddr_;
+    uint64_t p_filesz_;
+    uint64_t p_memsz_;
+};
 
 }  // namespace debugger
 
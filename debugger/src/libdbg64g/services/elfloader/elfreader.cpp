@@ -16,24 +16,39 @@
 
 #include "elfreader.h"
 #include <iostream>
+#include <stdlib.h>
 
 namespace debugger {
 
 ElfReaderService::ElfReaderService(const char *name) : IService(name) {
     registerInterface(static_cast<IElfReader *>(this));
+    registerInterface(static_cast<ISymbolTable *>(this));
     registerAttribute("SourceProc", &sourceProc_);
     image_ = NULL;
+    imageSize_ = 0;
+    zeroes_ = NULL;
+    header_ = NULL;
+    sh_tbl_ = NULL;
     sectionNames_ = NULL;
-    symbolList_.make_list(0);
-    loadSectionList_.make_list(0);
+    sectionNamesSize_ = 0;
+    symbolNames_ = NULL;
+    symbolNamesSize_ = 0;
+    loadSections_ = NULL;
+    loadSectionTotal_ = 0;
+    loadSegments_ = NULL;
+    loadSegmentTotal_ = 0;
+    symbolsParsed_ = false;
+    symbols_ = NULL;
+    symbolsByName_ = NULL;
+    symbolTotal_ = 0;
     sourceProc_.make_string("");
     isrc_ = 0;
+    RISCV_mutex_init(&mutexSymbols_);
 }
 
 ElfReaderService::~ElfReaderService() {
-    if (image_) {
-        delete image_;
-    }
+    freeImage();
+    RISCV_mutex_destroy(&mutexSymbols_);
 }
 
 void ElfReaderService::postinitService() {
@@ -46,48 +61,118 @@ void ElfReaderService::postinitService() {
     }
 }
 
+void ElfReaderService::freeImage() {
+    if (sh_tbl_) {
+        for (int i = 0; i < header_->get_shnum(); i++) {
+            delete sh_tbl_[i];
+        }
+        delete [] sh_tbl_;
+        sh_tbl_ = NULL;
+    }
+    if (header_) {
+        delete header_;
+        header_ = NULL;
+    }
+    if (image_) {
+        RISCV_file_unmap(image_, imageSize_);
+        image_ = NULL;
+        imageSize_ = 0;
+    }
+    if (zeroes_) {
+        delete [] zeroes_;
+        zeroes_ = NULL;
+    }
+    if (loadSections_) {
+        delete [] loadSections_;
+        loadSections_ = NULL;
+    }
+    loadSectionTotal_ = 0;
+    if (loadSegments_) {
+        delete [] loadSegments_;
+        loadSegments_ = NULL;
+    }
+    loadSegmentTotal_ = 0;
+    if (symbols_) {
+        delete [] symbols_;
+        symbols_ = NULL;
+    }
+    if (symbolsByName_) {
+        delete [] symbolsByName_;
+        symbolsByName_ = NULL;
+    }
+    symbolTotal_ = 0;
+    symbolsParsed_ = false;
+    sectionNames_ = NULL;
+    sectionNamesSize_ = 0;
+    symbolNames_ = NULL;
+    symbolNamesSize_ = 0;
+}
+
 int ElfReaderService::readFile(const char *filename) {
-    FILE *fp = fopen(filename, "rb");
-    if (!fp) {
+    int ret;
+    // Symbol lookups may parse the previous image from other threads
+    RISCV_mutex_lock(&mutexSymbols_);
+    ret = openImage(filename);
+    RISCV_mutex_unlock(&mutexSymbols_);
+    return ret;
+}
+
+int ElfReaderService::openImage(const char *filename) {
+    freeImage();
+
+    /** Sections and symbols are accessed directly in the mapped file */
+    image_ = reinterpret_cast<uint8_t *>(
+                RISCV_file_map(filename, &imageSize_));
+    if (!image_) {
         RISCV_error("File '%s' not found", filename);
         return -1;
     }
-    fseek(fp, 0, SEEK_END);
-    int sz = ftell(fp);
-    rewind(fp);
 
-    if (image_) {
-        delete image_;
-        sectionNames_ = NULL;
-        sourceProc_.make_list(0);
-        symbolList_.make_list(0);
-        loadSectionList_.make_list(0);
+    if (readElfHeader() != 0) {
+        return -1;
     }
-    image_ = new uint8_t[sz];
-    fread(image_, 1, sz, fp);
 
-    if (readElfHeader() != 0) {
-        fclose(fp);
-        return 0;
+    if (header_->get_phoff() && loadSegments() != 0) {
+        return -1;
     }
 
-    symbolNames_ = 0;
     if (!header_->get_shoff()) {
-        fclose(fp);
         return 0;
     }
 
+    uint64_t shentsize = header_->isElf32() ? sizeof(Elf32_Shdr)
+                                            : sizeof(Elf64_Shdr);
+    if (!isInImage(header_->get_shoff(),
+                   header_->get_shnum() * shentsize)) {
+        RISCV_error("Section headers are out of file", NULL);
+        return -1;
+    }
+
     sh_tbl_ = new SectionHeaderType *[header_->get_shnum()];
 
     /** Search .shstrtab section */
     uint8_t *psh = &image_[header_->get_shoff()];
     for (int i = 0; i < header_->get_shnum(); i++) {
         sh_tbl_[i] = new SectionHeaderType(psh, header_);
+        if (sh_tbl_[i]->get_type() != SHT_NOBITS
+            && !isInImage(sh_tbl_[i]->get_offset(), sh_tbl_[i]->get_size())) {
+            RISCV_error("Section %d is out of file", i);
+            // Remaining entries must be valid for freeImage()
+            for (int n = i + 1; n < header_->get_shnum(); n++) {
+                sh_tbl_[n] = NULL;
+            }
+            return -1;
+        }
 
-        sectionNames_ = reinterpret_cast<char *>(&image_[sh_tbl_[i]->get_offset()]);
-        if (sh_tbl_[i]->get_type() == SHT_STRTAB && 
-            strcmp(sectionNames_ + sh_tbl_[i]->get_name(), ".shstrtab") != 0) {
-            sectionNames_ = NULL;
+        if (sh_tbl_[i]->get_type() == SHT_STRTAB) {
+            char *tbl = reinterpret_cast<char *>(
+                            &image_[sh_tbl_[i]->get_offset()]);
+            const char *name = tableString(tbl, sh_tbl_[i]->get_size(),
+                                           sh_tbl_[i]->get_name());
+            if (name && strcmp(name, ".shstrtab") == 0) {
+                sectionNames_ = tbl;
+                sectionNamesSize_ = sh_tbl_[i]->get_size();
+            }
         }
 
         if (header_->isElf32()) {
@@ -102,12 +187,15 @@ int ElfReaderService::readFile(const char *filename) {
 
     /** Search ".strtab" section with Debug symbols */
     SectionHeaderType *sh;
+    const char *secname;
     for (int i = 0; i < header_->get_shnum(); i++) {
         sh = sh_tbl_[i];
         if (sectionNames_ == NULL || sh->get_type() != SHT_STRTAB) {
             continue;
         }
-        if (strcmp(sectionNames_ + sh->get_name(), ".strtab")) {
+        secname = tableString(sectionNames_, sectionNamesSize_,
+                              sh->get_name());
+        if (secname == NULL || strcmp(secname, ".strtab")) {
             continue;
         }
         /** 
@@ -118,6 +206,7 @@ int ElfReaderService::readFile(const char *filename) {
             * SHF_ALLOC bit; otherwise, that bit will be turned off.
             */
         symbolNames_ = reinterpret_cast<char *>(&image_[sh->get_offset()]);
+        symbolNamesSize_ = sh->get_size();
     }
     if (!symbolNames_) {
         printf("err: section .strtab not found. No debug symbols.\n");
@@ -127,145 +216,291 @@ int ElfReaderService::readFile(const char *filename) {
     int bytes_loaded = loadSections();
     RISCV_info("Loaded: %d B", bytes_loaded);
 
-    if (header_->get_phoff()) {
-        //readProgramHeader();
+    if (isrc_) {
+        // Symbols are parsed on the first lookup via ISymbolTable
+        isrc_->setSymbolTable(static_cast<ISymbolTable *>(this));
     }
-
-    fclose(fp);
     return 0;
 }
 
+const char *ElfReaderService::tableString(const char *tbl, uint64_t tblsize,
+                                          uint64_t off) {
+    if (tbl == NULL || off >= tblsize) {
+        return NULL;
+    }
+    if (memchr(tbl + off, 0, static_cast<size_t>(tblsize - off)) == NULL) {
+        return NULL;
+    }
+    return tbl + off;
+}
+
 int ElfReaderService::readElfHeader() {
+    if (imageSize_ < sizeof(Elf32_Ehdr)) {
+        RISCV_error("File format is not ELF", NULL);
+        return -1;
+    }
     header_ = new ElfHeaderType(image_);
-    if (header_->isElf()) {
-        return 0;
+    if (!header_->isElf()) {
+        RISCV_error("File format is not ELF", NULL);
+        return -1;
+    }
+    if (!header_->isElf32() && imageSize_ < sizeof(Elf64_Ehdr)) {
+        RISCV_error("Truncated ELF header", NULL);
+        return -1;
     }
-    RISCV_error("File format is not ELF", NULL);
-    return -1;
+    return 0;
+}
+
+int ElfReaderService::loadSegments() {
+    ProgramHeaderType *ph;
+    uint64_t phentsize = header_->isElf32() ? sizeof(Elf32_Phdr)
+                                            : sizeof(Elf64_Phdr);
+    if (!isInImage(header_->get_phoff(),
+                   header_->get_phnum() * phentsize)) {
+        RISCV_error("Program headers are out of file", NULL);
+        return -1;
+    }
+    uint8_t *pph = &image_[header_->get_phoff()];
+
+    loadSegments_ = new LoadSegmentType[header_->get_phnum()];
+    for (int i = 0; i < header_->get_phnum(); i++) {
+        ph = new ProgramHeaderType(pph, header_);
+        if (ph->get_type() == PT_LOAD
+            && (ph->get_memsz() < ph->get_filesz()
+                || !isInImage(ph->get_offset(), ph->get_filesz()))) {
+            RISCV_error("Malformed PT_LOAD segment %d", i);
+            delete ph;
+            return -1;
+        }
+        if (ph->get_type() == PT_LOAD && ph->get_memsz()) {
+            LoadSegmentType &seg = loadSegments_[loadSegmentTotal_++];
+            seg.addr = ph->get_paddr();
+            seg.filesz = ph->get_filesz();
+            seg.memsz = ph->get_memsz();
+            seg.data = &image_[ph->get_offset()];
+        }
+        delete ph;
+        pph += phentsize;
+    }
+    return 0;
 }
 
 int ElfReaderService::loadSections() {
     SectionHeaderType *sh;
+    const char *secname;
     uint64_t total_bytes = 0;
-    AttributeType tsymb;
+    uint64_t nobits_max = 0;
 
+    loadSections_ = new LoadSectionType[header_->get_shnum()];
     for (int i = 0; i < header_->get_shnum(); i++) {
         sh = sh_tbl_[i];
 
-        if (sh->get_size() == 0) {
+        if (sh->get_size() == 0 || (sh->get_flags() & SHF_ALLOC) == 0) {
             continue;
         }
 
-        if (sectionNames_ && (sh->get_flags() & SHF_ALLOC)) {
-            RISCV_info("Reading '%s' section", &sectionNames_[sh->get_name()]);
+        secname = tableString(sectionNames_, sectionNamesSize_,
+                              sh->get_name());
+        if (secname) {
+            RISCV_info("Reading '%s' section", secname);
         }
 
-        if ((sh->get_type() == SHT_PROGBITS ||
-             sh->get_type() == SHT_INIT_ARRAY ||
-             sh->get_type() == SHT_FINI_ARRAY ||
-             sh->get_type() == SHT_PREINIT_ARRAY) &&
-             (sh->get_flags() & SHF_ALLOC) != 0) {
+        if (sh->get_type() == SHT_PROGBITS ||
+            sh->get_type() == SHT_INIT_ARRAY ||
+            sh->get_type() == SHT_FINI_ARRAY ||
+            sh->get_type() == SHT_PREINIT_ARRAY ||
+            sh->get_type() == SHT_NOBITS) {
             /**
-             * @brief   Instructions or other processor's information
-             * @details This section holds information defined by the program, 
-             *          whose format and meaning are determined solely by the
-             *          program.
+             * SHT_PROGBITS: instructions or other processor's information
+             * SHT_NOBITS: occupies no space in the file but otherwise
+             *             resembles SHT_PROGBITS. Its data points to the
+             *             shared zero filled buffer.
              */
-            AttributeType loadsec;
-            loadsec.make_list(LoadSh_Total);
-            if (sectionNames_) {
-                loadsec[LoadSh_name].make_string(&sectionNames_[sh->get_name()]);
+            LoadSectionType &sec = loadSections_[loadSectionTotal_++];
+            if (secname) {
+                sec.name = secname;
             } else {
-                loadsec[LoadSh_name].make_string("unknown");
+                sec.name = "unknown";
             }
-            loadsec[LoadSh_addr].make_uint64(sh->get_addr());
-            loadsec[LoadSh_size].make_uint64(sh->get_size());
-            loadsec[LoadSh_data].make_data(static_cast<unsigned>(sh->get_size()),
-                                           &image_[sh->get_offset()]);
-            loadSectionList_.add_to_list(&loadsec);
-            total_bytes += sh->get_size();
-        } else if (sh->get_type() == SHT_NOBITS
-                    && (sh->get_flags() & SHF_ALLOC) != 0) {
-            /**
-             * @brief   Initialized data
-             * @details A section of this type occupies no space in  the file
-             *          but otherwise resembles SHT_PROGBITS.  Although this
-             *          section contains no bytes, the sh_offset member
-             *          contains the conceptual file offset.
-             */
-            AttributeType loadsec;
-            loadsec.make_list(LoadSh_Total);
-            if (sectionNames_) {
-                loadsec[LoadSh_name].make_string(&sectionNames_[sh->get_name()]);
+            sec.addr = sh->get_addr();
+            sec.size = sh->get_size();
+            sec.exec = (sh->get_flags() & SHF_EXECINSTR) != 0;
+            if (sh->get_type() == SHT_NOBITS) {
+                sec.data = NULL;
+                if (sec.size > nobits_max) {
+                    nobits_max = sec.size;
+                }
             } else {
-                loadsec[LoadSh_name].make_string("unknown");
+                sec.data = &image_[sh->get_offset()];
             }
-            loadsec[LoadSh_addr].make_uint64(sh->get_addr());
-            loadsec[LoadSh_size].make_uint64(sh->get_size());
-            loadsec[LoadSh_data].make_data(static_cast<unsigned>(sh->get_size()));
-            memset(loadsec[LoadSh_data].data(), 
-                        0, static_cast<size_t>(sh->get_size()));
-            loadSectionList_.add_to_list(&loadsec);
             total_bytes += sh->get_size();
-        } else if (sh->get_type() == SHT_SYMTAB || sh->get_type() == SHT_DYNSYM) {
-            processDebugSymbol(sh);
         }
     }
-    symbolList_.sort(LoadSh_name);
-    if (isrc_) {
-        isrc_->addSymbols(&symbolList_);
+
+    if (nobits_max) {
+        zeroes_ = new uint8_t[static_cast<size_t>(nobits_max)];
+        memset(zeroes_, 0, static_cast<size_t>(nobits_max));
+        for (unsigned i = 0; i < loadSectionTotal_; i++) {
+            if (loadSections_[i].data == NULL) {
+                loadSections_[i].data = zeroes_;
+            }
+        }
     }
     return static_cast<int>(total_bytes);
 }
 
-void ElfReaderService::processDebugSymbol(SectionHeaderType *sh) {
-    uint64_t symbol_off = 0;
+int ElfReaderService::cmpSymbolAddr(const void *a, const void *b) {
+    uint64_t a1 = static_cast<const SymbolEntryType *>(a)->addr;
+    uint64_t b1 = static_cast<const SymbolEntryType *>(b)->addr;
+    return a1 < b1 ? -1 : (a1 > b1 ? 1 : 0);
+}
+
+int ElfReaderService::cmpSymbolName(const void *a, const void *b) {
+    return strcmp((*static_cast<SymbolEntryType *const *>(a))->name,
+                  (*static_cast<SymbolEntryType *const *>(b))->name);
+}
+
+/** Called with mutexSymbols_ locked */
+void ElfReaderService::processDebugSymbols() {
+    SectionHeaderType *sh;
     SymbolTableType *st;
-    AttributeType tsymb;
+    uint64_t symbol_off;
+    uint64_t entsize;
     uint8_t st_type;
-    const char *symb_name;
-    //const char *file_name = 0;
+    const char *st_name;
+    unsigned max_total = 0;
 
-    if (!symbolNames_) {
+    if (symbolsParsed_ || !symbolNames_) {
         return;
     }
+    symbolsParsed_ = true;
 
-    while (symbol_off < sh->get_size()) {
-        st = new SymbolTableType(&image_[sh->get_offset() + symbol_off],
-                                header_);
-        
-        symb_name = &symbolNames_[st->get_name()];
-
-        st_type = st->get_info() & 0xF;
-        if ((st_type == STT_OBJECT || st_type == STT_FUNC) && st->get_value()) {
-            tsymb.make_list(Symbol_Total);
-            tsymb[Symbol_Name].make_string(symb_name);
-            tsymb[Symbol_Addr].make_uint64(st->get_value() & ~1ull);
-            tsymb[Symbol_Size].make_uint64(st->get_size());
-            if (st_type == STT_FUNC) {
-                tsymb[Symbol_Type].make_uint64(SYMBOL_TYPE_FUNCTION);
-            } else {
-                tsymb[Symbol_Type].make_uint64(SYMBOL_TYPE_DATA);
-            }
-            symbolList_.add_to_list(&tsymb);
-        } else if (st_type == STT_FILE) {
-            //file_name = symb_name;
+    entsize = header_->isElf32() ? sizeof(Elf32_Sym) : sizeof(Elf64_Sym);
+    for (int i = 0; i < header_->get_shnum(); i++) {
+        sh = sh_tbl_[i];
+        if (sh->get_type() == SHT_SYMTAB || sh->get_type() == SHT_DYNSYM) {
+            max_total += static_cast<unsigned>(sh->get_size() / entsize);
         }
+    }
+    if (max_total == 0) {
+        return;
+    }
+
+    symbols_ = new SymbolEntryType[max_total];
+    for (int i = 0; i < header_->get_shnum(); i++) {
+        sh = sh_tbl_[i];
+        if (sh->get_type() != SHT_SYMTAB && sh->get_type() != SHT_DYNSYM) {
+            continue;
+        }
+        symbol_off = 0;
+        while (symbol_off + entsize <= sh->get_size()
+                && symbolTotal_ < max_total) {
+            st = new SymbolTableType(&image_[sh->get_offset() + symbol_off],
+                                     header_);
+            st_type = st->get_info() & 0xF;
+            st_name = tableString(symbolNames_, symbolNamesSize_,
+                                  st->get_name());
+            if ((st_type == STT_OBJECT || st_type == STT_FUNC)
+                && st->get_value() && st_name) {
+                SymbolEntryType &e = symbols_[symbolTotal_++];
+                e.name = st_name;
+                e.addr = st->get_value() & ~1ull;
+                e.size = st->get_size();
+                e.type = st_type;
+            }
+            delete st;
 
-        if (sh->get_entsize()) {
             // section with elements of fixed size
-            symbol_off += sh->get_entsize(); 
-        } else if (st->get_size()) {
-            symbol_off += st->get_size();
-        } else {
-            if (header_->isElf32()) {
-                symbol_off += sizeof(Elf32_Sym);
+            if (sh->get_entsize()) {
+                symbol_off += sh->get_entsize(); 
             } else {
-                symbol_off += sizeof(Elf64_Sym);
+                symbol_off += entsize;
             }
         }
-        delete st;
     }
+
+    qsort(symbols_, symbolTotal_, sizeof(SymbolEntryType), cmpSymbolAddr);
+    symbolsByName_ = new SymbolEntryType *[symbolTotal_ ? symbolTotal_ : 1];
+    for (unsigned i = 0; i < symbolTotal_; i++) {
+        symbolsByName_[i] = &symbols_[i];
+    }
+    qsort(symbolsByName_, symbolTotal_, sizeof(SymbolEntryType *),
+          cmpSymbolName);
+}
+
+void ElfReaderService::getSymbols(AttributeType *list) {
+    RISCV_mutex_lock(&mutexSymbols_);
+    processDebugSymbols();
+    list->make_list(symbolTotal_);
+    for (unsigned i = 0; i < symbolTotal_; i++) {
+        SymbolEntryType &e = *symbolsByName_[i];
+        AttributeType &item = (*list)[i];
+        item.make_list(Symbol_Total);
+        item[Symbol_Name].make_string(e.name);
+        item[Symbol_Addr].make_uint64(e.addr);
+        item[Symbol_Size].make_uint64(e.size);
+        if (e.type == STT_FUNC) {
+            item[Symbol_Type].make_uint64(SYMBOL_TYPE_FUNCTION);
+        } else {
+            item[Symbol_Type].make_uint64(SYMBOL_TYPE_DATA);
+        }
+    }
+    RISCV_mutex_unlock(&mutexSymbols_);
+}
+
+bool ElfReaderService::addressToSymbol(uint64_t addr, AttributeType *info) {
+    bool ret = false;
+    RISCV_mutex_lock(&mutexSymbols_);
+    processDebugSymbols();
+    // Last symbol with address <= addr
+    unsigned lo = 0;
+    unsigned hi = symbolTotal_;
+    while (lo < hi) {
+        unsigned mid = (lo + hi) / 2;
+        if (symbols_[mid].addr <= addr) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    if (lo != 0) {
+        SymbolEntryType &e = symbols_[lo - 1];
+        uint64_t send = e.addr + e.size;
+        if (lo < symbolTotal_) {
+            send = symbols_[lo].addr;
+        }
+        if (addr < send) {
+            info->make_list(2);
+            (*info)[0u].make_string(e.name);
+            (*info)[1].make_uint64(addr - e.addr);
+            ret = true;
+        }
+    }
+    RISCV_mutex_unlock(&mutexSymbols_);
+    return ret;
+}
+
+int ElfReaderService::symbol2Address(const char *name, uint64_t *addr) {
+    int ret = -1;
+    RISCV_mutex_lock(&mutexSymbols_);
+    processDebugSymbols();
+    unsigned lo = 0;
+    unsigned hi = symbolTotal_;
+    while (lo < hi) {
+        unsigned mid = (lo + hi) / 2;
+        int cmp = strcmp(symbolsByName_[mid]->name, name);
+        if (cmp == 0) {
+            *addr = symbolsByName_[mid]->addr;
+            ret = 0;
+            break;
+        } else if (cmp < 0) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    RISCV_mutex_unlock(&mutexSymbols_);
+    return ret;
 }
 
 }  // namespace debugger
@@ -27,7 +27,8 @@
 namespace debugger {
 
 class ElfReaderService : public IService,
-                         public IElfReader {
+                         public IElfReader,
+                         public ISymbolTable {
 public:
     explicit ElfReaderService(const char *name);
     virtual ~ElfReaderService();
@@ -39,37 +40,93 @@ public:
     virtual int readFile(const char *filename);
 
     virtual unsigned loadableSectionTotal() {
-        return loadSectionList_.size();
+        return loadSectionTotal_;
     }
 
     virtual const char *sectionName(unsigned idx) {
-        return loadSectionList_[idx][LoadSh_name].to_string();
+        return loadSections_[idx].name;
     }
 
     virtual uint64_t sectionAddress(unsigned idx)  {
-        return loadSectionList_[idx][LoadSh_addr].to_uint64();
+        return loadSections_[idx].addr;
     }
 
     virtual uint64_t sectionSize(unsigned idx)  {
-        return loadSectionList_[idx][LoadSh_size].to_uint64();
+        return loadSections_[idx].size;
     }
 
     virtual uint8_t *sectionData(unsigned idx)  {
-        return loadSectionList_[idx][LoadSh_data].data();
+        return loadSections_[idx].data;
     }
 
+    virtual bool sectionExecutable(unsigned idx) {
+        return loadSections_[idx].exec;
+    }
+
+    virtual unsigned loadableSegmentTotal() {
+        return loadSegmentTotal_;
+    }
+
+    virtual uint64_t segmentAddress(unsigned idx) {
+        return loadSegments_[idx].addr;
+    }
+
+    virtual uint64_t segmentFileSize(unsigned idx) {
+        return loadSegments_[idx].filesz;
+    }
+
+    virtual uint64_t segmentMemSize(unsigned idx) {
+        return loadSegments_[idx].memsz;
+    }
+
+    virtual uint8_t *segmentData(unsigned idx) {
+        return loadSegments_[idx].data;
+    }
+
+    /** ISymbolTable interface */
+    virtual void getSymbols(AttributeType *list);
+    virtual bool addressToSymbol(uint64_t addr, AttributeType *info);
+    virtual int symbol2Address(const char *name, uint64_t *addr);
+
 private:
+    void freeImage();
+    int openImage(const char *filename);
     int readElfHeader();
     int loadSections();
-    void processDebugSymbol(SectionHeaderType *sh);
+    int loadSegments();
+    void processDebugSymbols();
+    static int cmpSymbolAddr(const void *a, const void *b);
+    static int cmpSymbolName(const void *a, const void *b);
+    bool isInImage(uint64_t off, uint64_t sz) {
+        return off <= imageSize_ && sz <= imageSize_ - off;
+    }
+    /** String of the table or NULL if it isn't terminated inside table */
+    static const char *tableString(const char *tbl, uint64_t tblsize,
+                                   uint64_t off);
 
 private:
-    enum ELoadSectionItem {
-        LoadSh_name,
-        LoadSh_addr,
-        LoadSh_size,
-        LoadSh_data,
-        LoadSh_Total,
+    /** Section data is a view into the mapped file or into zeroes_ */
+    struct LoadSectionType {
+        const char *name;
+        uint64_t addr;
+        uint64_t size;
+        uint8_t *data;
+        bool exec;
+    };
+
+    struct LoadSegmentType {
+        uint64_t addr;
+        uint64_t filesz;
+        uint64_t memsz;
+        uint8_t *data;
+    };
+
+    /** Compact symbol entry. Name points into the mapped .strtab */
+    struct SymbolEntryType {
+        const char *name;
+        uint64_t addr;
+        uint64_t size;
+        uint8_t type;
     };
 
     enum EMode {
@@ -78,15 +135,29 @@ private:
     } emode_;
 
     AttributeType sourceProc_;
-    AttributeType symbolList_;
-    AttributeType loadSectionList_;
 
     ISourceCode *isrc_;
     uint8_t *image_;
+    uint64_t imageSize_;
+    uint8_t *zeroes_;
     ElfHeaderType *header_;
     SectionHeaderType **sh_tbl_;
     char *sectionNames_;
+    uint64_t sectionNamesSize_;
     char *symbolNames_;
+    uint64_t symbolNamesSize_;
+
+    LoadSectionType *loadSections_;
+    unsigned loadSectionTotal_;
+    LoadSegmentType *loadSegments_;
+    unsigned loadSegmentTotal_;
+
+    /** Symbol tables are parsed on the first lookup */
+    bool symbolsParsed_;
+    SymbolEntryType *symbols_;          // sorted by address
+    SymbolEntryType **symbolsByName_;   // sorted by name
+    unsigned symbolTotal_;
+    mutex_def mutexSymbols_;
 };
 
 DECLARE_CLASS(ElfReaderService)
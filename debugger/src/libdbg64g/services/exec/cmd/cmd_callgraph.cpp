@@ -0,0 +1,271 @@
+/*
+ *  Copyright 2023 Sergey Khabarov, sergeykhbr@gmail.com
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include "cmd_callgraph.h"
+
+namespace debugger {
+
+CmdCallGraph::CmdCallGraph(IService *parent)
+    : ICommand(parent, "callgraph") {
+
+    briefDescr_.make_string("Exact call graph of the functional CPU model");
+    detailedDescr_.make_string(
+        "Description:\n"
+        "    Enable/disable call graph accumulation in the functional CPU\n"
+        "    models, get per-function inclusive/exclusive executed\n"
+        "    instructions or save call graph in callgrind format. Call\n"
+        "    and return instructions update the counters, so the result\n"
+        "    doesn't depend on sampling. Report is sorted by inclusive\n"
+        "    instructions.\n"
+        "Usage:\n"
+        "    callgraph on|off|clear\n"
+        "    callgraph [<top>]        - functions list\n"
+        "    callgraph edges          - caller-callee list\n"
+        "    callgraph save <file>    - callgrind file\n"
+        "Output format:\n"
+        "    [[s,i,i,i],...] or [[s,s,i,i],...]\n"
+        "         s - function name.\n"
+        "         i - number of calls (uint64_t).\n"
+        "         i - inclusive instructions (uint64_t).\n"
+        "         i - exclusive instructions (uint64_t).\n"
+        "         s - caller, callee function names.\n"
+        "Example:\n"
+        "    callgraph on\n"
+        "    callgraph 20\n"
+        "    callgraph save boot.callgrind\n");
+
+    isrc_ = 0;
+}
+
+int CmdCallGraph::isValid(AttributeType *args) {
+    if (!cmdName_.is_equal((*args)[0u].to_string())) {
+        return CMD_INVALID;
+    }
+    if (args->size() == 1) {
+        return CMD_VALID;
+    }
+    if (args->size() == 2
+        && ((*args)[1].is_string() || (*args)[1].is_integer())) {
+        return CMD_VALID;
+    }
+    if (args->size() == 3 && (*args)[1].is_equal("save")
+        && (*args)[2].is_string()) {
+        return CMD_VALID;
+    }
+    return CMD_WRONG_ARGS;
+}
+
+void CmdCallGraph::exec(AttributeType *args, AttributeType *res) {
+    AttributeType funcs, edges;
+    res->attr_free();
+    res->make_nil();
+
+    if (lstServ_.size() == 0) {
+        RISCV_get_services_with_iface(IFACE_CALL_GRAPH, &lstServ_);
+    }
+    if (lstServ_.size() == 0) {
+        generateError(res, "Call graph isn't supported by CPU model");
+        return;
+    }
+    if (!isrc_) {
+        AttributeType lstSrc;
+        RISCV_get_services_with_iface(IFACE_SOURCE_CODE, &lstSrc);
+        if (lstSrc.size() != 0) {
+            IService *iserv = static_cast<IService *>(lstSrc[0u].to_iface());
+            isrc_ = static_cast<ISourceCode *>(
+                                iserv->getInterface(IFACE_SOURCE_CODE));
+        }
+    }
+
+    if (args->size() == 2 && (*args)[1].is_string()) {
+        for (unsigned i = 0; i < lstServ_.size(); i++) {
+            IService *iserv = static_cast<IService *>(lstServ_[i].to_iface());
+            ICallGraph *icg = static_cast<ICallGraph *>(
+                                iserv->getInterface(IFACE_CALL_GRAPH));
+            if ((*args)[1].is_equal("on")) {
+                icg->enableCallGraph(true);
+            } else if ((*args)[1].is_equal("off")) {
+                icg->enableCallGraph(false);
+            } else if ((*args)[1].is_equal("clear")) {
+                icg->clearCallGraph();
+            } else if (!(*args)[1].is_equal("edges")) {
+                generateError(res, "Wrong command format");
+                return;
+            }
+        }
+        if (!(*args)[1].is_equal("edges")) {
+            return;
+        }
+    }
+
+    collect(&funcs, &edges);
+    if (args->size() == 3) {
+        if (!saveCallgrind((*args)[2].to_string(), &funcs, &edges)) {
+            generateError(res, "Cannot open file");
+        }
+        return;
+    }
+    if (args->size() == 2 && (*args)[1].is_equal("edges")) {
+        res->make_list(edges.size());
+        for (unsigned i = 0; i < edges.size(); i++) {
+            AttributeType &e = edges[i];
+            (*res)[i].make_list(4);
+            (*res)[i][0u] = e[3];
+            (*res)[i][1] = e[4];
+            (*res)[i][2] = e[1];
+            (*res)[i][3] = e[2];
+        }
+        return;
+    }
+
+    // Descending order of inclusive instructions
+    unsigned top = funcs.size();
+    if (args->size() == 2 && (*args)[1].to_uint32()
+        && (*args)[1].to_uint32() < top) {
+        top = (*args)[1].to_uint32();
+    }
+    AttributeType srt;
+    srt.make_list(funcs.size());
+    for (unsigned i = 0; i < funcs.size(); i++) {
+        srt[i].make_list(2);
+        srt[i][0u] = funcs[i][2];
+        srt[i][1].make_uint64(i);
+    }
+    srt.sort(0);
+    res->make_list(top);
+    for (unsigned i = 0; i < top; i++) {
+        unsigned idx = srt[srt.size() - 1 - i][1].to_uint32();
+        (*res)[i] = funcs[idx];
+    }
+}
+
+void CmdCallGraph::symbolName(uint64_t addr, char *buf, size_t bufsz) {
+    AttributeType info;
+    if (isrc_) {
+        // [name, offset]
+        isrc_->addressToSymbol(addr, &info);
+    }
+    if (isrc_ && info[0u].size()) {
+        RISCV_sprintf(buf, bufsz, "%s", info[0u].to_string());
+    } else {
+        RISCV_sprintf(buf, bufsz, "0x%08" RV_PRI64 "x", addr);
+    }
+}
+
+void CmdCallGraph::collect(AttributeType *funcs, AttributeType *edges) {
+    AttributeType f, e, item;
+    char caller[256];
+    char callee[256];
+    char key[512];
+
+    funcs->make_list(0);
+    edges->make_list(0);
+    for (unsigned n = 0; n < lstServ_.size(); n++) {
+        IService *iserv = static_cast<IService *>(lstServ_[n].to_iface());
+        ICallGraph *icg = static_cast<ICallGraph *>(
+                            iserv->getInterface(IFACE_CALL_GRAPH));
+        icg->getCallGraph(&f, &e);
+
+        // [name, calls, incl, excl]
+        item.make_list(4);
+        for (unsigned i = 0; i < f.size(); i++) {
+            symbolName(f[i][CallGraphFunc_address].to_uint64(),
+                       callee, sizeof(callee));
+            item[0u].make_string(callee);
+            item[1] = f[i][CallGraphFunc_calls];
+            item[2] = f[i][CallGraphFunc_inclusive];
+            item[3] = f[i][CallGraphFunc_exclusive];
+            funcs->add_to_list(&item);
+        }
+
+        // [key, calls, incl, caller, callee]
+        item.make_list(5);
+        for (unsigned i = 0; i < e.size(); i++) {
+            symbolName(e[i][CallGraphEdge_caller].to_uint64(),
+                       caller, sizeof(caller));
+            symbolName(e[i][CallGraphEdge_callee].to_uint64(),
+                       callee, sizeof(callee));
+            // Separator is less than any symbol char to keep the order of
+            // the callers the same as in the sorted functions list
+            RISCV_sprintf(key, sizeof(key), "%s\x01%s", caller, callee);
+            item[0u].make_string(key);
+            item[1] = e[i][CallGraphEdge_calls];
+            item[2] = e[i][CallGraphEdge_inclusive];
+            item[3].make_string(caller);
+            item[4].make_string(callee);
+            edges->add_to_list(&item);
+        }
+    }
+    // Addresses inside of one function and the same function on
+    // different CPUs
+    mergeByName(funcs, 3);
+    mergeByName(edges, 2);
+}
+
+void CmdCallGraph::mergeByName(AttributeType *list, int valcnt) {
+    AttributeType out;
+    list->sort(0);
+    out.make_list(0);
+    for (unsigned i = 0; i < list->size(); i++) {
+        AttributeType &item = (*list)[i];
+        unsigned cnt = out.size();
+        if (cnt == 0 || !out[cnt - 1][0u].is_equal(item[0u].to_string())) {
+            out.add_to_list(&item);
+            continue;
+        }
+        AttributeType &last = out[cnt - 1];
+        for (int n = 1; n <= valcnt; n++) {
+            last[n].make_uint64(last[n].to_uint64() + item[n].to_uint64());
+        }
+    }
+    *list = out;
+}
+
+bool CmdCallGraph::saveCallgrind(const char *filename, AttributeType *funcs,
+                                 AttributeType *edges) {
+    FILE *fp = fopen(filename, "w");
+    if (!fp) {
+        return false;
+    }
+    fprintf(fp, "# callgrind format\n");
+    fprintf(fp, "version: 1\n");
+    fprintf(fp, "creator: riscvdebugger\n");
+    fprintf(fp, "events: Instructions\n\n");
+
+    // Both lists are sorted by caller name
+    unsigned e = 0;
+    for (unsigned i = 0; i < funcs->size(); i++) {
+        AttributeType &fn = (*funcs)[i];
+        fprintf(fp, "fn=%s\n", fn[0u].to_string());
+        fprintf(fp, "0 %" RV_PRI64 "d\n", fn[3].to_uint64());
+        while (e < edges->size()
+            && strcmp((*edges)[e][3].to_string(), fn[0u].to_string()) < 0) {
+            e++;
+        }
+        for (; e < edges->size()
+            && (*edges)[e][3].is_equal(fn[0u].to_string()); e++) {
+            AttributeType &ed = (*edges)[e];
+            fprintf(fp, "cfn=%s\n", ed[4].to_string());
+            fprintf(fp, "calls=%" RV_PRI64 "d 0\n", ed[1].to_uint64());
+            fprintf(fp, "0 %" RV_PRI64 "d\n", ed[2].to_uint64());
+        }
+        fprintf(fp, "\n");
+    }
+    fclose(fp);
+    return true;
+}
+
+}  // namespace debugger
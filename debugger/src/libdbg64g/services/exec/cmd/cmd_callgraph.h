@@ -0,0 +1,47 @@
+/*
+ *  Copyright 2023 Sergey Khabarov, sergeykhbr@gmail.com
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#pragma once
+
+#include "api_core.h"
+#include "iservice.h"
+#include "coreservices/icommand.h"
+#include "coreservices/icallgraph.h"
+#include "coreservices/isrccode.h"
+
+namespace debugger {
+
+class CmdCallGraph : public ICommand {
+ public:
+    explicit CmdCallGraph(IService *parent);
+
+    /** ICommand */
+    virtual int isValid(AttributeType *args);
+    virtual void exec(AttributeType *args, AttributeType *res);
+
+ private:
+    void collect(AttributeType *funcs, AttributeType *edges);
+    void mergeByName(AttributeType *list, int valcnt);
+    void symbolName(uint64_t addr, char *buf, size_t bufsz);
+    bool saveCallgrind(const char *filename, AttributeType *funcs,
+                       AttributeType *edges);
+
+ private:
+    AttributeType lstServ_;
+    ISourceCode *isrc_;
+};
+
+}  // namespace debugger
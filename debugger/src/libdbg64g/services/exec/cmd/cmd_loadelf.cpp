@@ -69,7 +69,10 @@ void CmdLoadElf::exec(AttributeType *args, AttributeType *res) {
     IService *iserv = static_cast<IService *>(lstServ[0u].to_iface());
     IElfReader *elf = static_cast<IElfReader *>(
                         iserv->getInterface(IFACE_ELFREADER));
-    elf->readFile((*args)[1].to_string());
+    if (elf->readFile((*args)[1].to_string()) < 0) {
+        generateError(res, "Cannot read ELF-file");
+        return;
+    }
 
     if (!program) {
         return;
@@ -80,6 +83,39 @@ void CmdLoadElf::exec(AttributeType *args, AttributeType *res) {
     dmcontrol.bits.ndmreset = 1;
     write_dmi(IJtag::DMI_DMCONTROL, dmcontrol.u32);
 
+    if (elf->loadableSegmentTotal()) {
+        /** Stream PT_LOAD segments directly from the mapped file */
+        uint8_t zeroes[4096];
+        uint64_t seg_addr;
+        uint64_t bss_sz;
+        size_t wsz;
+        memset(zeroes, 0, sizeof(zeroes));
+        for (unsigned i = 0; i < elf->loadableSegmentTotal(); i++) {
+            if (elf->segmentMemSize(i) < elf->segmentFileSize(i)) {
+                generateError(res, "Segment memsz is less than filesz");
+                return;
+            }
+            seg_addr = elf->segmentAddress(i);
+            if (elf->segmentFileSize(i)) {
+                write_memory(seg_addr,
+                             static_cast<size_t>(elf->segmentFileSize(i)),
+                             elf->segmentData(i));
+            }
+            seg_addr += elf->segmentFileSize(i);
+            bss_sz = elf->segmentMemSize(i) - elf->segmentFileSize(i);
+            while (bss_sz) {
+                wsz = sizeof(zeroes);
+                if (bss_sz < wsz) {
+                    wsz = static_cast<size_t>(bss_sz);
+                }
+                write_memory(seg_addr, wsz, zeroes);
+                seg_addr += wsz;
+                bss_sz -= wsz;
+            }
+        }
+        return;
+    }
+
     uint64_t sec_addr;
     int sec_sz;
     for (unsigned i = 0; i < elf->loadableSectionTotal(); i++) {
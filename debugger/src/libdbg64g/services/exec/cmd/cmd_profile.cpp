@@ -0,0 +1,427 @@
+/*
+ *  Copyright 2023 Sergey Khabarov, sergeykhbr@gmail.com
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include "cmd_profile.h"
+
+namespace debugger {
+
+ProfileSampler::ProfileSampler(IService *icpu) : IClockListener() {
+    cpuname_ = icpu->getObjName();
+    iclk_ = static_cast<IClock *>(icpu->getInterface(IFACE_CLOCK));
+    ifunc_ = static_cast<ICpuFunctional *>(
+                icpu->getInterface(IFACE_CPU_FUNCTIONAL));
+    enabled_ = false;
+    interval_ = 1;
+    armed_ = 0;
+    total_ = 0;
+    tblsz_ = TABLE_SIZE_MIN;
+    tblused_ = 0;
+    tbl_ = new PcSampleType[tblsz_];
+    memset(tbl_, 0, tblsz_ * sizeof(PcSampleType));
+    RISCV_mutex_init(&mutex_);
+}
+
+ProfileSampler::~ProfileSampler() {
+    RISCV_mutex_destroy(&mutex_);
+    delete [] tbl_;
+}
+
+void ProfileSampler::start(uint64_t interval) {
+    RISCV_mutex_lock(&mutex_);
+    interval_ = interval;
+    armed_ = iclk_->getStepCounter() + interval_;
+    enabled_ = true;
+    // Callback of the previous session can be still in the queue. If it was
+    // already taken from the queue a second copy is registered here and
+    // the old one is dropped in stepCallback() as it fires before armed_.
+    iclk_->moveStepCallback(static_cast<IClockListener *>(this), armed_);
+    RISCV_mutex_unlock(&mutex_);
+}
+
+void ProfileSampler::disarm() {
+    RISCV_mutex_lock(&mutex_);
+    enabled_ = false;
+    armed_ = ~0ull;
+    iclk_->moveStepCallback(static_cast<IClockListener *>(this), ~0ull);
+    RISCV_mutex_unlock(&mutex_);
+}
+
+void ProfileSampler::clear() {
+    RISCV_mutex_lock(&mutex_);
+    memset(tbl_, 0, tblsz_ * sizeof(PcSampleType));
+    tblused_ = 0;
+    total_ = 0;
+    RISCV_mutex_unlock(&mutex_);
+}
+
+void ProfileSampler::stepCallback(uint64_t t) {
+    if (!enabled_) {
+        return;
+    }
+    uint64_t pc = ifunc_->getPC();
+    RISCV_mutex_lock(&mutex_);
+    if (!enabled_ || t < armed_) {
+        RISCV_mutex_unlock(&mutex_);
+        return;
+    }
+    PcSampleType *p = find(pc);
+    if (p->cnt == 0) {
+        p->pc = pc;
+        tblused_++;
+    }
+    p->cnt++;
+    total_++;
+    if (2 * tblused_ > tblsz_) {
+        resize(2 * tblsz_);
+    }
+    armed_ = t + interval_;
+    iclk_->registerStepCallback(static_cast<IClockListener *>(this),
+                                armed_);
+    RISCV_mutex_unlock(&mutex_);
+}
+
+ProfileSampler::PcSampleType *ProfileSampler::find(uint64_t pc) {
+    // Fibonacci hashing, instructions are at least 2-bytes aligned
+    uint64_t h = (pc >> 1) * 0x9E3779B97F4A7C15ull;
+    unsigned idx = static_cast<unsigned>(h >> 32) & (tblsz_ - 1);
+    while (tbl_[idx].cnt && tbl_[idx].pc != pc) {
+        idx = (idx + 1) & (tblsz_ - 1);
+    }
+    return &tbl_[idx];
+}
+
+void ProfileSampler::resize(unsigned sz) {
+    PcSampleType *prev = tbl_;
+    unsigned prevsz = tblsz_;
+    tbl_ = new PcSampleType[sz];
+    tblsz_ = sz;
+    memset(tbl_, 0, tblsz_ * sizeof(PcSampleType));
+    for (unsigned i = 0; i < prevsz; i++) {
+        if (prev[i].cnt) {
+            *find(prev[i].pc) = prev[i];
+        }
+    }
+    delete [] prev;
+}
+
+void ProfileSampler::getSamples(AttributeType *list) {
+    AttributeType item;
+    item.make_list(2);
+    list->make_list(0);
+    RISCV_mutex_lock(&mutex_);
+    for (unsigned i = 0; i < tblsz_; i++) {
+        if (tbl_[i].cnt == 0) {
+            continue;
+        }
+        item[0u].make_uint64(tbl_[i].pc);
+        item[1].make_uint64(tbl_[i].cnt);
+        list->add_to_list(&item);
+    }
+    RISCV_mutex_unlock(&mutex_);
+}
+
+
+CmdProfile::CmdProfile(IService *parent) : ICommand(parent, "profile") {
+
+    briefDescr_.make_string("Statistical PC-sampling profiler");
+    detailedDescr_.make_string(
+        "Description:\n"
+        "    Sample PC of each functional CPU model every <interval> steps\n"
+        "    of its clock (executed instructions) and attribute samples\n"
+        "    to the symbols of the loaded elf-file. Samples are accumulated\n"
+        "    until 'clear'. Report is sorted by number of samples.\n"
+        "Usage:\n"
+        "    profile start [<interval>]\n"
+        "    profile stop\n"
+        "    profile clear\n"
+        "    profile                  - per-function report\n"
+        "    profile addr [<top>]     - per-instruction report\n"
+        "    profile save <file>      - folded stacks 'cpu;function count'\n"
+        "Output format:\n"
+        "    [i,[[s,i,d],...]] or [i,[[i,i,s],...]]\n"
+        "         i - total samples of all CPUs (uint64_t).\n"
+        "         s - function name.\n"
+        "         i - number of samples (uint64_t).\n"
+        "         d - percent of the total samples (double).\n"
+        "         i - instruction address (uint64_t).\n"
+        "         s - symbol name with offset.\n"
+        "Example:\n"
+        "    profile start 1000\n"
+        "    profile\n"
+        "    profile addr 20\n"
+        "    profile save prof.folded\n");
+
+    smpl_ = 0;
+    smplcnt_ = 0;
+    isrc_ = 0;
+}
+
+CmdProfile::~CmdProfile() {
+    for (unsigned i = 0; i < smplcnt_; i++) {
+        smpl_[i]->disarm();
+        delete smpl_[i];
+    }
+    delete [] smpl_;
+}
+
+int CmdProfile::isValid(AttributeType *args) {
+    if (!cmdName_.is_equal((*args)[0u].to_string())) {
+        return CMD_INVALID;
+    }
+    if (args->size() == 1) {
+        return CMD_VALID;
+    }
+    if (!(*args)[1].is_string() || args->size() > 3) {
+        return CMD_WRONG_ARGS;
+    }
+    if (args->size() == 3 && (*args)[1].is_equal("save")) {
+        return (*args)[2].is_string() ? CMD_VALID : CMD_WRONG_ARGS;
+    }
+    if (args->size() == 3 && !(*args)[2].is_integer()) {
+        return CMD_WRONG_ARGS;
+    }
+    return CMD_VALID;
+}
+
+void CmdProfile::attachSamplers() {
+    AttributeType lstServ;
+    if (smpl_) {
+        return;
+    }
+    RISCV_get_services_with_iface(IFACE_CPU_FUNCTIONAL, &lstServ);
+    smpl_ = new ProfileSampler *[lstServ.size() + 1];
+    for (unsigned i = 0; i < lstServ.size(); i++) {
+        ProfileSampler *p = new ProfileSampler(
+                    static_cast<IService *>(lstServ[i].to_iface()));
+        if (!p->isValid()) {
+            delete p;
+            continue;
+        }
+        smpl_[smplcnt_++] = p;
+    }
+
+    RISCV_get_services_with_iface(IFACE_SOURCE_CODE, &lstServ);
+    if (lstServ.size() != 0) {
+        IService *iserv = static_cast<IService *>(lstServ[0u].to_iface());
+        isrc_ = static_cast<ISourceCode *>(
+                            iserv->getInterface(IFACE_SOURCE_CODE));
+    }
+}
+
+void CmdProfile::exec(AttributeType *args, AttributeType *res) {
+    res->attr_free();
+    res->make_nil();
+
+    attachSamplers();
+    if (smplcnt_ == 0) {
+        generateError(res, "Functional CPU model not found");
+        return;
+    }
+
+    if (args->size() == 1) {
+        reportFunctions(res);
+    } else if ((*args)[1].is_equal("start")) {
+        uint64_t interval = INTERVAL_DEFAULT;
+        if (args->size() == 3 && (*args)[2].to_uint64()) {
+            interval = (*args)[2].to_uint64();
+        }
+        for (unsigned i = 0; i < smplcnt_; i++) {
+            smpl_[i]->start(interval);
+        }
+    } else if ((*args)[1].is_equal("stop")) {
+        for (unsigned i = 0; i < smplcnt_; i++) {
+            smpl_[i]->stop();
+        }
+    } else if ((*args)[1].is_equal("clear")) {
+        for (unsigned i = 0; i < smplcnt_; i++) {
+            smpl_[i]->clear();
+        }
+    } else if ((*args)[1].is_equal("addr")) {
+        unsigned top = 0;
+        if (args->size() == 3) {
+            top = (*args)[2].to_uint32();
+        }
+        reportAddresses(top, res);
+    } else if ((*args)[1].is_equal("save") && args->size() == 3) {
+        if (!saveFolded((*args)[2].to_string())) {
+            generateError(res, "Cannot open file");
+        }
+    } else {
+        generateError(res, "Wrong command format");
+    }
+}
+
+void CmdProfile::symbolName(uint64_t pc, AttributeType *name,
+                            uint64_t *start) {
+    AttributeType info;
+    name->make_string("");
+    *start = pc;
+    if (!isrc_) {
+        return;
+    }
+    // [name, offset]
+    isrc_->addressToSymbol(pc, &info);
+    if (info[0u].size() == 0) {
+        return;
+    }
+    *name = info[0u];
+    *start = pc - info[1].to_uint64();
+}
+
+void CmdProfile::groupBySymbol(ProfileSampler *p, AttributeType *func) {
+    AttributeType smpl, item, name;
+    uint64_t start, prev_start = 0;
+    uint64_t unknown = 0;
+
+    p->getSamples(&smpl);
+    // Samples of one function are adjacent after sorting by address
+    smpl.sort(0);
+    func->make_list(0);
+    item.make_list(2);
+    item[1].make_uint64(0);
+    for (unsigned i = 0; i < smpl.size(); i++) {
+        symbolName(smpl[i][0u].to_uint64(), &name, &start);
+        if (name.size() == 0) {
+            unknown += smpl[i][1].to_uint64();
+            continue;
+        }
+        if (item[1].to_uint64() && start != prev_start) {
+            func->add_to_list(&item);
+            item[1].make_uint64(0);
+        }
+        item[0u] = name;
+        item[1].make_uint64(item[1].to_uint64() + smpl[i][1].to_uint64());
+        prev_start = start;
+    }
+    if (item[1].to_uint64()) {
+        func->add_to_list(&item);
+    }
+    if (unknown) {
+        item[0u].make_string("<unknown>");
+        item[1].make_uint64(unknown);
+        func->add_to_list(&item);
+    }
+}
+
+void CmdProfile::reportFunctions(AttributeType *res) {
+    AttributeType func, all, merged, item;
+    uint64_t total = 0;
+
+    all.make_list(0);
+    for (unsigned n = 0; n < smplcnt_; n++) {
+        groupBySymbol(smpl_[n], &func);
+        total += smpl_[n]->getTotal();
+        for (unsigned i = 0; i < func.size(); i++) {
+            all.add_to_list(&func[i]);
+        }
+    }
+
+    // Merge the same function sampled on different CPUs
+    all.sort(0);
+    merged.make_list(0);
+    item.make_list(2);
+    for (unsigned i = 0; i < all.size(); i++) {
+        unsigned cnt = merged.size();
+        if (cnt && merged[cnt - 1][1].is_equal(all[i][0u].to_string())) {
+            AttributeType &last = merged[cnt - 1][0u];
+            last.make_uint64(last.to_uint64() + all[i][1].to_uint64());
+            continue;
+        }
+        item[0u] = all[i][1];
+        item[1] = all[i][0u];
+        merged.add_to_list(&item);
+    }
+    merged.sort(0);
+
+    // Descending order of samples
+    res->make_list(2);
+    (*res)[0u].make_uint64(total);
+    (*res)[1].make_list(merged.size());
+    for (unsigned i = 0; i < merged.size(); i++) {
+        AttributeType &srt = merged[merged.size() - 1 - i];
+        AttributeType &out = (*res)[1][i];
+        out.make_list(3);
+        out[0u] = srt[1];
+        out[1] = srt[0u];
+        out[2].make_floating(total ? 100.0
+            * static_cast<double>(srt[0u].to_uint64()) / total : 0);
+    }
+}
+
+void CmdProfile::reportAddresses(unsigned top, AttributeType *res) {
+    AttributeType smpl, all, item, name;
+    uint64_t total = 0;
+    uint64_t start;
+    char tstr[256];
+
+    all.make_list(0);
+    for (unsigned n = 0; n < smplcnt_; n++) {
+        smpl_[n]->getSamples(&smpl);
+        total += smpl_[n]->getTotal();
+        for (unsigned i = 0; i < smpl.size(); i++) {
+            item.make_list(2);
+            item[0u] = smpl[i][1];
+            item[1] = smpl[i][0u];
+            all.add_to_list(&item);
+        }
+    }
+    all.sort(0);
+
+    if (top == 0 || top > all.size()) {
+        top = all.size();
+    }
+    res->make_list(2);
+    (*res)[0u].make_uint64(total);
+    (*res)[1].make_list(top);
+    for (unsigned i = 0; i < top; i++) {
+        AttributeType &srt = all[all.size() - 1 - i];
+        AttributeType &out = (*res)[1][i];
+        uint64_t pc = srt[1].to_uint64();
+        symbolName(pc, &name, &start);
+        if (name.size()) {
+            RISCV_sprintf(tstr, sizeof(tstr), "%s+0x%" RV_PRI64 "x",
+                          name.to_string(), pc - start);
+        } else {
+            tstr[0] = '\0';
+        }
+        out.make_list(3);
+        out[0u].make_uint64(pc);
+        out[1] = srt[0u];
+        out[2].make_string(tstr);
+    }
+}
+
+bool CmdProfile::saveFolded(const char *filename) {
+    AttributeType func;
+    FILE *fp = fopen(filename, "w");
+    if (!fp) {
+        return false;
+    }
+    // Folded stacks format of the flame graph tools, depth is 1
+    for (unsigned n = 0; n < smplcnt_; n++) {
+        groupBySymbol(smpl_[n], &func);
+        for (unsigned i = 0; i < func.size(); i++) {
+            fprintf(fp, "%s;%s %" RV_PRI64 "d\n",
+                    smpl_[n]->cpuName(),
+                    func[i][0u].to_string(),
+                    func[i][1].to_uint64());
+        }
+    }
+    fclose(fp);
+    return true;
+}
+
+}  // namespace debugger
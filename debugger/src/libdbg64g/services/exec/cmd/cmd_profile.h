@@ -0,0 +1,104 @@
+/*
+ *  Copyright 2023 Sergey Khabarov, sergeykhbr@gmail.com
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#pragma once
+
+#include "api_core.h"
+#include "iservice.h"
+#include "coreservices/icommand.h"
+#include "coreservices/iclock.h"
+#include "coreservices/icpufunctional.h"
+#include "coreservices/isrccode.h"
+
+namespace debugger {
+
+/**
+ * @brief PC samples of one CPU model.
+ * @details Step callback is re-registered every 'interval' steps of the
+ *          CPU clock (instructions of the functional model) and counts
+ *          the PC of the executed instruction in the open addressing
+ *          hash table.
+ */
+class ProfileSampler : public IClockListener {
+ public:
+    explicit ProfileSampler(IService *icpu);
+    virtual ~ProfileSampler();
+
+    /** IClockListener, called from the CPU model thread */
+    virtual void stepCallback(uint64_t t);
+
+    void start(uint64_t interval);
+    void stop() { enabled_ = false; }
+    /** Callback must never fire after the sampler is deleted */
+    void disarm();
+    void clear();
+    bool isValid() { return iclk_ != 0 && ifunc_ != 0; }
+    const char *cpuName() { return cpuname_; }
+    uint64_t getTotal() { return total_; }
+    /** List of [pc, samples] items */
+    void getSamples(AttributeType *list);
+
+ private:
+    struct PcSampleType {
+        uint64_t pc;
+        uint64_t cnt;           // 0 = empty slot
+    };
+
+    PcSampleType *find(uint64_t pc);
+    void resize(unsigned sz);
+
+ private:
+    static const unsigned TABLE_SIZE_MIN = 4096;   // power of 2
+
+    const char *cpuname_;
+    IClock *iclk_;
+    ICpuFunctional *ifunc_;
+    volatile bool enabled_;
+    uint64_t interval_;
+    uint64_t armed_;            // earliest step of the current session
+    uint64_t total_;
+    PcSampleType *tbl_;
+    unsigned tblsz_;
+    unsigned tblused_;
+    mutex_def mutex_;
+};
+
+class CmdProfile : public ICommand {
+ public:
+    explicit CmdProfile(IService *parent);
+    virtual ~CmdProfile();
+
+    /** ICommand */
+    virtual int isValid(AttributeType *args);
+    virtual void exec(AttributeType *args, AttributeType *res);
+
+ private:
+    void attachSamplers();
+    void groupBySymbol(ProfileSampler *p, AttributeType *func);
+    void reportFunctions(AttributeType *res);
+    void reportAddresses(unsigned top, AttributeType *res);
+    bool saveFolded(const char *filename);
+    void symbolName(uint64_t pc, AttributeType *name, uint64_t *start);
+
+ private:
+    static const uint64_t INTERVAL_DEFAULT = 10000;
+
+    ProfileSampler **smpl_;
+    unsigned smplcnt_;
+    ISourceCode *isrc_;
+};
+
+}  // namespace debugger
@@ -0,0 +1,141 @@
+/*
+ *  Copyright 2023 Sergey Khabarov, sergeykhbr@gmail.com
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include "cmd_wp.h"
+
+namespace debugger {
+
+CmdWp::CmdWp(IService *parent) : ICommand(parent, "wp") {
+
+    briefDescr_.make_string("Add or remove data watchpoint.");
+    detailedDescr_.make_string(
+        "Description:\n"
+        "    Get watchpoints list or add/remove watchpoint of the CPU\n"
+        "    model. CPU halts after the instruction accessed the range:\n"
+        "    'r' - read, 'w' - write (default), 'a' - any access. If the\n"
+        "    value is specified the accessed data must be equal to it.\n"
+        "Response:\n"
+        "    List of lists [[iisi]*] if watchpoint list was requested:\n"
+        "        i - uint64_t address value\n"
+        "        i - uint64_t range length in bytes\n"
+        "        s - access type 'r', 'w' or 'a'\n"
+        "        i - value to compare or Nil\n"
+        "    Nil in a case of add/rm watchpoint\n"
+        "Usage:\n"
+        "    wp\n"
+        "    wp add <addr> <len> [r|w|a] [value]\n"
+        "    wp rm <addr> <len> [r|w|a]\n"
+        "Example:\n"
+        "    wp add 0x80001000 8\n"
+        "    wp add 0x80001000 4 a 0x55\n"
+        "    wp rm 0x80001000 8\n");
+}
+
+int CmdWp::isValid(AttributeType *args) {
+    if (!cmdName_.is_equal((*args)[0u].to_string())) {
+        return CMD_INVALID;
+    }
+    if (args->size() == 1) {
+        return CMD_VALID;
+    }
+    if (args->size() >= 4 && args->size() <= 6
+        && (*args)[1].is_string()
+        && (*args)[2].is_integer() && (*args)[3].is_integer()) {
+        return CMD_VALID;
+    }
+    return CMD_WRONG_ARGS;
+}
+
+uint32_t CmdWp::str2flags(const char *s) {
+    if (s[0] == 'r') {
+        return WatchFlag_Read;
+    } else if (s[0] == 'a') {
+        return WatchFlag_Read | WatchFlag_Write;
+    } else if (s[0] == 'w') {
+        return WatchFlag_Write;
+    }
+    return 0;
+}
+
+void CmdWp::exec(AttributeType *args, AttributeType *res) {
+    res->attr_free();
+    res->make_nil();
+
+    AttributeType lstServ;
+    RISCV_get_services_with_iface(IFACE_WATCHPOINT, &lstServ);
+    if (lstServ.size() == 0) {
+        generateError(res, "Watchpoints aren't supported by CPU model");
+        return;
+    }
+    IService *iserv = static_cast<IService *>(lstServ[0u].to_iface());
+    IWatchpoint *iwp = static_cast<IWatchpoint *>(
+                        iserv->getInterface(IFACE_WATCHPOINT));
+
+    if (args->size() == 1) {
+        AttributeType lst;
+        iwp->getWatchpointList(&lst);
+        res->make_list(lst.size());
+        for (unsigned i = 0; i < lst.size(); i++) {
+            AttributeType &wp = lst[i];
+            AttributeType &item = (*res)[i];
+            uint32_t flags = wp[WatchList_flags].to_uint32();
+            item.make_list(4);
+            item[0u] = wp[WatchList_address];
+            item[1] = wp[WatchList_length];
+            if ((flags & WatchFlag_Read) && (flags & WatchFlag_Write)) {
+                item[2].make_string("a");
+            } else if (flags & WatchFlag_Read) {
+                item[2].make_string("r");
+            } else {
+                item[2].make_string("w");
+            }
+            if (flags & WatchFlag_Value) {
+                item[3] = wp[WatchList_value];
+            }
+        }
+        return;
+    }
+
+    uint64_t addr = (*args)[2].to_uint64();
+    uint64_t len = (*args)[3].to_uint64();
+    uint32_t flags = WatchFlag_Write;
+    uint64_t value = 0;
+    if (args->size() >= 5) {
+        if (!(*args)[4].is_string()
+            || (flags = str2flags((*args)[4].to_string())) == 0) {
+            generateError(res, "Wrong access type");
+            return;
+        }
+    }
+    if (args->size() == 6) {
+        flags |= WatchFlag_Value;
+        value = (*args)[5].to_uint64();
+    }
+
+    if ((*args)[1].is_equal("add")) {
+        if (iwp->addWatchpoint(addr, len, flags, value)) {
+            generateError(res, "Cannot add watchpoint");
+        }
+    } else if ((*args)[1].is_equal("rm")) {
+        if (iwp->removeWatchpoint(addr, len, flags)) {
+            generateError(res, "Watchpoint not found");
+        }
+    } else {
+        generateError(res, "Wrong command format");
+    }
+}
+
+}  // namespace debugger
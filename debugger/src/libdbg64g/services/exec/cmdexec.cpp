@@ -38,6 +38,9 @@
 #include "cmd/cmd_elf2raw.h"
 #include "cmd/cmd_cpucontext.h"
 #include "cmd/cmd_reg.h"
+#include "cmd/cmd_wp.h"
+#include "cmd/cmd_profile.h"
+#include "cmd/cmd_callgraph.h"
 
 namespace debugger {
 
@@ -80,6 +83,7 @@ void CmdExecutor::postinitService() {
     registerCommand(new CmdIsRunning(this, ijtag_));
     registerCommand(new CmdStatus(this, ijtag_));
     registerCommand(new CmdReg(this, ijtag_));
+    registerCommand(new CmdCallGraph(this));
     registerCommand(new CmdCpi(this, ijtag_));
     registerCommand(new CmdCpuContext(this, ijtag_));
     registerCommand(tcmd = new CmdDisas(this, ijtag_));
@@ -91,11 +95,13 @@ void CmdExecutor::postinitService() {
     registerCommand(new CmdLoadSrec(this, ijtag_));
     registerCommand(new CmdLog(this));
     registerCommand(new CmdMemDump(this, ijtag_));
+    registerCommand(new CmdProfile(this));
     registerCommand(tcmd = new CmdRead(this, ijtag_));
     registerCommand(new CmdReset(this, ijtag_));
     registerCommand(new CmdStack(this, ijtag_));
     registerCommand(new CmdSymb(this));
     registerCommand(tcmd = new CmdWrite(this, ijtag_));
+    registerCommand(new CmdWp(this));
 }
 
 void CmdExecutor::registerCommand(ICommand *icmd) {
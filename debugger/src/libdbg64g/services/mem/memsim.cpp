@@ -21,6 +21,20 @@
 
 namespace debugger {
 
+/** Hex digit value or 0xFF for any other symbol */
+static uint8_t HEX_LUT[256];
+
+static void init_hex_lut() {
+    memset(HEX_LUT, 0xFF, sizeof(HEX_LUT));
+    for (int i = 0; i < 10; i++) {
+        HEX_LUT['0' + i] = static_cast<uint8_t>(i);
+    }
+    for (int i = 0; i < 6; i++) {
+        HEX_LUT['A' + i] = static_cast<uint8_t>(10 + i);
+        HEX_LUT['a' + i] = static_cast<uint8_t>(10 + i);
+    }
+}
+
 MemorySim::MemorySim(const char *name)  : MemoryGeneric(name) {
     registerAttribute("InitFile", &initFile_);
     registerAttribute("BinaryFile", &binaryFile_);
@@ -28,9 +42,23 @@ MemorySim::MemorySim(const char *name)  : MemoryGeneric(name) {
     initFile_.make_string("");
     binaryFile_.make_boolean(false);
     mem_ = NULL;
+    mapped_ = NULL;
+    mappedSize_ = 0;
+}
+
+MemorySim::~MemorySim() {
+    if (mapped_) {
+        RISCV_file_unmap(mapped_, mappedSize_);
+        mem_ = NULL;
+    }
 }
 
 void MemorySim::postinitService() {
+    if (initFile_.size() && binaryFile_.to_bool()) {
+        // Use the file mapping as the backing memory when it is large enough
+        mapBinFile(initFile_.to_string());
+    }
+
     MemoryGeneric::postinitService();
 
     if (initFile_.size() == 0) {
@@ -47,106 +75,179 @@ void MemorySim::postinitService() {
     }
 
     if (binaryFile_.to_bool()) {
-        readBinFile(initFile_.to_string(), mem_, length_.to_int());
+        if (!mapped_) {
+            readBinFile(initFile_.to_string(), mem_, length_.to_int());
+        }
     } else if (strstr(initFile_.to_string(), ".hex")) {
-        readHexFile(initFile_.to_string(), mem_, length_.to_int());
+        readHexFile(initFile_.to_string(), mem_, length_.to_int(), -1);
     } else {
-        uint8_t *tbuf = new uint8_t[length_.to_int()];
+        // 64-bits words are split on two files with 32-bits words each
         std::string lo = std::string(initFile_.to_string()) + "_lo.hex";
         std::string hi = std::string(initFile_.to_string()) + "_hi.hex";
-        int sz = readHexFile(lo.c_str(), tbuf, length_.to_int());
-        readHexFile(hi.c_str(), &tbuf[sz], length_.to_int() - sz);
-
-        // Swap 32-bits words
-        uint32_t *lsb = reinterpret_cast<uint32_t *>(tbuf);
-        uint32_t *msb = reinterpret_cast<uint32_t *>(&tbuf[sz]);
-        uint32_t *dst = reinterpret_cast<uint32_t *>(mem_);
-        uint32_t t1;
-        for (int i = 0; i < sz/sizeof(uint32_t); i++) {
-            *dst++ = *lsb++;
-            *dst++ = *msb++;
-        }
-        delete [] tbuf;
+        readHexFile(lo.c_str(), mem_, length_.to_int(), 0);
+        readHexFile(hi.c_str(), mem_, length_.to_int(), 1);
     }
 }
 
-int MemorySim::readHexFile(const char *filename, uint8_t *buf, int bufsz) {
-    int ret = 0;
-    int rd_symb;
-    int linecnt = 0;
-    uint64_t lineval = 0;
-
-    FILE *fp = fopen(filename, "r");
-    if (fp == NULL) {
-        RISCV_error("Can't open '%s' file", filename);
-        return ret;
+bool MemorySim::mapBinFile(const char *filename) {
+    uint64_t fsz;
+    uint8_t *img = reinterpret_cast<uint8_t *>(
+                        RISCV_file_map(filename, &fsz));
+    if (!img) {
+        return false;
+    }
+    if (fsz < length_.to_uint64()) {
+        // Smaller image is copied into allocated memory
+        RISCV_file_unmap(img, fsz);
+        return false;
     }
+    if (fsz > length_.to_uint64()) {
+        RISCV_error("File '%s' was trimmed", filename);
+    }
+    mapped_ = img;
+    mappedSize_ = fsz;
+    mem_ = img;
+    return true;
+}
 
-    while (!feof(fp)) {
-        rd_symb = fgetc(fp);
-        if (chishex(rd_symb)) {
-            lineval <<= 4;
-            lineval |=  chtohex(rd_symb);
+void MemorySim::parseHexChunk(void *arg) {
+    HexChunkType *p = reinterpret_cast<HexChunkType *>(arg);
+    const uint8_t *s = p->start;
+    uint64_t lineval = 0;
+    int linecnt = 0;
+    int off = p->offset;
+    int limit = p->lane < 0 ? p->bufsz : p->bufsz / 2;
+    int nbytes;
+    uint8_t v;
+
+    p->overflow = false;
+    while (s <= p->end) {
+        v = s < p->end ? HEX_LUT[*s] : 0xFF;
+        s++;
+        if (v != 0xFF) {
+            lineval = (lineval << 4) | v;
             linecnt++;
             continue;
         }
-
-        if ((ret + linecnt/2) > bufsz) {
-            RISCV_error("HEX file tries to write out "
-                        "of allocated array\n", NULL);
-            break;
-        } 
-
-        memcpy(&buf[ret], &lineval, linecnt/2);
-        ret += linecnt/2;
+        nbytes = linecnt / 2;
         linecnt = 0;
+        if (nbytes == 0) {
+            continue;
+        }
+        if (p->write) {
+            if (off + nbytes > limit) {
+                p->overflow = true;
+                break;
+            }
+            if (nbytes > static_cast<int>(sizeof(lineval))) {
+                nbytes = static_cast<int>(sizeof(lineval));
+            }
+            if (p->lane < 0) {
+                memcpy(&p->buf[off], &lineval, nbytes);
+            } else {
+                // Interleave 32-bits words: lo[0], hi[0], lo[1], hi[1], ..
+                const uint8_t *src = reinterpret_cast<uint8_t *>(&lineval);
+                for (int i = 0; i < nbytes; i++) {
+                    int pos = off + i;
+                    p->buf[((pos >> 2) << 3) + 4*p->lane + (pos & 0x3)] =
+                        src[i];
+                }
+            }
+        }
+        off += nbytes;
         lineval = 0;
     }
-    fclose(fp);
-    return ret;
+    p->total = off - p->offset;
 }
 
-int MemorySim::readBinFile(const char *filename, uint8_t *buf, int bufsz) {
+int MemorySim::readHexFile(const char *filename, uint8_t *buf, int bufsz,
+                           int lane) {
+    HexChunkType chunk[HEX_THREADS_MAX];
+    uint64_t fsz;
     int ret = 0;
-    FILE *fp = fopen(filename, "r");
-    if (fp == NULL) {
+
+    uint8_t *img = reinterpret_cast<uint8_t *>(RISCV_file_map(filename, &fsz));
+    if (img == NULL) {
         RISCV_error("Can't open '%s' file", filename);
         return ret;
     }
-    fseek(fp, 0, SEEK_END);
-    uint64_t fsz = ftell(fp);
-    if (fsz > bufsz) {
-        RISCV_error("File '%s' was trimmed", filename);
-        fsz = bufsz;
+    init_hex_lut();
+
+    int total = static_cast<int>(fsz / HEX_CHUNK_MIN);
+    if (total > HEX_THREADS_MAX) {
+        total = HEX_THREADS_MAX;
+    } else if (total == 0) {
+        total = 1;
+    }
+
+    /** Split file on chunks aligned to the lines boundary */
+    uint64_t pos = 0;
+    uint64_t next;
+    for (int i = 0; i < total; i++) {
+        next = (i + 1) * fsz / total;
+        if (next < pos) {
+            next = pos;
+        }
+        while (next < fsz && HEX_LUT[img[next]] != 0xFF) {
+            next++;
+        }
+        chunk[i].start = &img[pos];
+        chunk[i].end = &img[next];
+        chunk[i].buf = buf;
+        chunk[i].bufsz = bufsz;
+        chunk[i].lane = lane;
+        chunk[i].offset = 0;
+        chunk[i].th.func = reinterpret_cast<lib_thread_func>(parseHexChunk);
+        chunk[i].th.args = &chunk[i];
+        pos = next;
     }
-    fseek(fp, 0, SEEK_SET);
-    ret = fread(mem_, 1, static_cast<size_t>(fsz), fp);
-    fclose(fp);
-    return ret;
-}
 
-bool MemorySim::chishex(int s) {
-    bool ret = false;
-    if (s >= '0' && s <= '9') {
-        ret = true;
-    } else if (s >= 'A' && s <= 'F') {
-        ret = true;
-    } else if (s >= 'a' && s <= 'f') {
-        ret = true;
+    /** The first pass counts bytes, the second pass writes them */
+    for (int pass = 0; pass < 2; pass++) {
+        for (int i = 0; i < total; i++) {
+            chunk[i].write = pass == 1;
+            if (i > 0) {
+                RISCV_thread_create(&chunk[i].th);
+            }
+        }
+        parseHexChunk(&chunk[0]);
+        for (int i = 1; i < total; i++) {
+            RISCV_thread_join(chunk[i].th.Handle, 50000);
+        }
+        if (pass == 0) {
+            for (int i = 1; i < total; i++) {
+                chunk[i].offset = chunk[i - 1].offset + chunk[i - 1].total;
+            }
+        }
+    }
+
+    for (int i = 0; i < total; i++) {
+        ret += chunk[i].total;
+        if (chunk[i].overflow) {
+            RISCV_error("HEX file tries to write out "
+                        "of allocated array\n", NULL);
+            break;
+        }
     }
+    RISCV_file_unmap(img, fsz);
     return ret;
 }
 
-uint8_t MemorySim::chtohex(int s) {
-    if (s >= '0' && s <= '9') {
-        s -= '0';
-    } else if (s >= 'A' && s <= 'F') {
-        s = s - 'A' + 10;
-    } else if (s >= 'a' && s <= 'f') {
-        s = s - 'a' + 10;
+int MemorySim::readBinFile(const char *filename, uint8_t *buf, int bufsz) {
+    uint64_t fsz;
+    uint8_t *img = reinterpret_cast<uint8_t *>(RISCV_file_map(filename, &fsz));
+    if (img == NULL) {
+        RISCV_error("Can't open '%s' file", filename);
+        return 0;
     }
-    return static_cast<uint8_t>(s);
+    uint64_t sz = fsz;
+    if (sz > static_cast<uint64_t>(bufsz)) {
+        RISCV_error("File '%s' was trimmed", filename);
+        sz = bufsz;
+    }
+    memcpy(buf, img, static_cast<size_t>(sz));
+    RISCV_file_unmap(img, fsz);
+    return static_cast<int>(sz);
 }
 
 }  // namespace debugger
-
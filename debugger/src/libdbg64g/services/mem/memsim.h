@@ -24,20 +24,41 @@ namespace debugger {
 class MemorySim : public MemoryGeneric {
  public:
     explicit MemorySim(const char *name);
+    virtual ~MemorySim();
 
     /** IService interface */
     virtual void postinitService() override;
 
  private:
-    static const int SYMB_IN_LINE = 16/2;
-    bool chishex(int s);
-    uint8_t chtohex(int s);
-    int readHexFile(const char *filename, uint8_t *buf, int bufsz);
+    /** Hex file splits on threads only if chunk is larger than this value */
+    static const int HEX_CHUNK_MIN = 1 << 20;
+    static const int HEX_THREADS_MAX = 8;
+
+    /** Part of the mapped hex file processed by one thread */
+    struct HexChunkType {
+        LibThreadType th;
+        const uint8_t *start;
+        const uint8_t *end;
+        uint8_t *buf;
+        int bufsz;
+        int lane;       // -1 contiguous, 0/1 for _lo/_hi 32-bits words
+        bool write;     // false: count bytes only
+        int offset;     // output offset of the first byte of the chunk
+        int total;
+        bool overflow;
+    };
+
+    static void parseHexChunk(void *arg);
+    int readHexFile(const char *filename, uint8_t *buf, int bufsz, int lane);
     int readBinFile(const char *filename, uint8_t *buf, int bufsz);
+    bool mapBinFile(const char *filename);
 
  private:
     AttributeType initFile_;
     AttributeType binaryFile_;
+
+    uint8_t *mapped_;
+    uint64_t mappedSize_;
 };
 
 DECLARE_CLASS(MemorySim)
@@ -15,6 +15,7 @@
  */
 
 #include "gdbcmd.h"
+#include "coreservices/icpuarm.h"
 
 namespace debugger {
 /*
@@ -48,8 +49,184 @@ uint8_t RspPacket::checksum(const char *data, const size_t sz) {
 }
 */
 
+/** Registers order is the regnum order of the target description and the
+ *  layout of 'g'/'G' packets */
+static const GdbRegisterType RISCV_GDB_REGS[] = {
+    {"org.gnu.gdb.riscv.cpu", "zero", "zero", 8, "int",        0x1000},
+    {"org.gnu.gdb.riscv.cpu", "ra",   "ra",   8, "code_ptr",   0x1001},
+    {"org.gnu.gdb.riscv.cpu", "sp",   "sp",   8, "data_ptr",   0x1002},
+    {"org.gnu.gdb.riscv.cpu", "gp",   "gp",   8, "data_ptr",   0x1003},
+    {"org.gnu.gdb.riscv.cpu", "tp",   "tp",   8, "data_ptr",   0x1004},
+    {"org.gnu.gdb.riscv.cpu", "t0",   "t0",   8, "int",        0x1005},
+    {"org.gnu.gdb.riscv.cpu", "t1",   "t1",   8, "int",        0x1006},
+    {"org.gnu.gdb.riscv.cpu", "t2",   "t2",   8, "int",        0x1007},
+    {"org.gnu.gdb.riscv.cpu", "fp",   "s0",   8, "data_ptr",   0x1008},
+    {"org.gnu.gdb.riscv.cpu", "s1",   "s1",   8, "int",        0x1009},
+    {"org.gnu.gdb.riscv.cpu", "a0",   "a0",   8, "int",        0x100a},
+    {"org.gnu.gdb.riscv.cpu", "a1",   "a1",   8, "int",        0x100b},
+    {"org.gnu.gdb.riscv.cpu", "a2",   "a2",   8, "int",        0x100c},
+    {"org.gnu.gdb.riscv.cpu", "a3",   "a3",   8, "int",        0x100d},
+    {"org.gnu.gdb.riscv.cpu", "a4",   "a4",   8, "int",        0x100e},
+    {"org.gnu.gdb.riscv.cpu", "a5",   "a5",   8, "int",        0x100f},
+    {"org.gnu.gdb.riscv.cpu", "a6",   "a6",   8, "int",        0x1010},
+    {"org.gnu.gdb.riscv.cpu", "a7",   "a7",   8, "int",        0x1011},
+    {"org.gnu.gdb.riscv.cpu", "s2",   "s2",   8, "int",        0x1012},
+    {"org.gnu.gdb.riscv.cpu", "s3",   "s3",   8, "int",        0x1013},
+    {"org.gnu.gdb.riscv.cpu", "s4",   "s4",   8, "int",        0x1014},
+    {"org.gnu.gdb.riscv.cpu", "s5",   "s5",   8, "int",        0x1015},
+    {"org.gnu.gdb.riscv.cpu", "s6",   "s6",   8, "int",        0x1016},
+    {"org.gnu.gdb.riscv.cpu", "s7",   "s7",   8, "int",        0x1017},
+    {"org.gnu.gdb.riscv.cpu", "s8",   "s8",   8, "int",        0x1018},
+    {"org.gnu.gdb.riscv.cpu", "s9",   "s9",   8, "int",        0x1019},
+    {"org.gnu.gdb.riscv.cpu", "s10",  "s10",  8, "int",        0x101a},
+    {"org.gnu.gdb.riscv.cpu", "s11",  "s11",  8, "int",        0x101b},
+    {"org.gnu.gdb.riscv.cpu", "t3",   "t3",   8, "int",        0x101c},
+    {"org.gnu.gdb.riscv.cpu", "t4",   "t4",   8, "int",        0x101d},
+    {"org.gnu.gdb.riscv.cpu", "t5",   "t5",   8, "int",        0x101e},
+    {"org.gnu.gdb.riscv.cpu", "t6",   "t6",   8, "int",        0x101f},
+    {"org.gnu.gdb.riscv.cpu", "pc",   "pc",   8, "code_ptr",   0x7b1},
+    {"org.gnu.gdb.riscv.fpu", "ft0",  "ft0",  8, "ieee_double", 0x1020},
+    {"org.gnu.gdb.riscv.fpu", "ft1",  "ft1",  8, "ieee_double", 0x1021},
+    {"org.gnu.gdb.riscv.fpu", "ft2",  "ft2",  8, "ieee_double", 0x1022},
+    {"org.gnu.gdb.riscv.fpu", "ft3",  "ft3",  8, "ieee_double", 0x1023},
+    {"org.gnu.gdb.riscv.fpu", "ft4",  "ft4",  8, "ieee_double", 0x1024},
+    {"org.gnu.gdb.riscv.fpu", "ft5",  "ft5",  8, "ieee_double", 0x1025},
+    {"org.gnu.gdb.riscv.fpu", "ft6",  "ft6",  8, "ieee_double", 0x1026},
+    {"org.gnu.gdb.riscv.fpu", "ft7",  "ft7",  8, "ieee_double", 0x1027},
+    {"org.gnu.gdb.riscv.fpu", "fs0",  "fs0",  8, "ieee_double", 0x1028},
+    {"org.gnu.gdb.riscv.fpu", "fs1",  "fs1",  8, "ieee_double", 0x1029},
+    {"org.gnu.gdb.riscv.fpu", "fa0",  "fa0",  8, "ieee_double", 0x102a},
+    {"org.gnu.gdb.riscv.fpu", "fa1",  "fa1",  8, "ieee_double", 0x102b},
+    {"org.gnu.gdb.riscv.fpu", "fa2",  "fa2",  8, "ieee_double", 0x102c},
+    {"org.gnu.gdb.riscv.fpu", "fa3",  "fa3",  8, "ieee_double", 0x102d},
+    {"org.gnu.gdb.riscv.fpu", "fa4",  "fa4",  8, "ieee_double", 0x102e},
+    {"org.gnu.gdb.riscv.fpu", "fa5",  "fa5",  8, "ieee_double", 0x102f},
+    {"org.gnu.gdb.riscv.fpu", "fa6",  "fa6",  8, "ieee_double", 0x1030},
+    {"org.gnu.gdb.riscv.fpu", "fa7",  "fa7",  8, "ieee_double", 0x1031},
+    {"org.gnu.gdb.riscv.fpu", "fs2",  "fs2",  8, "ieee_double", 0x1032},
+    {"org.gnu.gdb.riscv.fpu", "fs3",  "fs3",  8, "ieee_double", 0x1033},
+    {"org.gnu.gdb.riscv.fpu", "fs4",  "fs4",  8, "ieee_double", 0x1034},
+    {"org.gnu.gdb.riscv.fpu", "fs5",  "fs5",  8, "ieee_double", 0x1035},
+    {"org.gnu.gdb.riscv.fpu", "fs6",  "fs6",  8, "ieee_double", 0x1036},
+    {"org.gnu.gdb.riscv.fpu", "fs7",  "fs7",  8, "ieee_double", 0x1037},
+    {"org.gnu.gdb.riscv.fpu", "fs8",  "fs8",  8, "ieee_double", 0x1038},
+    {"org.gnu.gdb.riscv.fpu", "fs9",  "fs9",  8, "ieee_double", 0x1039},
+    {"org.gnu.gdb.riscv.fpu", "fs10", "fs10", 8, "ieee_double", 0x103a},
+    {"org.gnu.gdb.riscv.fpu", "fs11", "fs11", 8, "ieee_double", 0x103b},
+    {"org.gnu.gdb.riscv.fpu", "ft8",  "ft8",  8, "ieee_double", 0x103c},
+    {"org.gnu.gdb.riscv.fpu", "ft9",  "ft9",  8, "ieee_double", 0x103d},
+    {"org.gnu.gdb.riscv.fpu", "ft10", "ft10", 8, "ieee_double", 0x103e},
+    {"org.gnu.gdb.riscv.fpu", "ft11", "ft11", 8, "ieee_double", 0x103f},
+    {"org.gnu.gdb.riscv.fpu", "fflags", "fflags", 4, "int",        0x001},
+    {"org.gnu.gdb.riscv.fpu", "frm",  "frm",  4, "int",        0x002},
+    {"org.gnu.gdb.riscv.fpu", "fcsr", "fcsr", 4, "int",        0x003},
+    {"org.gnu.gdb.riscv.csr", "mstatus",  "mstatus",  8, "int",        0x300},
+    {"org.gnu.gdb.riscv.csr", "misa",     "misa",     8, "int",        0x301},
+    {"org.gnu.gdb.riscv.csr", "medeleg",  "medeleg",  8, "int",        0x302},
+    {"org.gnu.gdb.riscv.csr", "mideleg",  "mideleg",  8, "int",        0x303},
+    {"org.gnu.gdb.riscv.csr", "mie",      "mie",      8, "int",        0x304},
+    {"org.gnu.gdb.riscv.csr", "mtvec",    "mtvec",    8, "code_ptr",   0x305},
+    {"org.gnu.gdb.riscv.csr", "mscratch", "mscratch", 8, "int",        0x340},
+    {"org.gnu.gdb.riscv.csr", "mepc",     "mepc",     8, "code_ptr",   0x341},
+    {"org.gnu.gdb.riscv.csr", "mcause",   "mcause",   8, "int",        0x342},
+    {"org.gnu.gdb.riscv.csr", "mtval",    "mtval",    8, "int",        0x343},
+    {"org.gnu.gdb.riscv.csr", "mip",      "mip",      8, "int",        0x344},
+    {"org.gnu.gdb.riscv.csr", "mhartid",  "mhartid",  8, "int",        0xf14},
+    {"org.gnu.gdb.riscv.csr", "dcsr",     "dcsr",     8, "int",        0x7b0},
+    {"org.gnu.gdb.riscv.csr", "cycle",    "cycle",    8, "int",        0xc00},
+    {"org.gnu.gdb.riscv.csr", "instret",  "insret",   8, "int",        0xc02},
+    {0, 0, 0, 0, 0, 0}
+};
+
+static const GdbRegisterType ARM_GDB_REGS[] = {
+    {"org.gnu.gdb.arm.core", "r0",   "r0",   4, "uint32",     0x1000},
+    {"org.gnu.gdb.arm.core", "r1",   "r1",   4, "uint32",     0x1001},
+    {"org.gnu.gdb.arm.core", "r2",   "r2",   4, "uint32",     0x1002},
+    {"org.gnu.gdb.arm.core", "r3",   "r3",   4, "uint32",     0x1003},
+    {"org.gnu.gdb.arm.core", "r4",   "r4",   4, "uint32",     0x1004},
+    {"org.gnu.gdb.arm.core", "r5",   "r5",   4, "uint32",     0x1005},
+    {"org.gnu.gdb.arm.core", "r6",   "r6",   4, "uint32",     0x1006},
+    {"org.gnu.gdb.arm.core", "r7",   "r7",   4, "uint32",     0x1007},
+    {"org.gnu.gdb.arm.core", "r8",   "r8",   4, "uint32",     0x1008},
+    {"org.gnu.gdb.arm.core", "r9",   "r9",   4, "uint32",     0x1009},
+    {"org.gnu.gdb.arm.core", "r10",  "r10",  4, "uint32",     0x100a},
+    {"org.gnu.gdb.arm.core", "r11",  "r11",  4, "uint32",     0x100b},
+    {"org.gnu.gdb.arm.core", "r12",  "fp",   4, "uint32",     0x100c},
+    {"org.gnu.gdb.arm.core", "sp",   "sp",   4, "data_ptr",   0x100d},
+    {"org.gnu.gdb.arm.core", "lr",   "lr",   4, "int",        0x100e},
+    {"org.gnu.gdb.arm.core", "pc",   "pc",   4, "code_ptr",   0x100f},
+    {"org.gnu.gdb.arm.core", "cpsr", "cpsr", 4, "int",        0x1010},
+    {0, 0, 0, 0, 0, 0}
+};
+
+/** Memory accesses are split on the 'read'/'write' commands of this size */
+static const int MEM_CHUNK = 4096;
+
+static int hex2nibble(char c) {
+    if (c >= '0' && c <= '9') {
+        return c - '0';
+    } else if (c >= 'a' && c <= 'f') {
+        return c - 'a' + 10;
+    } else if (c >= 'A' && c <= 'F') {
+        return c - 'A' + 10;
+    }
+    return -1;
+}
+
+/** Decode 'sz' bytes, return false on wrong hex symbol */
+static bool hex2bin(const char *s, uint8_t *buf, int sz) {
+    int hi, lo;
+    for (int i = 0; i < sz; i++) {
+        hi = hex2nibble(s[2*i]);
+        lo = hi < 0 ? -1 : hex2nibble(s[2*i + 1]);
+        if (lo < 0) {
+            return false;
+        }
+        buf[i] = static_cast<uint8_t>((hi << 4) | lo);
+    }
+    return true;
+}
+
+static void bin2hex(const uint8_t *buf, int sz, char *s) {
+    static const char HEX[] = "0123456789abcdef";
+    for (int i = 0; i < sz; i++) {
+        *s++ = HEX[buf[i] >> 4];
+        *s++ = HEX[buf[i] & 0xf];
+    }
+    *s = '\0';
+}
+
 GdbCommands::GdbCommands(IService *parent) : TcpCommandsGen(parent) {
     estate_ = State_AckMode;
+    packet_size_ = 0;
+    memmapsz_ = 0;
+
+    // Whole 'X' packet with '$', '#' and checksum
+    delete [] rxbuf_;
+    rxtotal_ = GDB_PACKET_SIZE + 8;
+    rxbuf_ = new char[rxtotal_];
+
+    // CRC-32 of qCRC: polynomial 0x04c11db7, MSB first, as in gdb
+    for (uint32_t i = 0; i < 256; i++) {
+        uint32_t c = i << 24;
+        for (int k = 0; k < 8; k++) {
+            c = (c & 0x80000000u) ? (c << 1) ^ 0x04c11db7u : (c << 1);
+        }
+        crctbl_[i] = c;
+    }
+
+    if (RISCV_get_service_iface(cpu_.to_string(), IFACE_CPU_ARM)) {
+        regs_ = ARM_GDB_REGS;
+        arch_ = "arm";
+    } else {
+        regs_ = RISCV_GDB_REGS;
+        arch_ = "riscv:rv64";
+    }
+    pcidx_ = 0;
+    while (strcmp(regs_[pcidx_].name, "pc") != 0) {
+        pcidx_++;
+    }
+    buildTargetXml();
 }
 
 int GdbCommands::processCommand(const char *cmdbuf, int bufsz) {
@@ -58,7 +235,7 @@ int GdbCommands::processCommand(const char *cmdbuf, int bufsz) {
         return bufsz;
     }
 
-    if (bufsz < 3 || cmdbuf[bufsz - 3] != '#') {
+    if (bufsz < 4 || cmdbuf[bufsz - 3] != '#') {
         RISCV_info("wrong checksum format: sz=%d; %02x",
                     bufsz, cmdbuf[bufsz - 3]);
         return bufsz;
@@ -68,13 +245,19 @@ int GdbCommands::processCommand(const char *cmdbuf, int bufsz) {
     RISCV_sprintf(comp_sum, 3, "%02x", checksum(&cmdbuf[1], bufsz-4));
 
     if (comp_sum[0] != cmdbuf[bufsz-2] || comp_sum[1] != cmdbuf[bufsz-1]) {
-        RISCV_info("wrong checksum: %02x", comp_sum);
+        RISCV_info("wrong checksum: %s", comp_sum);
+        if (estate_ != State_NoAckMode) {
+            // Request retransmission
+            respbuf_[0] = '-';
+            respcnt_ = 1;
+        }
         return bufsz;
     }
 
     // Remove '$' start symbol and CRC at the end
-    memcpy(&packet_data_, &cmdbuf[1], bufsz - 4);
-    packet_data_[bufsz - 4] = '\0';
+    packet_size_ = bufsz - 4;
+    memcpy(&packet_data_, &cmdbuf[1], packet_size_);
+    packet_data_[packet_size_] = '\0';
 
     handlePacket(packet_data_);
     return bufsz;
@@ -159,6 +342,7 @@ void GdbCommands::handlePacket(char *data) {
         break;
     default:
         RISCV_info("Unknown RSP packet: %s", data);
+        sendPacket("");
     }
 }
 
@@ -171,10 +355,24 @@ void GdbCommands::handleQuery() {
          * Reply QCpid - Where pid is a HEX encoded 16 bit process id.
          * Set thread id 1, because we don't have other threads. */
         sendPacket("QC1");
-    } else if (strncmp("qCRC", packet_data_, strlen("qCRC")) == 0) {
-        /* Return CRC of memory area.
-         * Return Error 01 */
-        sendPacket("E01");
+    } else if (strncmp("qCRC:", packet_data_, strlen("qCRC:")) == 0) {
+        /* Return CRC of memory area, used by 'compare-sections'.
+         * Reply C<crc32> or E01 if memory cannot be read */
+        uint64_t addr, len;
+        bool err;
+        if (RISCV_sscanf(packet_data_, "qCRC:%" RV_PRI64 "x,%" RV_PRI64 "x",
+                         &addr, &len) != 2) {
+            sendPacket("E01");
+            return;
+        }
+        uint32_t crc = crc32(addr, len, &err);
+        if (err) {
+            sendPacket("E01");
+            return;
+        }
+        char tstr[16];
+        RISCV_sprintf(tstr, sizeof(tstr), "C%08x", crc);
+        sendPacket(tstr);
     } else if (strcmp("qfThreadInfo", packet_data_) == 0) {
         /* Obtain a list of active thread ids from the target (OS)
          * this query works iteratively:
@@ -194,7 +392,7 @@ void GdbCommands::handleQuery() {
         /* Return info about more active threads.
          * We have no more, so return the end of list marker, 'l' */
         sendPacket("l");
-    } else if (strncmp("qGetTLSAddr:", 
+    } else if (strncmp("qGetTLSAddr:",
                        packet_data_, strlen("qGetTLSAddr:")) == 0) {
         /* We don't support this feature */
         sendPacket("");
@@ -210,12 +408,17 @@ void GdbCommands::handleQuery() {
     } else if (strncmp("qRcmd,", packet_data_, strlen("qRcmd,")) == 0) {
         /* This is used to interface to commands to do "stuff" */
         sendPacket("");
-    } else if (strncmp("qSupported", 
+    } else if (strncmp("qSupported",
                         packet_data_, strlen("qSupported")) == 0) {
         /* Report a list of the features we support.
-         * 1000h == 4096
-         * 500h  == 1280 */
-        sendPacket("PacketSize=500;QStartNoAckMode+;vContSupported+");
+         * PacketSize is hex: 10000h == 64 KB, so that 'load' sends
+         * the image by large 'X' packets */
+        char tstr[256];
+        RISCV_sprintf(tstr, sizeof(tstr),
+                      "PacketSize=%x;QStartNoAckMode+;"
+                      "qXfer:features:read+;qXfer:memory-map:read+;"
+                      "vContSupported+", GDB_PACKET_SIZE);
+        sendPacket(tstr);
         //QNonStop+
     } else if (strncmp("qSymbol:", packet_data_, strlen("qSymbol:")) == 0) {
         /* Offer to look up symbols. Ignore for now */
@@ -230,8 +433,20 @@ void GdbCommands::handleQuery() {
     } else if (strncmp("qTStatus", packet_data_, strlen("qTStatus")) == 0) {
         /* Don't support tracing, return empty packet. */
         sendPacket("");
+    } else if (strncmp("qXfer:features:read:target.xml:", packet_data_,
+                       strlen("qXfer:features:read:target.xml:")) == 0) {
+        /* Target description with FPU and CSR registers */
+        sendXfer(tdesc_, tdescsz_,
+                 &packet_data_[strlen("qXfer:features:read:target.xml:")]);
+    } else if (strncmp("qXfer:memory-map:read::", packet_data_,
+                       strlen("qXfer:memory-map:read::")) == 0) {
+        if (memmapsz_ == 0) {
+            buildMemoryMapXml();
+        }
+        sendXfer(memmap_, memmapsz_,
+                 &packet_data_[strlen("qXfer:memory-map:read::")]);
     } else if (strncmp("qXfer:", packet_data_, strlen("qXfer:")) == 0) {
-        /* No 'qXfer' requests supported, return empty packet. */
+        /* Other objects and annexes aren't supported */
         sendPacket("");
     } else {
         RISCV_error("Unrecognized RSP query: %s \n", packet_data_);
@@ -239,20 +454,146 @@ void GdbCommands::handleQuery() {
     }
 }
 
+void GdbCommands::sendXfer(const char *doc, int docsz, const char *range) {
+    unsigned offset, length;
+    if (RISCV_sscanf(range, "%x,%x", &offset, &length) != 2) {
+        sendPacket("E00");
+        return;
+    }
+    if (offset >= static_cast<unsigned>(docsz)) {
+        sendPacket("l");
+        return;
+    }
+    unsigned sz = docsz - offset;
+    if (length > static_cast<unsigned>(GDB_PACKET_SIZE)) {
+        length = GDB_PACKET_SIZE;
+    }
+    // XML documents have no '#', '$', '}' and '*', so no escaping
+    hexbuf_[0] = sz > length ? 'm' : 'l';
+    if (sz > length) {
+        sz = length;
+    }
+    memcpy(&hexbuf_[1], &doc[offset], sz);
+    hexbuf_[sz + 1] = '\0';
+    sendPacket(hexbuf_);
+}
+
+void GdbCommands::buildTargetXml() {
+    const char *feature = "";
+    int sz = RISCV_sprintf(tdesc_, sizeof(tdesc_),
+        "<?xml version=\"1.0\"?>\n"
+        "<!DOCTYPE target SYSTEM \"gdb-target.dtd\">\n"
+        "<target version=\"1.0\">\n"
+        "<architecture>%s</architecture>\n", arch_);
+    for (int i = 0; regs_[i].name; i++) {
+        if (strcmp(feature, regs_[i].feature) != 0) {
+            if (feature[0]) {
+                sz += RISCV_sprintf(&tdesc_[sz], sizeof(tdesc_) - sz,
+                                    "</feature>\n");
+            }
+            feature = regs_[i].feature;
+            sz += RISCV_sprintf(&tdesc_[sz], sizeof(tdesc_) - sz,
+                                "<feature name=\"%s\">\n", feature);
+        }
+        sz += RISCV_sprintf(&tdesc_[sz], sizeof(tdesc_) - sz,
+            "<reg name=\"%s\" bitsize=\"%d\" type=\"%s\" regnum=\"%d\"/>\n",
+            regs_[i].name, 8 * regs_[i].bytes, regs_[i].type, i);
+    }
+    sz += RISCV_sprintf(&tdesc_[sz], sizeof(tdesc_) - sz,
+                        "</feature>\n</target>\n");
+    tdescsz_ = sz;
+}
+
+void GdbCommands::buildMemoryMapXml() {
+    struct RegionType {
+        uint64_t start;
+        uint64_t end;
+        bool rom;
+    } *rgn, t;
+    AttributeType lstServ;
+    IService *iserv;
+    IMemoryOperation *imem;
+    const AttributeType *ro;
+    int total = 0;
+
+    // Slave devices of all buses, bus itself has zero length
+    RISCV_get_services_with_iface(IFACE_MEMORY_OPERATION, &lstServ);
+    rgn = new RegionType[lstServ.size() + 1];
+    for (unsigned i = 0; i < lstServ.size(); i++) {
+        iserv = static_cast<IService *>(lstServ[i].to_iface());
+        imem = static_cast<IMemoryOperation *>(
+                    iserv->getInterface(IFACE_MEMORY_OPERATION));
+        if (imem->getLength() == 0) {
+            continue;
+        }
+        ro = static_cast<AttributeType *>(iserv->getAttribute("ReadOnly"));
+        t.start = imem->getBaseAddress();
+        t.end = t.start + imem->getLength();
+        t.rom = ro && ro->to_bool();
+
+        // Sorted insertion, gdb discards a map with overlapped regions
+        int k = total++;
+        while (k > 0 && rgn[k - 1].start > t.start) {
+            rgn[k] = rgn[k - 1];
+            k--;
+        }
+        rgn[k] = t;
+    }
+
+    int cnt = 0;
+    for (int i = 0; i < total; i++) {
+        if (cnt && rgn[i].start < rgn[cnt - 1].end) {
+            if (rgn[i].end > rgn[cnt - 1].end) {
+                rgn[cnt - 1].end = rgn[i].end;
+            }
+            rgn[cnt - 1].rom = rgn[cnt - 1].rom && rgn[i].rom;
+        } else {
+            rgn[cnt++] = rgn[i];
+        }
+    }
+
+    int sz = RISCV_sprintf(memmap_, sizeof(memmap_),
+        "<?xml version=\"1.0\"?>\n"
+        "<!DOCTYPE memory-map PUBLIC \"+//IDN gnu.org//DTD GDB Memory Map "
+        "V1.0//EN\" \"http://sourceware.org/gdb/gdb-memory-map.dtd\">\n"
+        "<memory-map>\n");
+    for (int i = 0; i < cnt; i++) {
+        if (sz > static_cast<int>(sizeof(memmap_)) - 128) {
+            RISCV_error("Memory map truncated at %d regions", i);
+            break;
+        }
+        sz += RISCV_sprintf(&memmap_[sz], sizeof(memmap_) - sz,
+            "<memory type=\"%s\" start=\"0x%" RV_PRI64 "x\" "
+            "length=\"0x%" RV_PRI64 "x\"/>\n",
+            rgn[i].rom ? "rom" : "ram",
+            rgn[i].start, rgn[i].end - rgn[i].start);
+    }
+    sz += RISCV_sprintf(&memmap_[sz], sizeof(memmap_) - sz,
+                        "</memory-map>\n");
+    memmapsz_ = sz;
+    delete [] rgn;
+}
+
 void GdbCommands::handleStopReasonQuery() {
-    sendPacket("S05");
+    // Attached target is reported as stopped
+    haltTarget();
+    sendStopReply();
 }
 
 void GdbCommands::handleContinue() {
-    AttributeType res;
-    if (!iexec_) {
+    if (!isConnected()) {
         sendPacket("E01");
         return;
     }
+    continueTarget();
+    sendStopReply();
+}
+
+void GdbCommands::continueTarget() {
+    AttributeType res;
     RISCV_event_clear(&eventHalt_);
     iexec_->exec("run", &res, false);
     RISCV_event_wait(&eventHalt_);
-    sendPacket("S05");
 }
 
 void GdbCommands::handleDetach() {
@@ -260,57 +601,103 @@ void GdbCommands::handleDetach() {
     sendPacket("OK");
 }
 
-void GdbCommands::appendRegValue(char *s, uint32_t value) {
-    char byte_hex[3];
+void GdbCommands::appendRegValue(char *s, uint64_t value, int bytes) {
+    uint8_t le[8];
+    for (int i = 0; i < bytes; i++) {
+        le[i] = static_cast<uint8_t>(value >> (8 * i));
+    }
+    bin2hex(le, bytes, &s[strlen(s)]);
+}
 
-    RISCV_sprintf(byte_hex, 3, "%02X", value & 0xFF);
-    strncat(s, byte_hex, 2);
-    RISCV_sprintf(byte_hex, 3, "%02X", (value >> 8) & 0xFF);
-    strncat(s, byte_hex, 2);
-    RISCV_sprintf(byte_hex, 3, "%02X", (value >> 16) & 0xFF);
-    strncat(s, byte_hex, 2);
-    RISCV_sprintf(byte_hex, 3, "%02X", (value >> 24) & 0xFF);
-    strncat(s, byte_hex, 2);
+int GdbCommands::regTotal() {
+    int ret = 0;
+    while (regs_[ret].name) {
+        ret++;
+    }
+    return ret;
 }
 
-void GdbCommands::handleGetRegisters() {
-    char resp[512] = "\0";
+void GdbCommands::readRegisters(int first, int cnt,
+                                uint64_t *val, bool *valid) {
     AttributeType res;
+    int sz = RISCV_sprintf(cmdbuf_, sizeof(cmdbuf_), "%s", "reg");
 
+    // All registers by one command
+    for (int i = first; i < first + cnt; i++) {
+        sz += RISCV_sprintf(&cmdbuf_[sz], sizeof(cmdbuf_) - sz,
+                            " %s", regs_[i].regname);
+    }
     if (iexec_) {
-        iexec_->exec("regs", &res, false);
-    }
-    appendRegValue(resp, res["r0"].to_uint32());
-    appendRegValue(resp, res["r1"].to_uint32());
-    appendRegValue(resp, res["r2"].to_uint32());
-    appendRegValue(resp, res["r3"].to_uint32());
-    appendRegValue(resp, res["r4"].to_uint32());
-    appendRegValue(resp, res["r5"].to_uint32());
-    appendRegValue(resp, res["r6"].to_uint32());
-    appendRegValue(resp, res["r7"].to_uint32());
-    appendRegValue(resp, res["r8"].to_uint32());
-    appendRegValue(resp, res["r9"].to_uint32());
-    appendRegValue(resp, res["r10"].to_uint32());
-    appendRegValue(resp, res["r11"].to_uint32());
-    appendRegValue(resp, res["fp"].to_uint32());
-    appendRegValue(resp, res["sp"].to_uint32());
-    appendRegValue(resp, res["lr"].to_uint32());
-    appendRegValue(resp, res["pc"].to_uint32());
-    strncat(resp, "xxxxxxxxxxxxxxxxxxxxxxxxx", 96 / 8 * 2);  // f0
-    strncat(resp, "xxxxxxxxxxxxxxxxxxxxxxxxx", 96 / 8 * 2);
-    strncat(resp, "xxxxxxxxxxxxxxxxxxxxxxxxx", 96 / 8 * 2);
-    strncat(resp, "xxxxxxxxxxxxxxxxxxxxxxxxx", 96 / 8 * 2);
-    strncat(resp, "xxxxxxxxxxxxxxxxxxxxxxxxx", 96 / 8 * 2);
-    strncat(resp, "xxxxxxxxxxxxxxxxxxxxxxxxx", 96 / 8 * 2);
-    strncat(resp, "xxxxxxxxxxxxxxxxxxxxxxxxx", 96 / 8 * 2);
-    strncat(resp, "xxxxxxxxxxxxxxxxxxxxxxxxx", 96 / 8 * 2);  // f7
-    strncat(resp, "xxxxxxxxxxxxxxxxxxxxxxxxx", 32 / 8 * 2);  // fps
-    appendRegValue(resp, res["cpsr"].to_uint32());
-    sendPacket(resp);
+        iexec_->exec(cmdbuf_, &res, false);
+    }
+    for (int i = 0; i < cnt; i++) {
+        const char *regname = regs_[first + i].regname;
+        valid[i] = res.is_dict() && res.has_key(regname);
+        val[i] = valid[i] ? res[regname].to_uint64() : 0;
+    }
+}
+
+bool GdbCommands::writeRegisters(int first, int cnt,
+                                 const uint64_t *val, const bool *valid) {
+    AttributeType res;
+    int sz = RISCV_sprintf(cmdbuf_, sizeof(cmdbuf_), "%s", "reg");
+    if (!iexec_) {
+        return false;
+    }
+    for (int i = 0; i < cnt; i++) {
+        if (valid[i]) {
+            sz += RISCV_sprintf(&cmdbuf_[sz], sizeof(cmdbuf_) - sz,
+                                " %s 0x%" RV_PRI64 "x",
+                                regs_[first + i].regname, val[i]);
+        }
+    }
+    iexec_->exec(cmdbuf_, &res, false);
+    return !res.is_list();
+}
+
+void GdbCommands::handleGetRegisters() {
+    int total = regTotal();
+    readRegisters(0, total, regval_, regvalid_);
+
+    hexbuf_[0] = '\0';
+    for (int i = 0; i < total; i++) {
+        if (regvalid_[i]) {
+            appendRegValue(hexbuf_, regval_[i], regs_[i].bytes);
+        } else {
+            // Unavailable value
+            strncat(hexbuf_, "xxxxxxxxxxxxxxxx", 2 * regs_[i].bytes);
+        }
+    }
+    sendPacket(hexbuf_);
 }
 
 void GdbCommands::handleSetRegisters() {
-    sendPacket("");
+    /* G XX...: registers in the order of 'g', 'x' - keep unchanged */
+    const char *p = &packet_data_[1];
+    uint8_t le[8];
+    int total = regTotal();
+
+    for (int i = 0; i < total; i++) {
+        const GdbRegisterType *r = &regs_[i];
+        regvalid_[i] = false;
+        if (static_cast<int>(strlen(p)) < 2 * r->bytes) {
+            continue;
+        }
+        if (hex2bin(p, le, r->bytes)) {
+            regval_[i] = 0;
+            for (int k = r->bytes - 1; k >= 0; k--) {
+                regval_[i] = (regval_[i] << 8) | le[k];
+            }
+            regvalid_[i] = true;
+        }
+        p += 2 * r->bytes;
+    }
+
+    if (!isConnected()) {
+        sendPacket("E01");
+        return;
+    }
+    sendPacket(writeRegisters(0, total, regval_, regvalid_) ? "OK" : "E01");
 }
 
 void GdbCommands::handleSetThread() {
@@ -323,6 +710,82 @@ void GdbCommands::handleKill() {
     sendPacket("OK");
 }
 
+bool GdbCommands::readMemory(uint64_t addr, int sz, uint8_t *obuf) {
+    AttributeType res;
+    int n;
+    if (!iexec_) {
+        return false;
+    }
+    while (sz > 0) {
+        n = sz < MEM_CHUNK ? sz : MEM_CHUNK;
+        RISCV_sprintf(cmdbuf_, sizeof(cmdbuf_),
+                      "read 0x%" RV_PRI64 "x %d", addr, n);
+        iexec_->exec(cmdbuf_, &res, false);
+        if (!res.is_data() || static_cast<int>(res.size()) != n) {
+            return false;
+        }
+        memcpy(obuf, res.data(), n);
+        addr += n;
+        obuf += n;
+        sz -= n;
+    }
+    return true;
+}
+
+bool GdbCommands::writeMemory(uint64_t addr, int sz, const uint8_t *ibuf) {
+    AttributeType res;
+    uint64_t val;
+    int n, cnt;
+    if (!iexec_) {
+        return false;
+    }
+    while (sz > 0) {
+        // Command as a list: ['write',addr,bytes,[u64,u64,..]]
+        n = sz < MEM_CHUNK ? sz : MEM_CHUNK;
+        cnt = RISCV_sprintf(cmdbuf_, sizeof(cmdbuf_),
+                    "['write',0x%" RV_PRI64 "x,%d,[", addr, n);
+        for (int i = 0; i < n; i += 8) {
+            val = 0;
+            for (int k = 7; k >= 0; k--) {
+                val <<= 8;
+                if (i + k < n) {
+                    val |= ibuf[i + k];
+                }
+            }
+            cnt += RISCV_sprintf(&cmdbuf_[cnt], sizeof(cmdbuf_) - cnt,
+                                 "%s0x%" RV_PRI64 "x", i ? "," : "", val);
+        }
+        RISCV_sprintf(&cmdbuf_[cnt], sizeof(cmdbuf_) - cnt, "]]");
+        iexec_->exec(cmdbuf_, &res, false);
+        if (res.is_list()) {
+            return false;
+        }
+        addr += n;
+        ibuf += n;
+        sz -= n;
+    }
+    return true;
+}
+
+uint32_t GdbCommands::crc32(uint64_t addr, uint64_t len, bool *err) {
+    uint32_t crc = 0xFFFFFFFFu;
+    int n;
+    *err = false;
+    while (len) {
+        n = len < sizeof(membuf_) ? static_cast<int>(len) : sizeof(membuf_);
+        if (!readMemory(addr, n, membuf_)) {
+            *err = true;
+            return 0;
+        }
+        for (int i = 0; i < n; i++) {
+            crc = (crc << 8) ^ crctbl_[((crc >> 24) ^ membuf_[i]) & 0xFF];
+        }
+        addr += n;
+        len -= n;
+    }
+    return crc;
+}
+
 void GdbCommands::handleGetMemory() {
     /* Handle a RSP read memory (symbolic) request
      * Syntax is: m<addr>,<length>:
@@ -330,36 +793,45 @@ void GdbCommands::handleGetMemory() {
      * Lowest address first, encoded as pairs of hex digits.
      * The length given is the number of bytes to be read.
      */
-    unsigned long address;
+    uint64_t address;
     int len;
-    if (RISCV_sscanf(packet_data_, "m%lx,%x:", &address, &len) != 2) {
+    if (RISCV_sscanf(packet_data_, "m%" RV_PRI64 "x,%x",
+                     &address, &len) != 2) {
         RISCV_info("Failed to recognize RSP read memory command: %s",
                     packet_data_);
         sendPacket("E01");
         return;
     }
 
-    AttributeType res;
-    char tstr[256];
-    RISCV_sprintf(tstr, sizeof(tstr), "read 0x%lx %d", address, len);
-
-    if (iexec_) {
-        iexec_->exec(tstr, &res, false);
+    // Shorter reply is allowed
+    if (len < 0 || len > GDB_PACKET_SIZE / 2) {
+        len = GDB_PACKET_SIZE / 2;
     }
-
-    uint8_t *bts = res.data();
-    tstr[0] = 0;
-    for (size_t offset = 0; offset < res.size(); offset++) {
-        char byte_hex[3];
-        RISCV_sprintf(byte_hex, sizeof(byte_hex), "%02x", bts[offset]);
-        strncat(tstr, byte_hex, 2);
+    if (!readMemory(address, len, membuf_)) {
+        sendPacket("E01");
+        return;
     }
-
-    sendPacket(tstr);
+    bin2hex(membuf_, len, hexbuf_);
+    sendPacket(hexbuf_);
 }
 
 void GdbCommands::handleWriteMemoryHex() {
-    sendPacket("");
+    /* M<addr>,<length>:XX... */
+    uint64_t address;
+    int len;
+    const char *data_ptr = strchr(packet_data_, ':');
+
+    if (RISCV_sscanf(packet_data_, "M%" RV_PRI64 "x,%x",
+                     &address, &len) != 2 || !data_ptr
+        || len < 0 || len > static_cast<int>(sizeof(membuf_))
+        || static_cast<int>(strlen(data_ptr + 1)) < 2 * len
+        || !hex2bin(data_ptr + 1, membuf_, len)) {
+        RISCV_info("Failed to recognize RSP write memory %s",
+                   packet_data_);
+        sendPacket("E01");
+        return;
+    }
+    sendPacket(writeMemory(address, len, membuf_) ? "OK" : "E01");
 }
 
 void GdbCommands::handleReadRegister() {
@@ -371,63 +843,55 @@ void GdbCommands::handleReadRegister() {
         sendPacket("E01");
         return;
     }
-
-    AttributeType res;
-    if (iexec_) {
-        iexec_->exec("regs", &res, false);
+    if (regnum >= static_cast<unsigned>(regTotal())) {
+        sendPacket("E01");
+        return;
     }
 
-    char resp[256] = "\0";
-    appendRegValue(resp, res.dict_value(regnum)->to_uint32());
+    uint64_t val;
+    bool valid;
+    readRegisters(regnum, 1, &val, &valid);
+
+    char resp[32] = "\0";
+    if (valid) {
+        appendRegValue(resp, val, regs_[regnum].bytes);
+    } else {
+        strncat(resp, "xxxxxxxxxxxxxxxx", 2 * regs_[regnum].bytes);
+    }
     sendPacket(resp);
 }
 
 void GdbCommands::handleWriteRegister() {
-    unsigned       regnum;            /* Register index */
-    char           byte0[3];  /* Data to set */
-    char           byte1[3];
-    char           byte2[3];
-    char           byte3[3];
-
-    if (RISCV_sscanf(packet_data_, "P%x=%2s%2s%2s%2s",
-               &regnum, byte0, byte1, byte2, byte3) != 5) {
+    unsigned regnum;            /* Register index */
+    const char *pval = strchr(packet_data_, '=');
+    uint8_t le[8];
+
+    if (RISCV_sscanf(packet_data_, "P%x=", &regnum) != 1 || !pval
+        || regnum >= static_cast<unsigned>(regTotal())) {
         RISCV_info("Failed to recognize RSP write register "
                    "command: %s", packet_data_);
         sendPacket("E01");
         return;
     }
 
-    AttributeType res;
-    char tstr[256];
-
-    /** Hardcode for ARM only */
-    char regname[10] = "\0";
-    if (regnum < 12) {
-        RISCV_sprintf(regname, sizeof(regname), "r%d", regnum);
-    } else if (regnum == 12) {
-        RISCV_sprintf(regname, sizeof(regname), "fp");
-    } else if (regnum == 13) {
-        RISCV_sprintf(regname, sizeof(regname), "sp");
-    } else if (regnum == 14) {
-        RISCV_sprintf(regname, sizeof(regname), "lr");
-    } else if (regnum == 15) {
-        RISCV_sprintf(regname, sizeof(regname), "pc");
-    } else if (regnum == 26) {
-        RISCV_sprintf(regname, sizeof(regname), "cpsr");
-    } else {
-        RISCV_info("Failed to recognize register: %d", regnum);
+    const GdbRegisterType *r = &regs_[regnum];
+    pval++;
+    if (static_cast<int>(strlen(pval)) < 2 * r->bytes
+        || !hex2bin(pval, le, r->bytes)) {
         sendPacket("E01");
         return;
     }
+    uint64_t val = 0;
+    for (int i = r->bytes - 1; i >= 0; i--) {
+        val = (val << 8) | le[i];
+    }
 
-    RISCV_sprintf(tstr, sizeof(tstr), "reg %s 0x%s%s%s%s",
-                  regname, byte3, byte2, byte1, byte0);
-    RISCV_info("command: %s", tstr);
-
-    if (iexec_) {
-        iexec_->exec(tstr, &res, false);
+    bool valid = true;
+    if (!isConnected()) {
+        sendPacket("E01");
+        return;
     }
-    sendPacket("OK");
+    sendPacket(writeRegisters(regnum, 1, &val, &valid) ? "OK" : "E01");
 }
 
 void GdbCommands::handleGeneralSet() {
@@ -438,8 +902,57 @@ void GdbCommands::handleGeneralSet() {
     sendPacket("OK");
 }
 
+void GdbCommands::stepInstruction() {
+    AttributeType res;
+    RISCV_event_clear(&eventHalt_);
+    iexec_->exec("c 1", &res, false);
+    RISCV_event_wait(&eventHalt_);
+}
+
+uint64_t GdbCommands::readPC() {
+    uint64_t pc;
+    bool valid;
+    readRegisters(pcidx_, 1, &pc, &valid);
+    return valid ? pc : 0;
+}
+
+void GdbCommands::writePC(uint64_t pc) {
+    bool valid = true;
+    writeRegisters(pcidx_, 1, &pc, &valid);
+}
+
 void GdbCommands::handleStep() {
-    sendPacket("");
+    /* s [addr]: optionally resume at addr */
+    uint64_t addr;
+    if (!isConnected()) {
+        sendPacket("E01");
+        return;
+    }
+    if (packet_data_[0] == 's'
+        && RISCV_sscanf(packet_data_, "s%" RV_PRI64 "x", &addr) == 1) {
+        writePC(addr);
+    }
+    stepInstruction();
+    sendStopReply();
+}
+
+void GdbCommands::handleRangeStep(const char *range) {
+    /* r<start>,<end>: step while pc is inside [start, end) and report only
+     * the final stop, instead of gdb's step-by-step round trips */
+    uint64_t start, end, pc, prev;
+    if (RISCV_sscanf(range, "%" RV_PRI64 "x,%" RV_PRI64 "x",
+                     &start, &end) != 2) {
+        sendPacket("E01");
+        return;
+    }
+    pc = readPC();
+    do {
+        prev = pc;
+        stepInstruction();
+        pc = readPC();
+        // Unchanged pc: breakpoint, wfi or jump to itself
+    } while (pc != prev && pc >= start && pc < end);
+    sendStopReply();
 }
 
 void GdbCommands::handleThreadAlive() {
@@ -453,59 +966,80 @@ void GdbCommands::handleVCommand() {
         const char *packet_ptr = packet_data_;
         packet_ptr += 5;
         if (*packet_ptr == '?') {
-            sendPacket("vCont;c;C");
+            sendPacket("vCont;c;C;s;S;r");
+            return;
+        }
+        if (!isConnected()) {
+            sendPacket("E01");
             return;
         }
         if (*packet_ptr == ';') {
             packet_ptr++;
         }
-        if (*packet_ptr == 'c') {
+        // Single thread: the first action is applied, thread-id ignored
+        switch (*packet_ptr) {
+        case 'c':
+        case 'C':
             RISCV_info("Continue packet: %s", packet_data_);
             handleContinue();
+            break;
+        case 's':
+        case 'S':
+            stepInstruction();
+            sendStopReply();
+            break;
+        case 'r':
+            handleRangeStep(packet_ptr + 1);
+            break;
+        case 't':
+            sendPacket("OK");
+            break;
+        default:
+            sendPacket("");
         }
-        if (*packet_ptr == 's') {
-            AttributeType res;
-            RISCV_info("Step packet: %s", packet_data_);
-            iexec_->exec("c 1", &res, false);
-            sendPacket("S05");
-        }
+    } else {
+        sendPacket("");
     }
 }
 
 void GdbCommands::handleWriteMemory() {
-    size_t         len;             /* Number of bytes to write */
-    unsigned long  address;         /* Where to write the memory */
+    uint64_t       address;         /* Where to write the memory */
+    int            len;             /* Number of bytes to write */
     const char     *data_ptr;       /* Pointer to the binary data */
+    const char     *data_end = &packet_data_[packet_size_];
+    int            cnt = 0;
 
-    if (RISCV_sscanf(packet_data_, "X%lx,%lx:", &address, &len) != 2) {
+    data_ptr = static_cast<const char *>(
+                    memchr(packet_data_, ':', packet_size_));
+    if (RISCV_sscanf(packet_data_, "X%" RV_PRI64 "x,%x",
+                     &address, &len) != 2 || !data_ptr
+        || len < 0 || len > static_cast<int>(sizeof(membuf_))) {
         RISCV_info("Failed to recognize RSP write memory %s",
                    packet_data_);
         sendPacket("E01");
         return;
     }
 
-    data_ptr = static_cast<char*>(memchr(packet_data_, ':', DATA_MAX));
+    // Binary data: '}' escapes the next byte XOR-ed with 0x20
     data_ptr++;
-    char data_hex[2 * DATA_MAX + 1];
-    data_hex[0] = '\0';
-
-    for (size_t offset = 0; offset < len; offset++) {
-        char byte_hex[3];
-        RISCV_sprintf(byte_hex, sizeof(byte_hex), "%02x", data_ptr[offset]);
-        strncat(data_hex, byte_hex, 2);
+    while (cnt < len && data_ptr < data_end) {
+        if (*data_ptr == '}' && data_ptr + 1 < data_end) {
+            membuf_[cnt++] = static_cast<uint8_t>(data_ptr[1] ^ 0x20);
+            data_ptr += 2;
+        } else {
+            membuf_[cnt++] = static_cast<uint8_t>(*data_ptr++);
+        }
     }
-
-    AttributeType res;
-    // 32 should be enough for 'write 0x000000 9999 '
-    char tstr[DATA_MAX * 2 + 32];
-    RISCV_sprintf(tstr, sizeof(tstr), "write 0x%lx %lu 0x%s",
-                  address, len, data_hex);
-
-    if (iexec_) {
-        iexec_->exec(tstr, &res, false);
+    if (cnt != len) {
+        sendPacket("E01");
+        return;
     }
-
-    sendPacket("OK");
+    // Zero length is used by gdb to probe 'X' support
+    if (len == 0) {
+        sendPacket("OK");
+        return;
+    }
+    sendPacket(writeMemory(address, len, membuf_) ? "OK" : "E01");
 }
 
 void GdbCommands::handleBreakpoint() {
@@ -514,36 +1048,64 @@ void GdbCommands::handleBreakpoint() {
     int len;
     char zZ;       /* 'Z' : add breakpoint, 'z' : remove breakopint. */
 
-    if (RISCV_sscanf(packet_data_, "%c%1d,%lx,%1d",
+    if (RISCV_sscanf(packet_data_, "%c%1d,%lx,%x",
                 &zZ, &type, &address, &len) != 4) {
         RISCV_info("Failed to recognize RSP add breakpoint: %s", packet_data_);
         sendPacket("E01");
         return;
     }
 
-    /* Sanity check that the length is 4 */
-    if (len != 4) {
-        RISCV_info("Warning: length is not 4, but %d", len);
-        len = 4;
+    if (!isBreakpointSupported(type)) {
+        // Empty reply lets gdb fall back to another breakpoint kind
+        sendPacket("");
+        return;
     }
-
-    /* Sort out the type of breakpoint, currently only memory is supported */
-    AttributeType addr, res;
-    addr.make_uint64(address);
-    if (type == 0) {
-        /* Memory breakpoint */
-        if (zZ == 'Z') {
-            br_add(addr, &res);
-        } else {
-            br_rm(addr, &res);
-        }
+    if (setBreakpoint(zZ == 'Z', type, address, len)) {
         sendPacket("OK");
     } else {
-        RISCV_info("Failed to recognize RSP breakpoint type: %d", type);
+        RISCV_info("Failed to set RSP breakpoint: %s", packet_data_);
         sendPacket("E01");
     }
 }
 
+bool GdbCommands::isBreakpointSupported(int type) {
+    return type == 0 || (type >= 2 && type <= 4 && isConnected());
+}
+
+bool GdbCommands::setBreakpoint(bool add, int type, uint64_t addr, int len) {
+    /* Sort out the type of breakpoint: memory or watchpoint */
+    AttributeType t1, res;
+    char tstr[256];
+    static const char *WP_TYPE[3] = {"w", "r", "a"};
+    if (type >= 2 && type <= 4 && isConnected()) {
+        RISCV_sprintf(tstr, sizeof(tstr), "wp %s 0x%" RV_PRI64 "x %d %s",
+                      add ? "add" : "rm", addr, len, WP_TYPE[type - 2]);
+        iexec_->exec(tstr, &res, false);
+        return !res.is_list() || res.size() == 0
+            || !res[0u].is_equal("ERROR");
+    }
+    if (type != 0) {
+        return false;
+    }
+    t1.make_uint64(addr);
+    if (add) {
+        br_add(t1, &res);
+    } else {
+        br_rm(t1, &res);
+    }
+    return true;
+}
+
+void GdbCommands::stopReason(char *buf, int bufsz) {
+    RISCV_sprintf(buf, bufsz, "%s", "S05");
+}
+
+void GdbCommands::sendStopReply() {
+    char tstr[64];
+    stopReason(tstr, sizeof(tstr));
+    sendPacket(tstr);
+}
+
 void GdbCommands::sendPacket(const char *data) {
     int tsz = static_cast<int>(strlen(data));
     respcnt_ = 0;
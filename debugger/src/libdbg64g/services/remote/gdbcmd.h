@@ -23,6 +23,23 @@ namespace debugger {
 
 static const int DATA_MAX = 4096;
 
+/** Advertised in qSupported: the largest packet 'M', 'X' or 'G' the stub
+ *  accepts, 'm' replies are limited to the half of it. */
+static const int GDB_PACKET_SIZE = 0x10000;
+
+/** One register of the target description, index is the gdb regnum */
+struct GdbRegisterType {
+    const char *feature;
+    const char *name;       // name in the target description
+    const char *regname;    // argument of the 'reg' command
+    int bytes;
+    const char *type;
+    uint32_t regno;         // readRegDbg() index, 0x1000+n is getpRegs()[n]
+};
+
+/** Upper bound of the target description registers */
+static const int GDB_REGS_MAX = 128;
+
 /*struct RspPacket {
     RspPacket() : size(0), is_good(false) {}
     RspPacket(const char* const c_str);
@@ -56,11 +73,37 @@ class GdbCommands : public TcpCommandsGen {
         return s[sz - 3] == '#';
     }
 
+ protected:
+    /** Target access used by the packet handlers. This implementation sends
+     *  console commands to the executor, child classes may access the CPU
+     *  model directly. */
+    virtual bool isConnected() { return iexec_ != 0; }
+    virtual void haltTarget() {}
+    virtual void readRegisters(int first, int cnt,
+                               uint64_t *val, bool *valid);
+    virtual bool writeRegisters(int first, int cnt,
+                                const uint64_t *val, const bool *valid);
+    virtual bool readMemory(uint64_t addr, int sz, uint8_t *obuf);
+    virtual bool writeMemory(uint64_t addr, int sz, const uint8_t *ibuf);
+    virtual void stepInstruction();
+    virtual void continueTarget();
+    /** type is the 'Z' packet type: 0=sw, 1=hw breakpoint, 2=write,
+     *  3=read, 4=access watchpoint */
+    virtual bool isBreakpointSupported(int type);
+    virtual bool setBreakpoint(bool add, int type, uint64_t addr, int len);
+    /** Stop reply packet sent after halt, 'S05' by default */
+    virtual void stopReason(char *buf, int bufsz);
+
+    int regTotal();
+    uint64_t readPC();
+    void writePC(uint64_t pc);
+
  private:
     void handleHandshake(char s);
     void handlePacket(char *data);
     uint8_t checksum(const char *data, const int sz);
     void sendPacket(const char *data);
+    void sendStopReply();
 
     // RSP packet handlers
     void handleStopReasonQuery();
@@ -81,14 +124,36 @@ class GdbCommands : public TcpCommandsGen {
     void handleVCommand();
     void handleWriteMemory();
     void handleBreakpoint();
+    void handleRangeStep(const char *range);
+
+    void appendRegValue(char *s, uint64_t value, int bytes);
+    uint32_t crc32(uint64_t addr, uint64_t len, bool *err);
+    void buildTargetXml();
+    void buildMemoryMapXml();
+    void sendXfer(const char *doc, int docsz, const char *range);
 
-    void appendRegValue(char *s, uint32_t value);
+ protected:
+    const GdbRegisterType *regs_;
+    int pcidx_;             // regnum of the program counter
 
  private:
     //RspPacket previous_packet;
     //bool is_ack_mode;
     //bool last_success_;
-    char packet_data_[1 << 16];
+    char packet_data_[GDB_PACKET_SIZE + 8];
+    int packet_size_;       // binary payload of 'X' may contain zeros
+    uint8_t membuf_[GDB_PACKET_SIZE];
+    char hexbuf_[GDB_PACKET_SIZE + 16];
+    char cmdbuf_[1 << 14];
+    uint32_t crctbl_[256];
+    uint64_t regval_[GDB_REGS_MAX];
+    bool regvalid_[GDB_REGS_MAX];
+
+    const char *arch_;
+    char tdesc_[1 << 14];
+    int tdescsz_;
+    char memmap_[1 << 14];
+    int memmapsz_;          // built on the first request, all devices mapped
     enum EState {
         State_AckMode,
         State_WaitAckToSwitch,
@@ -0,0 +1,330 @@
+/*
+ *  Copyright 2019 Sergey Khabarov, sergeykhbr@gmail.com
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include <riscv-isa.h>
+#include "gdbcpu.h"
+#include "coreservices/icpuriscv.h"
+
+namespace debugger {
+
+/** Above this size the whole instruction cache is flushed after writing */
+static const int FLUSH_ALL_BYTES = 64;
+
+GdbCpuCommands::GdbCpuCommands(IService *parent) : GdbCommands(parent) {
+    idport_ = static_cast<IDPort *>(
+        RISCV_get_service_iface(cpu_.to_string(), IFACE_DPORT));
+    iwp_ = static_cast<IWatchpoint *>(
+        RISCV_get_service_iface(cpu_.to_string(), IFACE_WATCHPOINT));
+    riscv_ = RISCV_get_service_iface(cpu_.to_string(), IFACE_CPU_RISCV) != 0;
+
+    hwtotal_ = 0;
+    IService *iservcpu = static_cast<IService *>(
+                        RISCV_get_service(cpu_.to_string()));
+    AttributeType *trig = iservcpu ? static_cast<AttributeType *>(
+                        iservcpu->getAttribute("TriggersTotal")) : 0;
+    if (riscv_ && trig) {
+        hwtotal_ = trig->to_int();
+        if (hwtotal_ > GDB_HW_BREAKPOINTS_MAX) {
+            hwtotal_ = GDB_HW_BREAKPOINTS_MAX;
+        }
+    }
+    for (int i = 0; i < GDB_HW_BREAKPOINTS_MAX; i++) {
+        hwaddr_[i] = 0;
+        hwused_[i] = false;
+    }
+    if (!idport_ || !icpufunc_) {
+        RISCV_error("%s doesn't provide debug port", cpu_.to_string());
+    }
+}
+
+void GdbCpuCommands::haltTarget() {
+    if (!isConnected() || !icpufunc_->isOn() || idport_->isHalted()) {
+        return;
+    }
+    RISCV_event_clear(&eventHalt_);
+    idport_->haltreq();
+    RISCV_event_wait(&eventHalt_);
+}
+
+void GdbCpuCommands::readRegisters(int first, int cnt,
+                                   uint64_t *val, bool *valid) {
+    uint64_t *R = icpufunc_ ? icpufunc_->getpRegs() : 0;
+    uint32_t regno;
+    for (int i = 0; i < cnt; i++) {
+        regno = regs_[first + i].regno;
+        valid[i] = true;
+        if (R && (regno >> 12) == 1) {
+            val[i] = R[regno & 0xFFF];
+        } else if (riscv_ && idport_) {
+            // CSR, pc is dpc while halted and npc while running
+            val[i] = idport_->readRegDbg(regno);
+        } else {
+            val[i] = 0;
+            valid[i] = false;
+        }
+    }
+}
+
+bool GdbCpuCommands::writeRegisters(int first, int cnt,
+                                    const uint64_t *val, const bool *valid) {
+    uint64_t *R = icpufunc_ ? icpufunc_->getpRegs() : 0;
+    uint32_t regno;
+    bool ret = true;
+    for (int i = 0; i < cnt; i++) {
+        if (!valid[i]) {
+            continue;
+        }
+        regno = regs_[first + i].regno;
+        if (R && (regno >> 12) == 1) {
+            if (riscv_ && regno == 0x1000) {
+                continue;   // x0 is hardwired
+            }
+            R[regno & 0xFFF] = val[i];
+        } else if (riscv_ && idport_) {
+            idport_->writeRegDbg(regno, val[i]);
+        } else {
+            ret = false;
+            continue;
+        }
+        if (first + i == pcidx_) {
+            // Resume from the new location as 'reg npc' does
+            icpufunc_->setNPC(val[i]);
+        }
+    }
+    return ret;
+}
+
+bool GdbCpuCommands::memop(EAxi4Action action, uint64_t addr, int sz,
+                           uint8_t *buf) {
+    Axi4TransactionType tr;
+    int n;
+    if (!icpufunc_) {
+        return false;
+    }
+    while (sz > 0) {
+        // Naturally aligned 1, 2, 4 or 8 bytes, splitted on the bus width
+        n = 8;
+        while (n > sz || (addr & (n - 1))) {
+            n >>= 1;
+        }
+        memset(&tr, 0, sizeof(tr));
+        tr.action = action;
+        tr.addr = addr;
+        tr.xsize = static_cast<uint32_t>(n);
+        tr.wstrb = (1u << n) - 1;
+        if (action == MemAction_Write) {
+            memcpy(tr.wpayload.b8, buf, n);
+        }
+        if (icpufunc_->dma_memop(&tr) == TRANS_ERROR
+            || tr.response == MemResp_Error) {
+            return false;
+        }
+        if (action == MemAction_Read) {
+            memcpy(buf, tr.rpayload.b8, n);
+        }
+        addr += n;
+        buf += n;
+        sz -= n;
+    }
+    return true;
+}
+
+bool GdbCpuCommands::readMemory(uint64_t addr, int sz, uint8_t *obuf) {
+    return memop(MemAction_Read, addr, sz, obuf);
+}
+
+bool GdbCpuCommands::writeMemory(uint64_t addr, int sz, const uint8_t *ibuf) {
+    bool ret = memop(MemAction_Write, addr, sz, const_cast<uint8_t *>(ibuf));
+    if (!icpufunc_) {
+        return ret;
+    }
+    // Decoded instructions overlapping the modified bytes
+    if (sz > FLUSH_ALL_BYTES) {
+        icpufunc_->flush(~0ull);
+    } else {
+        for (uint64_t a = addr - 3; a != addr + sz; a++) {
+            icpufunc_->flush(a);
+        }
+    }
+    return ret;
+}
+
+void GdbCpuCommands::resumeTarget(bool step) {
+    csr_dcsr_type dcsr;
+    if (!icpufunc_->isOn()) {
+        return;
+    }
+    if (riscv_) {
+        dcsr.u64 = idport_->readRegDbg(ICpuRiscV::CSR_dcsr);
+        dcsr.bits.step = step ? 1 : 0;
+        dcsr.bits.ebreakm = 1;
+        dcsr.bits.ebreaks = 1;
+        dcsr.bits.ebreaku = 1;
+        idport_->writeRegDbg(ICpuRiscV::CSR_dcsr, dcsr.u64);
+    }
+    RISCV_event_clear(&eventHalt_);
+    idport_->resumereq();
+    RISCV_event_wait(&eventHalt_);
+
+    if (riscv_ && step) {
+        dcsr.u64 = idport_->readRegDbg(ICpuRiscV::CSR_dcsr);
+        dcsr.bits.step = 0;
+        idport_->writeRegDbg(ICpuRiscV::CSR_dcsr, dcsr.u64);
+    }
+}
+
+void GdbCpuCommands::stepInstruction() {
+    if (!riscv_) {
+        // No dcsr.step in the model, step with the console command
+        GdbCommands::stepInstruction();
+        return;
+    }
+    resumeTarget(true);
+}
+
+void GdbCpuCommands::continueTarget() {
+    resumeTarget(false);
+}
+
+bool GdbCpuCommands::isBreakpointSupported(int type) {
+    if (type >= 2 && type <= 4 && iwp_) {
+        return true;
+    }
+    if (!riscv_) {
+        return GdbCommands::isBreakpointSupported(type);
+    }
+    return type == 0 || type == 1;
+}
+
+bool GdbCpuCommands::setBreakpoint(bool add, int type, uint64_t addr,
+                                   int len) {
+    static const uint32_t WP_FLAGS[3] = {
+        WatchFlag_Write, WatchFlag_Read, WatchFlag_Read | WatchFlag_Write
+    };
+    if (type >= 2 && type <= 4 && iwp_) {
+        if (add) {
+            return iwp_->addWatchpoint(addr, len, WP_FLAGS[type - 2], 0) == 0;
+        }
+        iwp_->removeWatchpoint(addr, len, WP_FLAGS[type - 2]);
+        return true;
+    }
+    if (!riscv_) {
+        return GdbCommands::setBreakpoint(add, type, addr, len);
+    }
+    if (type == 0) {
+        return setSwBreakpoint(add, addr, len);
+    } else if (type == 1) {
+        return setHwBreakpoint(add, addr);
+    }
+    return false;
+}
+
+void GdbCpuCommands::stopReason(char *buf, int bufsz) {
+    uint64_t addr;
+    uint32_t flags = iwp_ ? iwp_->getWatchpointHit(&addr) : 0;
+    const char *kind = "awatch";
+    if (flags == 0) {
+        GdbCommands::stopReason(buf, bufsz);
+        return;
+    }
+    flags &= WatchFlag_Read | WatchFlag_Write;
+    if (flags == WatchFlag_Write) {
+        kind = "watch";
+    } else if (flags == WatchFlag_Read) {
+        kind = "rwatch";
+    }
+    // gdb reports the watched variable using the data address
+    RISCV_sprintf(buf, bufsz, "T05%s:%" RV_PRI64 "x;", kind, addr);
+}
+
+bool GdbCpuCommands::setSwBreakpoint(bool add, uint64_t addr, int len) {
+    Reg64Type orig;
+    Reg64Type brk;
+    AttributeType brlist;
+    if (!isrc_) {
+        return false;
+    }
+    if (add) {
+        if (isrc_->isBreakpoint(addr)) {
+            return true;
+        }
+        // gdb kind is the instruction length: 2 for compressed
+        len = len == 2 ? 2 : 4;
+        orig.val = 0;
+        brk.val = 0;
+        brk.buf32[0] = len == 2 ? 0x9002 : 0x00100073;  // C.EBREAK, EBREAK
+        if (!readMemory(addr, len, orig.buf)
+            || !writeMemory(addr, len, brk.buf)) {
+            return false;
+        }
+        isrc_->registerBreakpoint(addr, 0, orig.buf32[0], brk.buf32[0], len);
+        return true;
+    }
+
+    // Restore original instruction stored in the breakpoints list
+    isrc_->getBreakpointList(&brlist);
+    for (unsigned i = 0; i < brlist.size(); i++) {
+        AttributeType &br = brlist[i];
+        if (br[BrkList_address].to_uint64() != addr
+            || (br[BrkList_flags].to_uint64() & BreakFlag_HW)) {
+            continue;
+        }
+        orig.val = br[BrkList_instr].to_uint64();
+        writeMemory(addr, br[BrkList_oplen].to_int(), orig.buf);
+        isrc_->unregisterBreakpoint(addr);
+        break;
+    }
+    return true;
+}
+
+bool GdbCpuCommands::setHwBreakpoint(bool add, uint64_t addr) {
+    TriggerData1Type tdata1;
+    int idx = -1;
+    for (int i = 0; i < hwtotal_; i++) {
+        if (add ? !hwused_[i] : (hwused_[i] && hwaddr_[i] == addr)) {
+            idx = i;
+            break;
+        }
+    }
+    if (idx < 0) {
+        return !add;
+    }
+
+    tdata1.val = 0;
+    if (add) {
+        tdata1.mcontrol_bits.type = 2;      // address/data match
+        tdata1.mcontrol_bits.dmode = 1;
+        tdata1.mcontrol_bits.action = 1;    // enter Debug Mode
+        tdata1.mcontrol_bits.execute = 1;
+        tdata1.mcontrol_bits.m = 1;
+        tdata1.mcontrol_bits.s = 1;
+        tdata1.mcontrol_bits.u = 1;
+    }
+    idport_->writeRegDbg(ICpuRiscV::CSR_tselect, idx);
+    idport_->writeRegDbg(ICpuRiscV::CSR_tdata1, tdata1.val);
+    idport_->writeRegDbg(ICpuRiscV::CSR_tdata2, addr);
+    hwused_[idx] = add;
+    hwaddr_[idx] = addr;
+
+    if (isrc_ && add) {
+        isrc_->registerBreakpoint(addr, BreakFlag_HW, 0, 0, 0);
+    } else if (isrc_) {
+        isrc_->unregisterBreakpoint(addr);
+    }
+    return true;
+}
+
+}  // namespace debugger
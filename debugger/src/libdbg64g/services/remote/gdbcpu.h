@@ -0,0 +1,76 @@
+/*
+ *  Copyright 2019 Sergey Khabarov, sergeykhbr@gmail.com
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#ifndef __DEBUGGER_SERVICES_REMOTE_GDBCPU_H__
+#define __DEBUGGER_SERVICES_REMOTE_GDBCPU_H__
+
+#include "gdbcmd.h"
+#include "coreservices/idport.h"
+#include "coreservices/iwatchpoint.h"
+
+namespace debugger {
+
+/** Hardware breakpoints handled by the stub, limited by TriggersTotal */
+static const int GDB_HW_BREAKPOINTS_MAX = 8;
+
+/**
+ * @brief GDB stub connected directly to the functional CPU model.
+ * @details Registers are taken from ICpuFunctional::getpRegs() and
+ *          IDPort::readRegDbg(), memory is accessed with dma_memop() and
+ *          run control uses haltreq()/resumereq() without console commands
+ *          and DMI. Software breakpoints are the EBREAK instructions
+ *          registered in the source code service list, hardware ones are
+ *          the CPU triggers, watchpoints use IWatchpoint of the model.
+ *          Selected by TcpServer Type 'gdbcpu'.
+ */
+class GdbCpuCommands : public GdbCommands {
+ public:
+    explicit GdbCpuCommands(IService *parent);
+
+ protected:
+    /** GdbCommands target access */
+    virtual bool isConnected() { return idport_ != 0 && icpufunc_ != 0; }
+    virtual void haltTarget();
+    virtual void readRegisters(int first, int cnt,
+                               uint64_t *val, bool *valid);
+    virtual bool writeRegisters(int first, int cnt,
+                                const uint64_t *val, const bool *valid);
+    virtual bool readMemory(uint64_t addr, int sz, uint8_t *obuf);
+    virtual bool writeMemory(uint64_t addr, int sz, const uint8_t *ibuf);
+    virtual void stepInstruction();
+    virtual void continueTarget();
+    virtual bool isBreakpointSupported(int type);
+    virtual bool setBreakpoint(bool add, int type, uint64_t addr, int len);
+    virtual void stopReason(char *buf, int bufsz);
+
+ private:
+    void resumeTarget(bool step);
+    bool memop(EAxi4Action action, uint64_t addr, int sz, uint8_t *buf);
+    bool setSwBreakpoint(bool add, uint64_t addr, int len);
+    bool setHwBreakpoint(bool add, uint64_t addr);
+
+ private:
+    IDPort *idport_;
+    IWatchpoint *iwp_;
+    bool riscv_;            // CSRs and triggers are available
+    int hwtotal_;
+    uint64_t hwaddr_[GDB_HW_BREAKPOINTS_MAX];
+    bool hwused_[GDB_HW_BREAKPOINTS_MAX];
+};
+
+}  // namespace debugger
+
+#endif  // __DEBUGGER_SERVICES_REMOTE_GDBCPU_H__
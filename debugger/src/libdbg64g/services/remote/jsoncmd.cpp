@@ -78,6 +78,13 @@ int JsonCommands::processCommand(const char *cmdbuf, int bufsz) {
         } else {
             resp.make_string("Wrong status command");
         }
+    } else if (requestType.is_equal("Subscribe")) {
+        /** Asynchronous run-control notifications: ['Halt',hartid] */
+        if (requestAction.is_list() && requestAction.size() == 2) {
+            subscribe(requestAction[0u], requestAction[1].to_bool(), &resp);
+        } else {
+            resp.make_string("Wrong subscribe command");
+        }
     } else if (requestType.is_equal("Symbol")) {
         /** Symbols table conversion */
         if (requestAction[0u].is_equal("ToAddr")) {
@@ -17,20 +17,24 @@
 #include "tcpclient.h"
 #include "jsoncmd.h"
 #include "gdbcmd.h"
+#include "gdbcpu.h"
 
 namespace debugger {
 
-TcpClient::TcpClient(const char *name) : IService(name) {
+TcpClient::TcpClient(const char *name) : IService(name), IHap(HAP_All) {
     registerInterface(static_cast<IThread *>(this));
     registerAttribute("Enable", &isEnable_);
     registerAttribute("PlatformConfig", &platformConfig_);
     registerAttribute("Type", &type_);
     registerAttribute("ListenDefaultOutput", &listenDefaultOutput_);
     RISCV_mutex_init(&mutexTx_);
+    RISCV_register_hap(static_cast<IHap *>(this));
     tcpcmd_ = 0;
+    hsock_ = -1;
 }
 
 TcpClient::~TcpClient() {
+    RISCV_unregister_hap(static_cast<IHap *>(this));
     RISCV_mutex_destroy(&mutexTx_);
     if (tcpcmd_) {
         delete tcpcmd_;
@@ -42,6 +46,8 @@ void TcpClient::postinitService() {
         tcpcmd_ = new JsonCommands(static_cast<IService *>(this));
     } else if (type_.is_equal("gdb")) {
         tcpcmd_ = new GdbCommands(static_cast<IService *>(this));
+    } else if (type_.is_equal("gdbcpu")) {
+        tcpcmd_ = new GdbCpuCommands(static_cast<IService *>(this));
     } else {
         RISCV_error("Unsupported command type %s.", type_.to_string());
         return;
@@ -69,6 +75,18 @@ int TcpClient::updateData(const char *buf, int buflen) {
     return buflen;
 }
 
+void TcpClient::hapTriggered(EHapType type, uint64_t param,
+                             const char *descr) {
+    if (!tcpcmd_ || !tcpcmd_->isHapSubscribed(type) || hsock_ < 0) {
+        return;
+    }
+    char tstr[64];
+    const char *name = type == HAP_Halt ? "Halt" : "Resume";
+    int tsz = RISCV_sprintf(tstr, sizeof(tstr),
+                    "['%s',%" RV_PRI64 "d]", name, param) + 1;
+    sendData(reinterpret_cast<uint8_t *>(tstr), tsz);
+}
+
 void TcpClient::busyLoop() {
     int rxbytes;
     if (listenDefaultOutput_.to_bool()) {
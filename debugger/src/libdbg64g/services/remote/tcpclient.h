@@ -19,6 +19,7 @@
 
 #include <iclass.h>
 #include <iservice.h>
+#include <ihap.h>
 #include "tcpcmd_gen.h"
 #include "coreservices/ithread.h"
 #include "coreservices/irawlistener.h"
@@ -27,7 +28,8 @@ namespace debugger {
 
 class TcpClient : public IService,
                   public IThread,
-                  public IRawListener {
+                  public IRawListener,
+                  public IHap {
  public:
     explicit TcpClient(const char *name);
     virtual ~TcpClient();
@@ -41,6 +43,10 @@ class TcpClient : public IService,
     /** IRawListener interface */
     virtual int updateData(const char *buf, int buflen);
 
+    /** IHap */
+    virtual void hapTriggered(EHapType type, uint64_t param,
+                              const char *descr);
+
  protected:
     /** IThread interface */
     virtual void busyLoop();
@@ -20,8 +20,11 @@ namespace debugger {
 
 TcpCommandsGen::TcpCommandsGen(IService *parent) : IHap(HAP_All) {
     parent_ = parent;
+    rxtotal_ = 4096;        // should re-allocated if need in childs
     rxcnt_ = 0;
+    rxbuf_ = new char[rxtotal_];
     estate_ = State_Idle;
+    hapSubscribed_ = 0;
 
     resptotal_ = 1 << 18;   // should re-allocated if need in childs
     respcnt_ = 0;
@@ -69,6 +72,7 @@ TcpCommandsGen::~TcpCommandsGen() {
     respcnt_ = 0;
     resptotal_ = 0;
     delete [] respbuf_;
+    delete [] rxbuf_;
 }
 
 void TcpCommandsGen::setPlatformConfig(AttributeType *cfg) {
@@ -100,7 +104,7 @@ int TcpCommandsGen::updateData(const char *buf, int buflen) {
             }
             break;
         case State_Started:
-            if (rxcnt_ < static_cast<int>(sizeof(rxbuf_))) {
+            if (rxcnt_ < rxtotal_ - 1) {
                 rxbuf_[rxcnt_++] = buf[i];
                 rxbuf_[rxcnt_] = '\0';
             } else {
@@ -273,6 +277,25 @@ void TcpCommandsGen::power_off(const char *btn_name, AttributeType *res) {
     res->make_string("OK");
 }
 
+void TcpCommandsGen::subscribe(AttributeType &hap, bool ena,
+                               AttributeType *res) {
+    EHapType etype;
+    if (hap.is_equal("Halt")) {
+        etype = HAP_Halt;
+    } else if (hap.is_equal("Resume")) {
+        etype = HAP_Resume;
+    } else {
+        res->make_string("subscribe: Unsupported event");
+        return;
+    }
+    if (ena) {
+        hapSubscribed_ |= 1u << etype;
+    } else {
+        hapSubscribed_ &= ~(1u << etype);
+    }
+    res->make_string("OK");
+}
+
 void TcpCommandsGen::go_msec(const AttributeType &msec, AttributeType *res) {
     char tstr[256];
     double delta = 0.001 * iclk_->getFreqHz() * msec.to_float();
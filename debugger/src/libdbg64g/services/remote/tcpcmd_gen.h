@@ -60,6 +60,9 @@ class TcpCommandsGen : public IRawListener,
     uint8_t *response_buf() { return reinterpret_cast<uint8_t *>(respbuf_); }
     int response_size() { return respcnt_; }
     void done() { respcnt_ = 0; }
+    bool isHapSubscribed(EHapType type) {
+        return ((hapSubscribed_ >> type) & 0x1) != 0;
+    }
 
  protected:
     virtual int processCommand(const char *cmdbuf, int bufsz) = 0;
@@ -78,9 +81,11 @@ class TcpCommandsGen : public IRawListener,
     void symb2addr(const char *symbol, AttributeType *res);
     void power_on(const char *btn_name, AttributeType *res);
     void power_off(const char *btn_name, AttributeType *res);
+    void subscribe(AttributeType &hap, bool ena, AttributeType *res);
 
  protected:
-    char rxbuf_[4096];
+    char *rxbuf_;
+    int rxtotal_;
     int rxcnt_;
     AttributeType platformConfig_;
     AttributeType cpu_;
@@ -103,6 +108,7 @@ class TcpCommandsGen : public IRawListener,
     event_def eventHalt_;
     event_def eventDelayMs_;
     event_def eventPowerChanged_;
+    volatile uint32_t hapSubscribed_;   // bit mask of EHapType
 
     enum EState {
         State_Idle,
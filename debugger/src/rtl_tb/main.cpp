@@ -0,0 +1,73 @@
+/*
+ *  Copyright 2018 Sergey Khabarov, sergeykhbr@gmail.com
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  Self-checking testbench and benchmark of the River arithmetic units
+ *  (sc/rtl/riverlib/core/arith and core/fpu_d):
+ *
+ *      rtl_tb [all|arith|mul|div|shift|fpu] [random_total] [seed]
+ *
+ *  Exit code is non-zero if any result differs from the reference model.
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include "tb_arith.h"
+#include "tb_fpu.h"
+
+using namespace debugger;
+
+int sc_main(int argc, char *argv[]) {
+    const char *test = argc > 1 ? argv[1] : "all";
+    uint64_t total = argc > 2 ? strtoull(argv[2], 0, 0) : 100000;
+    uint64_t seed = argc > 3 ? strtoull(argv[3], 0, 0) : 1;
+    bool t_all = strcmp(test, "all") == 0;
+    bool t_arith = t_all || strcmp(test, "arith") == 0;
+    bool t_mul = t_arith || strcmp(test, "mul") == 0;
+    bool t_div = t_arith || strcmp(test, "div") == 0;
+    bool t_shift = t_arith || strcmp(test, "shift") == 0;
+    bool t_fpu = t_all || strcmp(test, "fpu") == 0;
+    ArithTb *arith_tb = 0;
+    FpuTb *fpu_tb = 0;
+    uint64_t errors = 0;
+
+    if (!t_mul && !t_div && !t_shift && !t_fpu) {
+        printf("Usage: %s [all|arith|mul|div|shift|fpu] "
+               "[random_total] [seed]\n", argv[0]);
+        return 1;
+    }
+
+    if (t_mul || t_div || t_shift) {
+        arith_tb = new ArithTb("arith_tb", 0, total, seed,
+                               t_mul, t_div, t_shift);
+    }
+    if (t_fpu) {
+        fpu_tb = new FpuTb("fpu_tb", arith_tb, total, seed);
+    }
+
+    printf("Random operands per instruction: %" RV_PRI64 "d, seed %" RV_PRI64
+           "d\n", total, seed);
+    sc_start();
+
+    if (arith_tb) {
+        errors += arith_tb->getErrorsTotal();
+    }
+    if (fpu_tb) {
+        errors += fpu_tb->getErrorsTotal();
+    }
+    printf("%s: %" RV_PRI64 "d errors\n", errors ? "FAILED" : "PASSED",
+           errors);
+    return errors ? 1 : 0;
+}
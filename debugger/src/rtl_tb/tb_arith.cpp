@@ -0,0 +1,305 @@
+/*
+ *  Copyright 2018 Sergey Khabarov, sergeykhbr@gmail.com
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include "tb_arith.h"
+
+namespace debugger {
+
+static const uint64_t CORNER_CASES[] = {
+    0x0000000000000000ull,
+    0x0000000000000001ull,
+    0x0000000000000002ull,
+    0x000000000000001Full,
+    0x0000000000000020ull,
+    0x000000000000003Full,
+    0x0000000000000040ull,
+    0x000000007FFFFFFFull,
+    0x0000000080000000ull,
+    0x00000000FFFFFFFFull,
+    0x0000000100000000ull,
+    0x5555555555555555ull,
+    0x7FFFFFFFFFFFFFFFull,
+    0x8000000000000000ull,
+    0xAAAAAAAAAAAAAAAAull,
+    0xFFFFFFFF80000000ull,
+    0xFFFFFFFFFFFFFFFEull,
+    0xFFFFFFFFFFFFFFFFull,
+};
+
+static const uint64_t CORNER_CASES_TOTAL =
+    sizeof(CORNER_CASES) / sizeof(CORNER_CASES[0]);
+
+static uint64_t sext32(uint64_t v) {
+    return static_cast<uint64_t>(static_cast<int64_t>(
+                static_cast<int32_t>(v)));
+}
+
+/** High 64 bits of the unsigned 128-bits product without __int128 */
+static uint64_t mulhu64(uint64_t a, uint64_t b) {
+    uint64_t a_lo = a & 0xFFFFFFFFull;
+    uint64_t a_hi = a >> 32;
+    uint64_t b_lo = b & 0xFFFFFFFFull;
+    uint64_t b_hi = b >> 32;
+    uint64_t p0 = a_lo * b_lo;
+    uint64_t p1 = a_lo * b_hi;
+    uint64_t p2 = a_hi * b_lo;
+    uint64_t p3 = a_hi * b_hi;
+    uint64_t mid = (p0 >> 32) + (p1 & 0xFFFFFFFFull) + (p2 & 0xFFFFFFFFull);
+    return p3 + (p1 >> 32) + (p2 >> 32) + (mid >> 32);
+}
+
+ArithTb::ArithTb(sc_module_name name, UnitTb *prev, uint64_t total,
+                 uint64_t seed, bool mul, bool div, bool shift)
+    : UnitTb(name, prev, total, seed) {
+    ena_mul_ = mul;
+    ena_div_ = div;
+    ena_shift_ = shift;
+
+    mul0 = new IntMul("mul0", false);
+    mul0->i_clk(clk);
+    mul0->i_nrst(w_nrst);
+    mul0->i_ena(w_mul_ena);
+    mul0->i_unsigned(w_mul_unsigned);
+    mul0->i_hsu(w_mul_hsu);
+    mul0->i_high(w_mul_high);
+    mul0->i_rv32(w_mul_rv32);
+    mul0->i_a1(wb_a1);
+    mul0->i_a2(wb_a2);
+    mul0->o_res(wb_mul_res);
+    mul0->o_valid(w_mul_valid);
+
+    div0 = new IntDiv("div0", false);
+    div0->i_clk(clk);
+    div0->i_nrst(w_nrst);
+    div0->i_ena(w_div_ena);
+    div0->i_unsigned(w_div_unsigned);
+    div0->i_rv32(w_div_rv32);
+    div0->i_residual(w_div_residual);
+    div0->i_a1(wb_a1);
+    div0->i_a2(wb_a2);
+    div0->o_res(wb_div_res);
+    div0->o_valid(w_div_valid);
+
+    sh0 = new Shifter("sh0", false);
+    sh0->i_clk(clk);
+    sh0->i_nrst(w_nrst);
+    sh0->i_mode(wb_shift_mode);
+    sh0->i_a1(wb_a1);
+    sh0->i_a2(wb_shift_a2);
+    sh0->o_res(wb_shift_res);
+}
+
+ArithTb::~ArithTb() {
+    delete mul0;
+    delete div0;
+    delete sh0;
+}
+
+void ArithTb::runTests() {
+    static const MulOpType MUL_OPS[] = {
+        {"mul", false, false, false, false},
+        {"mulh", false, false, true, false},
+        {"mulhsu", false, true, true, false},
+        {"mulhu", true, false, true, false},
+        {"mulw", false, false, false, true},
+    };
+    static const DivOpType DIV_OPS[] = {
+        {"div", false, false, false},
+        {"divu", true, false, false},
+        {"rem", false, true, false},
+        {"remu", true, true, false},
+        {"divw", false, false, true},
+        {"divuw", true, false, true},
+        {"remw", false, true, true},
+        {"remuw", true, true, true},
+    };
+    // mode: [0]=rv32; [1]=sll; [2]=srl; [3]=sra
+    static const ShiftOpType SHIFT_OPS[] = {
+        {"sll", 0x2},
+        {"srl", 0x4},
+        {"sra", 0x8},
+        {"sllw", 0x3},
+        {"srlw", 0x5},
+        {"sraw", 0x9},
+    };
+
+    if (ena_mul_) {
+        for (size_t i = 0; i < sizeof(MUL_OPS) / sizeof(MulOpType); i++) {
+            testMul(&MUL_OPS[i]);
+        }
+    }
+    if (ena_div_) {
+        for (size_t i = 0; i < sizeof(DIV_OPS) / sizeof(DivOpType); i++) {
+            testDiv(&DIV_OPS[i]);
+        }
+    }
+    if (ena_shift_) {
+        for (size_t i = 0; i < sizeof(SHIFT_OPS) / sizeof(ShiftOpType); i++) {
+            testShift(&SHIFT_OPS[i]);
+        }
+    }
+}
+
+bool ArithTb::operands(uint64_t idx, uint64_t *a1, uint64_t *a2) {
+    uint64_t corners = CORNER_CASES_TOTAL * CORNER_CASES_TOTAL;
+    if (idx < corners) {
+        *a1 = CORNER_CASES[idx / CORNER_CASES_TOTAL];
+        *a2 = CORNER_CASES[idx % CORNER_CASES_TOTAL];
+        return true;
+    }
+    if (idx >= corners + total_) {
+        return false;
+    }
+    *a1 = rndOperand();
+    *a2 = rndOperand();
+    return true;
+}
+
+void ArithTb::testMul(const MulOpType *op) {
+    uint64_t a1, a2, ref;
+    startTest(op->name);
+    w_mul_unsigned.write(op->unsign);
+    w_mul_hsu.write(op->hsu);
+    w_mul_high.write(op->high);
+    w_mul_rv32.write(op->rv32);
+    for (uint64_t i = 0; operands(i, &a1, &a2); i++) {
+        wb_a1.write(a1);
+        wb_a2.write(a2);
+        w_mul_ena.write(1);
+        waitCycles(1);
+        w_mul_ena.write(0);
+        ref = refMul(op, a1, a2);
+        if (!waitValid(w_mul_valid)) {
+            timeout(a1, a2);
+            continue;
+        }
+        check(a1, a2, wb_mul_res.read().to_uint64(), ref);
+    }
+    endTest();
+}
+
+void ArithTb::testDiv(const DivOpType *op) {
+    uint64_t a1, a2, ref;
+    startTest(op->name);
+    w_div_unsigned.write(op->unsign);
+    w_div_residual.write(op->residual);
+    w_div_rv32.write(op->rv32);
+    for (uint64_t i = 0; operands(i, &a1, &a2); i++) {
+        wb_a1.write(a1);
+        wb_a2.write(a2);
+        w_div_ena.write(1);
+        waitCycles(1);
+        w_div_ena.write(0);
+        ref = refDiv(op, a1, a2);
+        if (!waitValid(w_div_valid)) {
+            timeout(a1, a2);
+            continue;
+        }
+        check(a1, a2, wb_div_res.read().to_uint64(), ref);
+    }
+    endTest();
+}
+
+void ArithTb::testShift(const ShiftOpType *op) {
+    uint64_t a1, a2;
+    startTest(op->name);
+    wb_shift_mode.write(op->mode);
+    for (uint64_t i = 0; operands(i, &a1, &a2); i++) {
+        a2 &= 0x3F;
+        wb_a1.write(a1);
+        wb_shift_a2.write(a2);
+        // Result is latched on the next rising edge
+        waitCycles(1);
+        check(a1, a2, wb_shift_res.read().to_uint64(), refShift(op, a1, a2));
+    }
+    endTest();
+}
+
+uint64_t ArithTb::refMul(const MulOpType *op, uint64_t a1, uint64_t a2) {
+    if (op->rv32) {
+        return sext32(a1 * a2);
+    }
+    if (!op->high) {
+        return a1 * a2;
+    }
+    uint64_t hi = mulhu64(a1, a2);
+    if (op->unsign) {
+        return hi;
+    }
+    // Two's complement correction of the unsigned product
+    if (static_cast<int64_t>(a1) < 0) {
+        hi -= a2;
+    }
+    if (!op->hsu && static_cast<int64_t>(a2) < 0) {
+        hi -= a1;
+    }
+    return hi;
+}
+
+uint64_t ArithTb::refDiv(const DivOpType *op, uint64_t a1, uint64_t a2) {
+    if (op->rv32) {
+        uint32_t u1 = static_cast<uint32_t>(a1);
+        uint32_t u2 = static_cast<uint32_t>(a2);
+        int32_t s1 = static_cast<int32_t>(u1);
+        int32_t s2 = static_cast<int32_t>(u2);
+        if (u2 == 0) {
+            return op->residual ? sext32(u1) : ~0ull;
+        }
+        if (op->unsign) {
+            return sext32(op->residual ? u1 % u2 : u1 / u2);
+        }
+        if (s1 == INT32_MIN && s2 == -1) {
+            return op->residual ? 0 : sext32(u1);
+        }
+        return sext32(static_cast<uint32_t>(op->residual ? s1 % s2
+                                                         : s1 / s2));
+    }
+
+    int64_t s1 = static_cast<int64_t>(a1);
+    int64_t s2 = static_cast<int64_t>(a2);
+    if (a2 == 0) {
+        return op->residual ? a1 : ~0ull;
+    }
+    if (op->unsign) {
+        return op->residual ? a1 % a2 : a1 / a2;
+    }
+    if (s1 == INT64_MIN && s2 == -1) {
+        return op->residual ? 0 : a1;
+    }
+    return static_cast<uint64_t>(op->residual ? s1 % s2 : s1 / s2);
+}
+
+uint64_t ArithTb::refShift(const ShiftOpType *op, uint64_t a1, uint64_t a2) {
+    if (op->mode & 0x1) {
+        uint32_t v = static_cast<uint32_t>(a1);
+        int sh = static_cast<int>(a2 & 0x1F);
+        if (op->mode & 0x2) {
+            return sext32(v << sh);
+        } else if (op->mode & 0x4) {
+            return sext32(v >> sh);
+        }
+        return sext32(static_cast<uint32_t>(static_cast<int32_t>(v) >> sh));
+    }
+    int sh = static_cast<int>(a2 & 0x3F);
+    if (op->mode & 0x2) {
+        return a1 << sh;
+    } else if (op->mode & 0x4) {
+        return a1 >> sh;
+    }
+    return static_cast<uint64_t>(static_cast<int64_t>(a1) >> sh);
+}
+
+}  // namespace debugger
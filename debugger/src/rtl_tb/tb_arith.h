@@ -0,0 +1,101 @@
+/*
+ *  Copyright 2018 Sergey Khabarov, sergeykhbr@gmail.com
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#pragma once
+
+#include "tb_common.h"
+#include "riverlib/core/arith/int_mul.h"
+#include "riverlib/core/arith/int_div.h"
+#include "riverlib/core/arith/shift.h"
+
+namespace debugger {
+
+/**
+ * @brief Testbench of the integer arithmetic units IntMul, IntDiv, Shifter.
+ * @details Every instruction of the M-extension and every shift is checked
+ *          against the RISC-V specification model: first all pairs of the
+ *          corner case operands, then 'total' random pairs.
+ */
+class ArithTb : public UnitTb {
+ public:
+    ArithTb(sc_module_name name, UnitTb *prev, uint64_t total, uint64_t seed,
+            bool mul, bool div, bool shift);
+    virtual ~ArithTb();
+
+ protected:
+    virtual void runTests();
+
+ private:
+    struct MulOpType {
+        const char *name;
+        bool unsign;
+        bool hsu;
+        bool high;
+        bool rv32;
+    };
+    struct DivOpType {
+        const char *name;
+        bool unsign;
+        bool residual;
+        bool rv32;
+    };
+    struct ShiftOpType {
+        const char *name;
+        uint8_t mode;
+    };
+
+    void testMul(const MulOpType *op);
+    void testDiv(const DivOpType *op);
+    void testShift(const ShiftOpType *op);
+    bool operands(uint64_t idx, uint64_t *a1, uint64_t *a2);
+
+    uint64_t refMul(const MulOpType *op, uint64_t a1, uint64_t a2);
+    uint64_t refDiv(const DivOpType *op, uint64_t a1, uint64_t a2);
+    uint64_t refShift(const ShiftOpType *op, uint64_t a1, uint64_t a2);
+
+ private:
+    bool ena_mul_;
+    bool ena_div_;
+    bool ena_shift_;
+
+    IntMul *mul0;
+    IntDiv *div0;
+    Shifter *sh0;
+
+    sc_signal<bool> w_mul_ena;
+    sc_signal<bool> w_mul_unsigned;
+    sc_signal<bool> w_mul_hsu;
+    sc_signal<bool> w_mul_high;
+    sc_signal<bool> w_mul_rv32;
+    sc_signal<sc_uint<RISCV_ARCH>> wb_mul_res;
+    sc_signal<bool> w_mul_valid;
+
+    sc_signal<bool> w_div_ena;
+    sc_signal<bool> w_div_unsigned;
+    sc_signal<bool> w_div_rv32;
+    sc_signal<bool> w_div_residual;
+    sc_signal<sc_uint<RISCV_ARCH>> wb_div_res;
+    sc_signal<bool> w_div_valid;
+
+    sc_signal<sc_uint<4>> wb_shift_mode;
+    sc_signal<sc_uint<6>> wb_shift_a2;
+    sc_signal<sc_uint<RISCV_ARCH>> wb_shift_res;
+
+    sc_signal<sc_uint<RISCV_ARCH>> wb_a1;
+    sc_signal<sc_uint<RISCV_ARCH>> wb_a2;
+};
+
+}  // namespace debugger
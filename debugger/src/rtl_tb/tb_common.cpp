@@ -0,0 +1,156 @@
+/*
+ *  Copyright 2018 Sergey Khabarov, sergeykhbr@gmail.com
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include <api_core.h>
+#include <stdio.h>
+#include "tb_common.h"
+
+namespace debugger {
+
+int UnitTb::active_ = 0;
+
+UnitTb::UnitTb(sc_module_name name, UnitTb *prev, uint64_t total,
+               uint64_t seed)
+    : sc_module(name),
+    clk("clk", CLK_PERIOD_NS, SC_NS),
+    w_nrst("w_nrst") {
+    total_ = total;
+    prev_ = prev;
+    done_ = false;
+    rndState_ = seed ? seed : 0x2545F4914F6CDD1Dull;
+    errTotal_ = 0;
+    testName_ = "";
+    opcnt_ = 0;
+    errcnt_ = 0;
+    warncnt_ = 0;
+    tstart_ = 0;
+    active_++;
+
+    SC_THREAD(test_proc);
+}
+
+void UnitTb::test_proc() {
+    w_nrst.write(0);
+    if (prev_ && !prev_->isDone()) {
+        wait(prev_->doneEvent());
+    }
+    waitCycles(4);
+    w_nrst.write(1);
+    waitCycles(2);
+
+    runTests();
+
+    done_ = true;
+    done_ev_.notify(SC_ZERO_TIME);
+    if (--active_ == 0) {
+        sc_stop();
+    }
+}
+
+void UnitTb::waitCycles(int cycles) {
+    for (int i = 0; i < cycles; i++) {
+        wait(clk.negedge_event());
+    }
+}
+
+bool UnitTb::waitValid(sc_signal<bool> &valid) {
+    for (int i = 0; i < VALID_TIMEOUT; i++) {
+        if (valid.read()) {
+            return true;
+        }
+        waitCycles(1);
+    }
+    return false;
+}
+
+void UnitTb::startTest(const char *name) {
+    testName_ = name;
+    opcnt_ = 0;
+    errcnt_ = 0;
+    warncnt_ = 0;
+    tstart_ = RISCV_get_time_ms();
+    simstart_ = sc_time_stamp();
+}
+
+void UnitTb::endTest() {
+    uint64_t dt = RISCV_get_time_ms() - tstart_;
+    double cycles = (sc_time_stamp() - simstart_)
+                    / sc_time(CLK_PERIOD_NS, SC_NS);
+    double per_op = opcnt_ ? cycles / static_cast<double>(opcnt_) : 0;
+    double ops_sec = dt ? 1000.0 * static_cast<double>(opcnt_) / dt : 0;
+
+    printf("%-12s %10" RV_PRI64 "d ops %8" RV_PRI64 "d errors "
+           "%8" RV_PRI64 "d warnings %6.2f cycles/op %10.0f ops/s\n",
+           testName_, opcnt_, errcnt_, warncnt_, per_op, ops_sec);
+    errTotal_ += errcnt_;
+}
+
+bool UnitTb::check(uint64_t a, uint64_t b, uint64_t res, uint64_t ref) {
+    opcnt_++;
+    if (res == ref) {
+        return true;
+    }
+    if (errcnt_++ < ERRORS_PRINT_MAX) {
+        printf("    %s %016" RV_PRI64 "x; %016" RV_PRI64 "x => "
+               "%016" RV_PRI64 "x != %016" RV_PRI64 "x\n",
+               testName_, a, b, res, ref);
+    }
+    return false;
+}
+
+void UnitTb::warning(uint64_t a, uint64_t b, uint64_t res, uint64_t ref) {
+    opcnt_++;
+    if (warncnt_++ < ERRORS_PRINT_MAX) {
+        printf("    %s relative host difference: %016" RV_PRI64 "x; "
+               "%016" RV_PRI64 "x => %016" RV_PRI64 "x != %016" RV_PRI64 "x\n",
+               testName_, a, b, res, ref);
+    }
+}
+
+void UnitTb::timeout(uint64_t a, uint64_t b) {
+    opcnt_++;
+    if (errcnt_++ < ERRORS_PRINT_MAX) {
+        printf("    %s %016" RV_PRI64 "x; %016" RV_PRI64 "x => timeout\n",
+               testName_, a, b);
+    }
+}
+
+uint64_t UnitTb::rnd() {
+    // xorshift64*: the same sequence on all hosts for the same seed
+    rndState_ ^= rndState_ >> 12;
+    rndState_ ^= rndState_ << 25;
+    rndState_ ^= rndState_ >> 27;
+    return rndState_ * 0x2545F4914F6CDD1Dull;
+}
+
+uint64_t UnitTb::rndOperand() {
+    uint64_t v = rnd();
+    int shift = static_cast<int>(rnd() & 0x3F);
+    switch (rnd() & 0x3) {
+    case 0:
+        return v;
+    case 1:
+        return v >> shift;
+    case 2:
+        return ~(v >> shift);
+    default:
+        // 32-bits sign extended value
+        return static_cast<uint64_t>(static_cast<int64_t>(
+                    static_cast<int32_t>(v >> shift)));
+    }
+}
+
+}  // namespace debugger
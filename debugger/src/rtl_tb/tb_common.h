@@ -0,0 +1,96 @@
+/*
+ *  Copyright 2018 Sergey Khabarov, sergeykhbr@gmail.com
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#pragma once
+
+#include <systemc.h>
+#include <api_types.h>
+
+namespace debugger {
+
+/**
+ * @brief Base class of the self-checking unit testbenches.
+ * @details Each derived testbench owns its clock and DUT instances and runs
+ *          its tests from test_proc(). Stimulus is written and results are
+ *          sampled on the falling clock edge so all rising edge updates of
+ *          the DUT are already settled.
+ *
+ *          Testbenches run one after another: the next one waits for the
+ *          'prev' testbench to finish and the last one stops simulation.
+ *          For each test the following statistic is printed:
+ *             - number of checked operations and mismatches;
+ *             - simulated clock cycles per operation (latency of the unit);
+ *             - host operations per second (simulation throughput).
+ */
+class UnitTb : public sc_module {
+ public:
+    SC_HAS_PROCESS(UnitTb);
+
+    UnitTb(sc_module_name name, UnitTb *prev, uint64_t total, uint64_t seed);
+
+    bool isDone() { return done_; }
+    sc_event &doneEvent() { return done_ev_; }
+    uint64_t getErrorsTotal() { return errTotal_; }
+
+ protected:
+    void test_proc();
+    /** Called from test_proc() after reset */
+    virtual void runTests() = 0;
+
+    void waitCycles(int cycles);
+    /** Wait for the result of the multi-cycle unit, false on timeout */
+    bool waitValid(sc_signal<bool> &valid);
+    void startTest(const char *name);
+    void endTest();
+    /** Returns false when the result differs from the reference */
+    bool check(uint64_t a, uint64_t b, uint64_t res, uint64_t ref);
+    /** Difference that isn't counted as an error (host specific result) */
+    void warning(uint64_t a, uint64_t b, uint64_t res, uint64_t ref);
+    /** Unit didn't respond */
+    void timeout(uint64_t a, uint64_t b);
+    uint64_t rnd();
+    /** Random operand with random leading zeros/ones to cover all widths */
+    uint64_t rndOperand();
+
+ protected:
+    static const int CLK_PERIOD_NS = 10;
+    static const uint64_t ERRORS_PRINT_MAX = 16;
+    /** fdiv.d is the longest operation */
+    static const int VALID_TIMEOUT = 256;
+
+    sc_clock clk;
+    sc_signal<bool> w_nrst;
+
+    uint64_t total_;
+
+ private:
+    UnitTb *prev_;
+    bool done_;
+    sc_event done_ev_;
+    uint64_t rndState_;
+    uint64_t errTotal_;
+
+    const char *testName_;
+    uint64_t opcnt_;
+    uint64_t errcnt_;
+    uint64_t warncnt_;
+    uint64_t tstart_;
+    sc_time simstart_;
+
+    static int active_;
+};
+
+}  // namespace debugger
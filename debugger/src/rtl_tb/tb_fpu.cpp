@@ -0,0 +1,212 @@
+/*
+ *  Copyright 2018 Sergey Khabarov, sergeykhbr@gmail.com
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include "tb_fpu.h"
+#include "socsim_plugin/fpu_func_tests.h"
+
+namespace debugger {
+
+#define TB_CASES(arr) &arr[0][0], (sizeof(arr) / sizeof(arr[0]))
+
+static const uint64_t EXP_BIAS = 1023;
+
+FpuTb::FpuTb(sc_module_name name, UnitTb *prev, uint64_t total,
+             uint64_t seed)
+    : UnitTb(name, prev, total, seed) {
+    fpu0 = new FpuTop("fpu0", false);
+    fpu0->i_clk(clk);
+    fpu0->i_nrst(w_nrst);
+    fpu0->i_ena(w_ena);
+    fpu0->i_ivec(wb_ivec);
+    fpu0->i_a(wb_a);
+    fpu0->i_b(wb_b);
+    fpu0->o_res(wb_res);
+    fpu0->o_ex_invalidop(w_ex_invalidop);
+    fpu0->o_ex_divbyzero(w_ex_divbyzero);
+    fpu0->o_ex_overflow(w_ex_overflow);
+    fpu0->o_ex_underflow(w_ex_underflow);
+    fpu0->o_ex_inexact(w_ex_inexact);
+    fpu0->o_valid(w_valid);
+}
+
+FpuTb::~FpuTb() {
+    delete fpu0;
+}
+
+void FpuTb::runTests() {
+    static const FpuOpType FPU_OPS[] = {
+        {"fadd.d", Instr_FADD_D, Operands_Arith, TB_CASES(TestCases_FADD_D)},
+        {"fsub.d", Instr_FSUB_D, Operands_Arith, TB_CASES(TestCases_FSUB_D)},
+        {"fmul.d", Instr_FMUL_D, Operands_Arith, TB_CASES(TestCases_FMUL_D)},
+        {"fdiv.d", Instr_FDIV_D, Operands_Arith, TB_CASES(TestCases_FDIV_D)},
+        {"fmin.d", Instr_FMIN_D, Operands_Arith, TB_CASES(TestCases_FCMP_D)},
+        {"fmax.d", Instr_FMAX_D, Operands_Arith, TB_CASES(TestCases_FCMP_D)},
+        {"fcvt.d.l", Instr_FCVT_D_L, Operands_Integer,
+                    TB_CASES(TestCases_FCVT_D_L)},
+        {"fcvt.d.lu", Instr_FCVT_D_LU, Operands_Integer,
+                    TB_CASES(TestCases_FCVT_D_L)},
+        {"fcvt.d.w", Instr_FCVT_D_W, Operands_Integer,
+                    TB_CASES(TestCases_FCVT_D_W)},
+        {"fcvt.d.wu", Instr_FCVT_D_WU, Operands_Integer,
+                    TB_CASES(TestCases_FCVT_D_W)},
+        {"fcvt.l.d", Instr_FCVT_L_D, Operands_Double64,
+                    TB_CASES(TestCases_FCVT_L_D)},
+        {"fcvt.lu.d", Instr_FCVT_LU_D, Operands_DoubleU64,
+                    TB_CASES(TestCases_FCVT_L_D)},
+        {"fcvt.w.d", Instr_FCVT_W_D, Operands_Double32,
+                    TB_CASES(TestCases_FCVT_W_D)},
+        {"fcvt.wu.d", Instr_FCVT_WU_D, Operands_DoubleU32,
+                    TB_CASES(TestCases_FCVT_W_D)},
+    };
+
+    for (size_t i = 0; i < sizeof(FPU_OPS) / sizeof(FpuOpType); i++) {
+        testOp(&FPU_OPS[i]);
+    }
+}
+
+uint64_t FpuTb::rndDouble(uint64_t exp_max, bool positive) {
+    Reg64Type t;
+    t.val = rnd();
+    t.f64bits.exp = rnd() % (exp_max + 1);
+    if (positive) {
+        t.f64bits.sign = 0;
+    }
+    return t.val;
+}
+
+bool FpuTb::operands(const FpuOpType *op, uint64_t idx, Reg64Type *a,
+                     Reg64Type *b) {
+    if (idx < op->cases_total) {
+        a->val = op->cases[2*idx];
+        b->val = op->cases[2*idx + 1];
+        return true;
+    }
+    if (idx >= op->cases_total + total_) {
+        return false;
+    }
+
+    b->val = rnd();
+    switch (op->operands) {
+    case Operands_Arith:
+        a->val = rnd();
+        if (rnd() & 0x1) {
+            // Close exponents: mantissa alignment and cancellation paths
+            int64_t exp = static_cast<int64_t>(a->f64bits.exp)
+                        + static_cast<int64_t>(rnd() % 128) - 64;
+            if (exp < 0) {
+                exp = 0;
+            } else if (exp > 0x7FE) {
+                exp = 0x7FE;
+            }
+            b->f64bits.exp = static_cast<uint64_t>(exp);
+        }
+        break;
+    case Operands_Integer:
+        a->val = rndOperand();
+        break;
+    case Operands_Double64:
+        a->val = rndDouble(EXP_BIAS + 62, false);
+        break;
+    case Operands_DoubleU64:
+        a->val = rndDouble(EXP_BIAS + 63, true);
+        break;
+    case Operands_Double32:
+        a->val = rndDouble(EXP_BIAS + 30, false);
+        break;
+    default:
+        a->val = rndDouble(EXP_BIAS + 31, true);
+    }
+    return true;
+}
+
+uint64_t FpuTb::reference(const FpuOpType *op, Reg64Type a, Reg64Type b) {
+    Reg64Type fref;
+    switch (op->instr) {
+    case Instr_FADD_D:
+        fref.f64 = a.f64 + b.f64;
+        break;
+    case Instr_FSUB_D:
+        fref.f64 = a.f64 - b.f64;
+        break;
+    case Instr_FMUL_D:
+        fref.f64 = a.f64 * b.f64;
+        break;
+    case Instr_FDIV_D:
+        fref.f64 = a.f64 / b.f64;
+        break;
+    case Instr_FMIN_D:
+        fref.f64 = a.f64 < b.f64 ? a.f64: b.f64;
+        break;
+    case Instr_FMAX_D:
+        fref.f64 = a.f64 > b.f64 ? a.f64: b.f64;
+        break;
+    case Instr_FCVT_D_L:
+        fref.f64 = static_cast<double>(a.ival);
+        break;
+    case Instr_FCVT_D_LU:
+        fref.f64 = static_cast<double>(a.val);
+        break;
+    case Instr_FCVT_D_W:
+        fref.f64 = static_cast<double>(static_cast<int32_t>(a.buf32[0]));
+        break;
+    case Instr_FCVT_D_WU:
+        fref.f64 = static_cast<double>(a.buf32[0]);
+        break;
+    case Instr_FCVT_L_D:
+        fref.ival = static_cast<int64_t>(a.f64);
+        break;
+    case Instr_FCVT_LU_D:
+        fref.val = static_cast<uint64_t>(a.f64);
+        break;
+    case Instr_FCVT_W_D:
+        fref.ival = static_cast<int32_t>(a.f64);
+        break;
+    default:
+        fref.val = static_cast<uint32_t>(a.f64);
+    }
+    return fref.val;
+}
+
+void FpuTb::testOp(const FpuOpType *op) {
+    Reg64Type a, b;
+    uint64_t res, ref;
+
+    startTest(op->name);
+    wb_ivec.write(1ull << (op->instr - Instr_FPU_First));
+    for (uint64_t i = 0; operands(op, i, &a, &b); i++) {
+        wb_a.write(a.val);
+        wb_b.write(b.val);
+        w_ena.write(1);
+        waitCycles(1);
+        w_ena.write(0);
+        ref = reference(op, a, b);
+        if (!waitValid(w_valid)) {
+            timeout(a.val, b.val);
+            continue;
+        }
+
+        res = wb_res.read().to_uint64();
+        if (res != ref && (a.f64bits.exp == 0x7FF || b.f64bits.exp == 0x7FF)
+            && op->operands != Operands_Integer) {
+            warning(a.val, b.val, res, ref);
+        } else {
+            check(a.val, b.val, res, ref);
+        }
+    }
+    endTest();
+}
+
+}  // namespace debugger
@@ -0,0 +1,80 @@
+/*
+ *  Copyright 2018 Sergey Khabarov, sergeykhbr@gmail.com
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#pragma once
+
+#include "tb_common.h"
+#include "riverlib/core/fpu_d/fpu_top.h"
+
+namespace debugger {
+
+/**
+ * @brief Testbench of the double precision FPU (FpuTop).
+ * @details The same instructions and corner cases as FpuFunctional
+ *          ('fputest' command) use are checked against the host FPU:
+ *          first the manual test cases from fpu_func_tests.h, then 'total'
+ *          random operands. As in FpuFunctional a difference with NaN or
+ *          Inf operand is reported as a host specific warning only.
+ */
+class FpuTb : public UnitTb {
+ public:
+    FpuTb(sc_module_name name, UnitTb *prev, uint64_t total, uint64_t seed);
+    virtual ~FpuTb();
+
+ protected:
+    virtual void runTests();
+
+ private:
+    enum EOperands {
+        Operands_Arith,     // any double values
+        Operands_Integer,   // integer A
+        Operands_Double64,  // double A in range of int64
+        Operands_DoubleU64, // double A in range of uint64
+        Operands_Double32,  // double A in range of int32
+        Operands_DoubleU32, // double A in range of uint32
+    };
+
+    struct FpuOpType {
+        const char *name;
+        int instr;
+        EOperands operands;
+        const uint64_t *cases;
+        size_t cases_total;
+    };
+
+    void testOp(const FpuOpType *op);
+    bool operands(const FpuOpType *op, uint64_t idx, Reg64Type *a,
+                  Reg64Type *b);
+    uint64_t rndDouble(uint64_t exp_max, bool positive);
+    uint64_t reference(const FpuOpType *op, Reg64Type a, Reg64Type b);
+
+ private:
+    FpuTop *fpu0;
+
+    sc_signal<bool> w_ena;
+    sc_signal<sc_uint<Instr_FPU_Total>> wb_ivec;
+    sc_signal<sc_uint<64>> wb_a;
+    sc_signal<sc_uint<64>> wb_b;
+    sc_signal<sc_uint<64>> wb_res;
+    sc_signal<bool> w_ex_invalidop;
+    sc_signal<bool> w_ex_divbyzero;
+    sc_signal<bool> w_ex_overflow;
+    sc_signal<bool> w_ex_underflow;
+    sc_signal<bool> w_ex_inexact;
+    sc_signal<bool> w_valid;
+};
+
+}  // namespace debugger
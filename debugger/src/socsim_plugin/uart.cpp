@@ -32,6 +32,7 @@ UART::UART(const char *name) : RegMemBankGeneric(name),
     fwcpuid_(static_cast<IService *>(this), "fwcpuid", 0x1C) {
     registerInterface(static_cast<ISerial *>(this));
     registerInterface(static_cast<IClockListener *>(this));
+    registerInterface(static_cast<IInputSource *>(this));
     registerAttribute("FifoSize", &fifoSize_);
     registerAttribute("IrqController", &irqctrl_);
     registerAttribute("IrqIdRx", &irqidrx_);
@@ -45,6 +46,7 @@ UART::UART(const char *name) : RegMemBankGeneric(name),
     rxfifo_ = 0;
     rx_total_ = 0;
     pcmd_ = 0;
+    irec_ = 0;
 
     tx_total_ = 0;
     tx_wcnt_ = 0;
@@ -96,12 +98,25 @@ void UART::postinitService() {
                                 getObjName());
         icmdexec_->registerCommand(pcmd_);
     }
+
+    AttributeType lstServ;
+    RISCV_get_services_with_iface(IFACE_INPUT_RECORDER, &lstServ);
+    if (lstServ.size() != 0) {
+        IService *iserv = static_cast<IService *>(lstServ[0u].to_iface());
+        irec_ = static_cast<IInputRecorder *>(
+                            iserv->getInterface(IFACE_INPUT_RECORDER));
+        irec_->registerInputSource(getObjName(),
+                                   static_cast<IInputSource *>(this));
+    }
 }
 
 void UART::predeleteService() {
     if (icmdexec_) {
         icmdexec_->unregisterCommand(pcmd_);
     }
+    if (irec_) {
+        irec_->unregisterInputSource(static_cast<IInputSource *>(this));
+    }
 }
 
 uint32_t UART::getScaler() {
@@ -113,6 +128,26 @@ uint32_t UART::getScaler() {
 }
 
 int UART::writeData(const char *buf, int sz) {
+    if (irec_) {
+        AttributeType ev;
+        ev.make_list(2);
+        ev[0u].make_string("rx");
+        ev[1].make_data(static_cast<unsigned>(sz), buf);
+        if (irec_->putInput(static_cast<IInputSource *>(this), &ev)) {
+            return sz;
+        }
+    }
+    return receiveData(buf, sz);
+}
+
+void UART::applyInput(AttributeType *event) {
+    if ((*event)[0u].is_equal("rx")) {
+        receiveData(reinterpret_cast<const char *>((*event)[1].data()),
+                    static_cast<int>((*event)[1].size()));
+    }
+}
+
+int UART::receiveData(const char *buf, int sz) {
     if (rxfifo_ == 0) {
         return 0;
     }
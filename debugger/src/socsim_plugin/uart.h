@@ -25,6 +25,7 @@
 #include "coreservices/iclock.h"
 #include "coreservices/icommand.h"
 #include "coreservices/icmdexec.h"
+#include "coreservices/iinputrec.h"
 #include "generic/mapreg.h"
 #include "generic/rmembank_gen1.h"
 
@@ -68,7 +69,8 @@ class UartCmdType : public ICommand {
 
 class UART : public RegMemBankGeneric,
              public ISerial,
-             public IClockListener {
+             public IClockListener,
+             public IInputSource {
  public:
     explicit UART(const char *name);
     virtual ~UART();
@@ -88,6 +90,9 @@ class UART : public RegMemBankGeneric,
     /** IClockListener */
     virtual void stepCallback(uint64_t t);
 
+    /** IInputSource */
+    virtual void applyInput(AttributeType *event);
+
     /** Common methods */
     uint32_t getScaler();
     int getFifoSize() { return fifoSize_.to_int(); }
@@ -98,6 +103,9 @@ class UART : public RegMemBankGeneric,
     void putByte(char v);
     char getByte();
 
+ protected:
+    int receiveData(const char *buf, int sz);
+
  protected:
     class TXCTRL_TYPE : public MappedReg32Type {
      public:
@@ -232,6 +240,7 @@ class UART : public RegMemBankGeneric,
     ICmdExecutor *icmdexec_;
     IClock *iclk_;
     IIrqController *iirq_;
+    IInputRecorder *irec_;
 
     char *rxfifo_;
     char *p_rx_wr_;
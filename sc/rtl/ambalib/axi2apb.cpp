@@ -60,8 +60,6 @@ axi2apb::axi2apb(sc_module_name name,
 
     SC_METHOD(comb);
     sensitive << i_nrst;
-    sensitive << i_mapinfo;
-    sensitive << i_xslvi;
     for (int i = 0; i < CFG_BUS1_PSLV_TOTAL; i++) {
         sensitive << i_apbo[i];
     }
@@ -72,7 +70,6 @@ axi2apb::axi2apb(sc_module_name name,
     sensitive << wb_req_wdata;
     sensitive << wb_req_wstrb;
     sensitive << w_req_last;
-    sensitive << w_req_ready;
     sensitive << r.state;
     sensitive << r.selidx;
     sensitive << r.pvalid;
@@ -59,8 +59,6 @@ apb_ddr::apb_ddr(sc_module_name name,
 
     SC_METHOD(comb);
     sensitive << i_nrst;
-    sensitive << i_mapinfo;
-    sensitive << i_apbi;
     sensitive << i_pll_locked;
     sensitive << i_init_calib_done;
     sensitive << i_device_temp;
@@ -69,8 +67,6 @@ apb_ddr::apb_ddr(sc_module_name name,
     sensitive << i_zq_ack;
     sensitive << w_req_valid;
     sensitive << wb_req_addr;
-    sensitive << w_req_write;
-    sensitive << wb_req_wdata;
     sensitive << r.pll_locked;
     sensitive << r.init_calib_done;
     sensitive << r.device_temp;
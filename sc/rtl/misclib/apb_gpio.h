@@ -122,8 +122,6 @@ apb_gpio<width>::apb_gpio(sc_module_name name,
 
     SC_METHOD(comb);
     sensitive << i_nrst;
-    sensitive << i_mapinfo;
-    sensitive << i_apbi;
     sensitive << i_gpio;
     sensitive << w_req_valid;
     sensitive << wb_req_addr;
@@ -62,12 +62,9 @@ apb_prci::apb_prci(sc_module_name name,
     sensitive << i_dmireset;
     sensitive << i_sys_locked;
     sensitive << i_ddr_locked;
-    sensitive << i_mapinfo;
-    sensitive << i_apbi;
     sensitive << w_req_valid;
     sensitive << wb_req_addr;
     sensitive << w_req_write;
-    sensitive << wb_req_wdata;
     sensitive << r.sys_rst;
     sensitive << r.sys_nrst;
     sensitive << r.dbg_nrst;
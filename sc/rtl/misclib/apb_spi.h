@@ -194,8 +194,6 @@ apb_spi<log2_fifosz>::apb_spi(sc_module_name name,
 
     SC_METHOD(comb);
     sensitive << i_nrst;
-    sensitive << i_mapinfo;
-    sensitive << i_apbi;
     sensitive << i_miso;
     sensitive << i_detected;
     sensitive << i_protect;
@@ -203,14 +201,8 @@ apb_spi<log2_fifosz>::apb_spi(sc_module_name name,
     sensitive << wb_req_addr;
     sensitive << w_req_write;
     sensitive << wb_req_wdata;
-    sensitive << w_rxfifo_we;
-    sensitive << wb_rxfifo_wdata;
-    sensitive << w_rxfifo_re;
     sensitive << wb_rxfifo_rdata;
     sensitive << wb_rxfifo_count;
-    sensitive << w_txfifo_we;
-    sensitive << wb_txfifo_wdata;
-    sensitive << w_txfifo_re;
     sensitive << wb_txfifo_rdata;
     sensitive << wb_txfifo_count;
     sensitive << r.scaler;
@@ -146,8 +146,6 @@ apb_uart<log2_fifosz>::apb_uart(sc_module_name name,
 
     SC_METHOD(comb);
     sensitive << i_nrst;
-    sensitive << i_mapinfo;
-    sensitive << i_apbi;
     sensitive << i_rd;
     sensitive << w_req_valid;
     sensitive << wb_req_addr;
@@ -160,62 +160,9 @@ riscv_soc::riscv_soc(sc_module_name name)
 
 
     SC_METHOD(comb);
-    sensitive << i_sys_nrst;
-    sensitive << i_sys_clk;
-    sensitive << i_dbg_nrst;
-    sensitive << i_ddr_nrst;
-    sensitive << i_ddr_clk;
-    sensitive << i_gpio;
-    sensitive << i_jtag_trst;
-    sensitive << i_jtag_tck;
-    sensitive << i_jtag_tms;
-    sensitive << i_jtag_tdi;
-    sensitive << i_uart1_rd;
-    sensitive << i_spi_miso;
-    sensitive << i_sd_detected;
-    sensitive << i_sd_protect;
-    sensitive << i_prci_apbo;
-    sensitive << i_ddr_apbo;
-    sensitive << i_ddr_xslvo;
-    sensitive << acpo;
-    sensitive << acpi;
-    for (int i = 0; i < CFG_BUS0_XSLV_TOTAL; i++) {
-        sensitive << bus0_mapinfo[i];
-    }
-    for (int i = 0; i < CFG_BUS0_XMST_TOTAL; i++) {
-        sensitive << aximi[i];
-    }
-    for (int i = 0; i < CFG_BUS0_XMST_TOTAL; i++) {
-        sensitive << aximo[i];
-    }
-    for (int i = 0; i < CFG_BUS0_XSLV_TOTAL; i++) {
-        sensitive << axisi[i];
-    }
-    for (int i = 0; i < CFG_BUS0_XSLV_TOTAL; i++) {
-        sensitive << axiso[i];
-    }
-    for (int i = 0; i < CFG_BUS1_PSLV_TOTAL; i++) {
-        sensitive << bus1_mapinfo[i];
-    }
-    for (int i = 0; i < CFG_BUS1_PSLV_TOTAL; i++) {
-        sensitive << apbi[i];
-    }
-    for (int i = 0; i < CFG_BUS1_PSLV_TOTAL; i++) {
-        sensitive << apbo[i];
-    }
-    for (int i = 0; i < SOC_PNP_TOTAL; i++) {
-        sensitive << dev_pnp[i];
-    }
-    sensitive << wb_clint_mtimer;
-    sensitive << wb_clint_msip;
-    sensitive << wb_clint_mtip;
-    sensitive << wb_plic_xeip;
-    sensitive << wb_plic_meip;
-    sensitive << wb_plic_seip;
     sensitive << w_irq_uart1;
     sensitive << wb_irq_gpio;
     sensitive << w_irq_pnp;
-    sensitive << wb_ext_irqs;
 }
 
 riscv_soc::~riscv_soc() {
@@ -210,48 +210,19 @@ CacheTop::CacheTop(sc_module_name name,
 
 
     SC_METHOD(comb);
-    sensitive << i_nrst;
-    sensitive << i_req_ctrl_valid;
     sensitive << i_req_ctrl_addr;
-    sensitive << i_resp_ctrl_ready;
-    sensitive << i_req_data_valid;
-    sensitive << i_req_data_type;
     sensitive << i_req_data_addr;
-    sensitive << i_req_data_wdata;
-    sensitive << i_req_data_wstrb;
-    sensitive << i_req_data_size;
-    sensitive << i_resp_data_ready;
     sensitive << i_req_mem_ready;
     sensitive << i_resp_mem_valid;
     sensitive << i_resp_mem_path;
     sensitive << i_resp_mem_data;
     sensitive << i_resp_mem_load_fault;
-    sensitive << i_resp_mem_store_fault;
-    sensitive << i_pmp_ena;
-    sensitive << i_pmp_we;
-    sensitive << i_pmp_region;
-    sensitive << i_pmp_start_addr;
-    sensitive << i_pmp_end_addr;
-    sensitive << i_pmp_flags;
-    sensitive << i_req_snoop_valid;
-    sensitive << i_req_snoop_type;
-    sensitive << i_req_snoop_addr;
-    sensitive << i_resp_snoop_ready;
-    sensitive << i_flushi_valid;
     sensitive << i_flushi_addr;
-    sensitive << i_flushd_valid;
     sensitive << i_flushd_addr;
-    sensitive << wb_i_req_ctrl_addr;
-    sensitive << wb_i_req_data_addr;
-    sensitive << wb_i_flushi_addr;
-    sensitive << wb_i_flushd_addr;
     sensitive << i.req_mem_valid;
     sensitive << i.req_mem_type;
     sensitive << i.req_mem_size;
     sensitive << i.req_mem_addr;
-    sensitive << i.req_mem_strob;
-    sensitive << i.req_mem_wdata;
-    sensitive << i.mpu_addr;
     sensitive << i.resp_addr;
     sensitive << d.req_mem_valid;
     sensitive << d.req_mem_type;
@@ -259,26 +230,8 @@ CacheTop::CacheTop(sc_module_name name,
     sensitive << d.req_mem_addr;
     sensitive << d.req_mem_strob;
     sensitive << d.req_mem_wdata;
-    sensitive << d.mpu_addr;
     sensitive << d.resp_addr;
-    sensitive << w_ctrl_resp_mem_data_valid;
-    sensitive << wb_ctrl_resp_mem_data;
-    sensitive << w_ctrl_resp_mem_load_fault;
-    sensitive << w_ctrl_req_ready;
-    sensitive << w_data_resp_mem_data_valid;
-    sensitive << wb_data_resp_mem_data;
-    sensitive << w_data_resp_mem_load_fault;
-    sensitive << w_data_req_ready;
-    sensitive << w_pma_icached;
-    sensitive << w_pma_dcached;
-    sensitive << w_pmp_r;
-    sensitive << w_pmp_w;
-    sensitive << w_pmp_x;
-    sensitive << queue_re_i;
-    sensitive << queue_we_i;
-    sensitive << queue_wdata_i;
     sensitive << queue_rdata_o;
-    sensitive << queue_full_o;
     sensitive << queue_nempty_o;
 }
 
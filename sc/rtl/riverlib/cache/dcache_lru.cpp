@@ -121,22 +121,12 @@ DCacheLru::DCacheLru(sc_module_name name,
     sensitive << i_req_snoop_valid;
     sensitive << i_req_snoop_type;
     sensitive << i_req_snoop_addr;
-    sensitive << i_resp_snoop_ready;
     sensitive << i_flush_address;
     sensitive << i_flush_valid;
-    sensitive << line_direct_access_i;
-    sensitive << line_invalidate_i;
-    sensitive << line_re_i;
-    sensitive << line_we_i;
-    sensitive << line_addr_i;
-    sensitive << line_wdata_i;
-    sensitive << line_wstrb_i;
-    sensitive << line_wflags_i;
     sensitive << line_raddr_o;
     sensitive << line_rdata_o;
     sensitive << line_rflags_o;
     sensitive << line_hit_o;
-    sensitive << line_snoop_addr_i;
     sensitive << line_snoop_ready_o;
     sensitive << line_snoop_flags_o;
     sensitive << r.req_type;
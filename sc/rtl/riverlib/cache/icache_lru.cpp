@@ -93,17 +93,7 @@ ICacheLru::ICacheLru(sc_module_name name,
     sensitive << i_pmp_x;
     sensitive << i_flush_address;
     sensitive << i_flush_valid;
-    sensitive << line_direct_access_i;
-    sensitive << line_invalidate_i;
-    sensitive << line_re_i;
-    sensitive << line_we_i;
-    sensitive << line_addr_i;
-    sensitive << line_wdata_i;
-    sensitive << line_wstrb_i;
-    sensitive << line_wflags_i;
-    sensitive << line_raddr_o;
     sensitive << line_rdata_o;
-    sensitive << line_rflags_o;
     sensitive << line_hit_o;
     sensitive << line_hit_next_o;
     sensitive << r.req_addr;
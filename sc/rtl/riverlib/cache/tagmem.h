@@ -148,15 +148,9 @@ TagMem<abus, ibits, lnbits, flbits, snoop>::TagMem(sc_module_name name,
     sensitive << i_nrst;
     sensitive << i_addr;
     sensitive << i_wstrb;
-    sensitive << i_wdata;
     sensitive << i_wflags;
     sensitive << i_snoop_addr;
-    sensitive << wb_index;
     sensitive << wb_tago_rdata;
-    sensitive << wb_tagi_wdata;
-    sensitive << w_tagi_we;
-    sensitive << wb_snoop_index;
-    sensitive << wb_snoop_tagaddr;
     sensitive << wb_tago_snoop_rdata;
     sensitive << r.tagaddr;
     sensitive << r.index;
@@ -155,7 +155,6 @@ TagMemCoupled<abus, waybits, ibits, lnbits, flbits>::TagMemCoupled(sc_module_nam
 
 
     SC_METHOD(comb);
-    sensitive << i_nrst;
     sensitive << i_direct_access;
     sensitive << i_invalidate;
     sensitive << i_re;
@@ -164,24 +163,11 @@ TagMemCoupled<abus, waybits, ibits, lnbits, flbits>::TagMemCoupled(sc_module_nam
     sensitive << i_wdata;
     sensitive << i_wstrb;
     sensitive << i_wflags;
-    for (int i = 0; i < MemTotal; i++) {
-        sensitive << linei[i].direct_access;
-        sensitive << linei[i].invalidate;
-        sensitive << linei[i].re;
-        sensitive << linei[i].we;
-        sensitive << linei[i].addr;
-        sensitive << linei[i].wdata;
-        sensitive << linei[i].wstrb;
-        sensitive << linei[i].wflags;
-        sensitive << linei[i].snoop_addr;
-    }
     for (int i = 0; i < MemTotal; i++) {
         sensitive << lineo[i].raddr;
         sensitive << lineo[i].rdata;
         sensitive << lineo[i].rflags;
         sensitive << lineo[i].hit;
-        sensitive << lineo[i].snoop_ready;
-        sensitive << lineo[i].snoop_flags;
     }
     sensitive << r.req_addr;
 
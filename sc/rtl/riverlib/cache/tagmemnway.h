@@ -187,20 +187,7 @@ TagMemNWay<abus, waybits, ibits, lnbits, flbits, snoop>::TagMemNWay(sc_module_na
     sensitive << i_wstrb;
     sensitive << i_wflags;
     sensitive << i_snoop_addr;
-    sensitive << w_lrui_init;
-    sensitive << wb_lrui_raddr;
-    sensitive << wb_lrui_waddr;
-    sensitive << w_lrui_up;
-    sensitive << w_lrui_down;
-    sensitive << wb_lrui_lru;
     sensitive << wb_lruo_lru;
-    for (int i = 0; i < NWAYS; i++) {
-        sensitive << way_i[i].addr;
-        sensitive << way_i[i].wstrb;
-        sensitive << way_i[i].wdata;
-        sensitive << way_i[i].wflags;
-        sensitive << way_i[i].snoop_addr;
-    }
     for (int i = 0; i < NWAYS; i++) {
         sensitive << way_o[i].raddr;
         sensitive << way_o[i].rdata;
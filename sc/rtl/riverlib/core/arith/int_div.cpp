@@ -60,9 +60,6 @@ IntDiv::IntDiv(sc_module_name name,
     sensitive << i_residual;
     sensitive << i_a1;
     sensitive << i_a2;
-    sensitive << wb_divisor0_i;
-    sensitive << wb_divisor1_i;
-    sensitive << wb_resid0_o;
     sensitive << wb_resid1_o;
     sensitive << wb_bits0_o;
     sensitive << wb_bits1_o;
@@ -74,32 +74,20 @@ BranchPredictor::BranchPredictor(sc_module_name name,
 
 
     SC_METHOD(comb);
-    sensitive << i_nrst;
-    sensitive << i_flush_pipeline;
-    sensitive << i_resp_mem_valid;
     sensitive << i_resp_mem_addr;
     sensitive << i_resp_mem_data;
     sensitive << i_e_jmp;
     sensitive << i_e_pc;
     sensitive << i_e_npc;
-    sensitive << i_ra;
     sensitive << i_f_requested_pc;
     sensitive << i_f_fetching_pc;
     sensitive << i_f_fetched_pc;
     sensitive << i_d_pc;
     for (int i = 0; i < 2; i++) {
-        sensitive << wb_pd[i].c_valid;
-        sensitive << wb_pd[i].addr;
-        sensitive << wb_pd[i].data;
         sensitive << wb_pd[i].jmp;
         sensitive << wb_pd[i].pc;
         sensitive << wb_pd[i].npc;
     }
-    sensitive << w_btb_e;
-    sensitive << w_btb_we;
-    sensitive << wb_btb_we_pc;
-    sensitive << wb_btb_we_npc;
-    sensitive << wb_start_pc;
     sensitive << wb_npc;
     sensitive << wb_bp_exec;
 }
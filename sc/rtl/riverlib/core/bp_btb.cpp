@@ -48,9 +48,6 @@ BpBTB::BpBTB(sc_module_name name,
         sensitive << r.btb[i].npc;
         sensitive << r.btb[i].exec;
     }
-    for (int i = 0; i < CFG_BP_DEPTH; i++) {
-        sensitive << dbg_npc[i];
-    }
 
     SC_METHOD(registers);
     sensitive << i_nrst;
@@ -86,7 +86,6 @@ CsrRegs::CsrRegs(sc_module_name name,
     sensitive << i_resp_ready;
     sensitive << i_e_halted;
     sensitive << i_e_pc;
-    sensitive << i_e_instr;
     sensitive << i_irq_pending;
     sensitive << i_f_flush_ready;
     sensitive << i_e_valid;
@@ -99,7 +99,6 @@ DbgPort::DbgPort(sc_module_name name,
     sensitive << i_csr_req_ready;
     sensitive << i_csr_resp_valid;
     sensitive << i_csr_resp_data;
-    sensitive << i_csr_resp_exception;
     sensitive << i_progbuf;
     sensitive << i_csr_progbuf_end;
     sensitive << i_csr_progbuf_error;
@@ -115,11 +114,7 @@ DbgPort::DbgPort(sc_module_name name,
     sensitive << i_e_ret;
     sensitive << i_e_memop_valid;
     sensitive << i_m_valid;
-    sensitive << wb_stack_raddr;
     sensitive << wb_stack_rdata;
-    sensitive << w_stack_we;
-    sensitive << wb_stack_waddr;
-    sensitive << wb_stack_wdata;
     sensitive << r.dport_write;
     sensitive << r.dport_addr;
     sensitive << r.dport_wdata;
@@ -144,11 +144,8 @@ InstrDecoder::InstrDecoder(sc_module_name name,
     sensitive << i_nrst;
     sensitive << i_f_pc;
     sensitive << i_f_instr;
-    sensitive << i_instr_load_fault;
-    sensitive << i_instr_page_fault_x;
     sensitive << i_e_npc;
     sensitive << i_flush_pipeline;
-    sensitive << i_progbuf_ena;
     for (int i = 0; i < (FULL_DEC_DEPTH + DEC_BLOCK); i++) {
         sensitive << wd[i].pc;
         sensitive << wd[i].isa_type;
@@ -197,12 +194,6 @@ InstrDecoder::InstrDecoder(sc_module_name name,
         sensitive << r.d[i].imm;
         sensitive << r.d[i].progbuf_ena;
     }
-    for (int i = 0; i < DEC_NUM; i++) {
-        sensitive << wb_f_pc[i];
-    }
-    for (int i = 0; i < DEC_NUM; i++) {
-        sensitive << wb_f_instr[i];
-    }
 
     SC_METHOD(registers);
     sensitive << i_nrst;
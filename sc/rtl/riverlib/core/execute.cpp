@@ -210,7 +210,6 @@ InstrExecute::InstrExecute(sc_module_name name,
     sensitive << i_d_pc;
     sensitive << i_d_instr;
     sensitive << i_d_progbuf_ena;
-    sensitive << i_wb_waddr;
     sensitive << i_memop_store;
     sensitive << i_memop_load;
     sensitive << i_memop_sign_ext;
@@ -257,30 +256,11 @@ InstrExecute::InstrExecute(sc_module_name name,
     sensitive << i_dbg_mem_req_addr;
     sensitive << i_dbg_mem_req_wdata;
     for (int i = 0; i < Res_Total; i++) {
-        sensitive << wb_select[i].ena;
         sensitive << wb_select[i].valid;
         sensitive << wb_select[i].res;
     }
-    sensitive << wb_alu_mode;
-    sensitive << wb_addsub_mode;
-    sensitive << wb_shifter_mode;
-    sensitive << w_arith_residual_high;
-    sensitive << w_mul_hsu;
-    sensitive << wb_fpu_vec;
-    sensitive << w_ex_fpu_invalidop;
-    sensitive << w_ex_fpu_divbyzero;
-    sensitive << w_ex_fpu_overflow;
-    sensitive << w_ex_fpu_underflow;
-    sensitive << w_ex_fpu_inexact;
     sensitive << w_hazard1;
     sensitive << w_hazard2;
-    sensitive << wb_rdata1;
-    sensitive << wb_rdata2;
-    sensitive << wb_shifter_a1;
-    sensitive << wb_shifter_a2;
-    for (int i = 0; i < INTREGS_TOTAL; i++) {
-        sensitive << tag_expected[i];
-    }
     sensitive << r.state;
     sensitive << r.csrstate;
     sensitive << r.amostate;
@@ -57,14 +57,9 @@ DoubleDiv::DoubleDiv(sc_module_name name,
     sensitive << i_ena;
     sensitive << i_a;
     sensitive << i_b;
-    sensitive << w_idiv_ena;
-    sensitive << wb_divident;
-    sensitive << wb_divisor;
     sensitive << wb_idiv_result;
     sensitive << wb_idiv_lshift;
     sensitive << w_idiv_rdy;
-    sensitive << w_idiv_overflow;
-    sensitive << w_idiv_zeroresid;
     sensitive << r.busy;
     sensitive << r.ena;
     sensitive << r.a;
@@ -54,11 +54,9 @@ DoubleMul::DoubleMul(sc_module_name name,
     sensitive << i_ena;
     sensitive << i_a;
     sensitive << i_b;
-    sensitive << w_imul_ena;
     sensitive << wb_imul_result;
     sensitive << wb_imul_shift;
     sensitive << w_imul_rdy;
-    sensitive << w_imul_overflow;
     sensitive << r.busy;
     sensitive << r.ena;
     sensitive << r.a;
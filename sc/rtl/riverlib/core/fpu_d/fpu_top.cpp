@@ -124,39 +124,26 @@ FpuTop::FpuTop(sc_module_name name,
     sensitive << i_ivec;
     sensitive << i_a;
     sensitive << i_b;
-    sensitive << w_fadd_d;
-    sensitive << w_fsub_d;
-    sensitive << w_feq_d;
-    sensitive << w_flt_d;
-    sensitive << w_fle_d;
-    sensitive << w_fmax_d;
-    sensitive << w_fmin_d;
-    sensitive << w_fcvt_signed;
     sensitive << wb_res_fadd;
     sensitive << w_valid_fadd;
     sensitive << w_illegalop_fadd;
     sensitive << w_overflow_fadd;
-    sensitive << w_busy_fadd;
     sensitive << wb_res_fdiv;
     sensitive << w_valid_fdiv;
     sensitive << w_illegalop_fdiv;
     sensitive << w_divbyzero_fdiv;
     sensitive << w_overflow_fdiv;
     sensitive << w_underflow_fdiv;
-    sensitive << w_busy_fdiv;
     sensitive << wb_res_fmul;
     sensitive << w_valid_fmul;
     sensitive << w_illegalop_fmul;
     sensitive << w_overflow_fmul;
-    sensitive << w_busy_fmul;
     sensitive << wb_res_d2l;
     sensitive << w_valid_d2l;
     sensitive << w_overflow_d2l;
     sensitive << w_underflow_d2l;
-    sensitive << w_busy_d2l;
     sensitive << wb_res_l2d;
     sensitive << w_valid_l2d;
-    sensitive << w_busy_l2d;
     sensitive << r.ivec;
     sensitive << r.busy;
     sensitive << r.ready;
@@ -53,10 +53,6 @@ idiv53::idiv53(sc_module_name name,
     sensitive << i_ena;
     sensitive << i_divident;
     sensitive << i_divisor;
-    sensitive << w_mux_ena_i;
-    sensitive << wb_muxind_i;
-    sensitive << wb_divident_i;
-    sensitive << wb_divisor_i;
     sensitive << wb_dif_o;
     sensitive << wb_bits_o;
     sensitive << wb_muxind_o;
@@ -47,7 +47,6 @@ imul53::imul53(sc_module_name name,
     sensitive << i_ena;
     sensitive << i_a;
     sensitive << i_b;
-    sensitive << wb_sumInv;
     sensitive << wb_lshift;
     sensitive << r.delay;
     sensitive << r.shift;
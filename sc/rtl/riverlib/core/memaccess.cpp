@@ -102,7 +102,6 @@ MemAccess::MemAccess(sc_module_name name,
     sensitive << i_wb_ready;
     sensitive << i_mem_req_ready;
     sensitive << i_mem_data_valid;
-    sensitive << i_mem_data_addr;
     sensitive << i_mem_data;
     sensitive << r.state;
     sensitive << r.mmu_ena;
@@ -124,9 +123,6 @@ MemAccess::MemAccess(sc_module_name name,
     sensitive << r.hold_rdata;
     sensitive << r.pc;
     sensitive << r.valid;
-    sensitive << queue_we;
-    sensitive << queue_re;
-    sensitive << queue_data_i;
     sensitive << queue_data_o;
     sensitive << queue_nempty;
     sensitive << queue_full;
@@ -95,16 +95,9 @@ Mmu::Mmu(sc_module_name name,
     sensitive << i_mem_resp_store_fault;
     sensitive << i_mmu_ena;
     sensitive << i_mmu_sv39;
-    sensitive << i_mmu_sv48;
     sensitive << i_mmu_ppn;
     sensitive << i_mprv;
-    sensitive << i_mxr;
-    sensitive << i_sum;
     sensitive << i_fence;
-    sensitive << i_fence_addr;
-    sensitive << wb_tlb_adr;
-    sensitive << w_tlb_wena;
-    sensitive << wb_tlb_wdata;
     sensitive << wb_tlb_rdata;
     sensitive << r.state;
     sensitive << r.req_x;
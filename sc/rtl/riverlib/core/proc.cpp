@@ -619,240 +619,20 @@ Processor::Processor(sc_module_name name,
 
 
     SC_METHOD(comb);
-    sensitive << i_nrst;
-    sensitive << i_mtimer;
-    sensitive << i_req_ctrl_ready;
-    sensitive << i_resp_ctrl_valid;
-    sensitive << i_resp_ctrl_addr;
-    sensitive << i_resp_ctrl_data;
-    sensitive << i_resp_ctrl_load_fault;
-    sensitive << i_req_data_ready;
-    sensitive << i_resp_data_valid;
-    sensitive << i_resp_data_addr;
-    sensitive << i_resp_data_data;
     sensitive << i_resp_data_load_fault;
     sensitive << i_resp_data_store_fault;
-    sensitive << i_irq_pending;
-    sensitive << i_haltreq;
-    sensitive << i_resumereq;
-    sensitive << i_dport_req_valid;
-    sensitive << i_dport_type;
-    sensitive << i_dport_addr;
-    sensitive << i_dport_wdata;
-    sensitive << i_dport_size;
-    sensitive << i_dport_resp_ready;
-    sensitive << i_progbuf;
-    sensitive << i_flushd_end;
-    sensitive << w.f.instr_load_fault;
-    sensitive << w.f.instr_page_fault_x;
-    sensitive << w.f.requested_pc;
-    sensitive << w.f.fetching_pc;
-    sensitive << w.f.pc;
-    sensitive << w.f.instr;
-    sensitive << w.f.imem_req_valid;
-    sensitive << w.f.imem_req_addr;
-    sensitive << w.f.imem_resp_ready;
-    sensitive << w.d.pc;
-    sensitive << w.d.instr;
-    sensitive << w.d.memop_store;
-    sensitive << w.d.memop_load;
-    sensitive << w.d.memop_sign_ext;
-    sensitive << w.d.memop_size;
-    sensitive << w.d.rv32;
-    sensitive << w.d.compressed;
-    sensitive << w.d.amo;
-    sensitive << w.d.f64;
-    sensitive << w.d.unsigned_op;
-    sensitive << w.d.isa_type;
-    sensitive << w.d.instr_vec;
-    sensitive << w.d.exception;
-    sensitive << w.d.instr_load_fault;
-    sensitive << w.d.page_fault_x;
-    sensitive << w.d.radr1;
-    sensitive << w.d.radr2;
-    sensitive << w.d.waddr;
-    sensitive << w.d.csr_addr;
-    sensitive << w.d.imm;
-    sensitive << w.d.progbuf_ena;
-    sensitive << w.e.valid;
-    sensitive << w.e.instr;
-    sensitive << w.e.pc;
-    sensitive << w.e.npc;
-    sensitive << w.e.radr1;
-    sensitive << w.e.radr2;
     sensitive << w.e.reg_wena;
     sensitive << w.e.reg_waddr;
     sensitive << w.e.reg_wtag;
     sensitive << w.e.reg_wdata;
-    sensitive << w.e.csr_req_valid;
-    sensitive << w.e.csr_req_type;
-    sensitive << w.e.csr_req_addr;
-    sensitive << w.e.csr_req_data;
-    sensitive << w.e.csr_resp_ready;
-    sensitive << w.e.memop_valid;
-    sensitive << w.e.memop_debug;
-    sensitive << w.e.memop_sign_ext;
-    sensitive << w.e.memop_type;
-    sensitive << w.e.memop_size;
-    sensitive << w.e.memop_addr;
-    sensitive << w.e.memop_wdata;
-    sensitive << w.e.call;
-    sensitive << w.e.ret;
-    sensitive << w.e.jmp;
     sensitive << w.e.halted;
-    sensitive << w.e.dbg_mem_req_ready;
-    sensitive << w.e.dbg_mem_req_error;
-    sensitive << w.m.memop_ready;
     sensitive << w.m.flushd;
-    sensitive << w.m.pc;
-    sensitive << w.m.valid;
-    sensitive << w.m.idle;
-    sensitive << w.m.debug_valid;
-    sensitive << w.m.dmmu_ena;
-    sensitive << w.m.dmmu_sv39;
-    sensitive << w.m.dmmu_sv48;
-    sensitive << w.m.req_data_valid;
-    sensitive << w.m.req_data_type;
-    sensitive << w.m.req_data_addr;
-    sensitive << w.m.req_data_wdata;
-    sensitive << w.m.req_data_wstrb;
-    sensitive << w.m.req_data_size;
-    sensitive << w.m.resp_data_ready;
     sensitive << w.w.wena;
     sensitive << w.w.waddr;
     sensitive << w.w.wdata;
     sensitive << w.w.wtag;
-    sensitive << immu.req_ready;
-    sensitive << immu.valid;
-    sensitive << immu.addr;
-    sensitive << immu.data;
-    sensitive << immu.load_fault;
-    sensitive << immu.store_fault;
-    sensitive << immu.page_fault_x;
-    sensitive << immu.page_fault_r;
-    sensitive << immu.page_fault_w;
-    sensitive << dmmu.req_ready;
-    sensitive << dmmu.valid;
-    sensitive << dmmu.addr;
-    sensitive << dmmu.data;
-    sensitive << dmmu.load_fault;
-    sensitive << dmmu.store_fault;
-    sensitive << dmmu.page_fault_x;
-    sensitive << dmmu.page_fault_r;
-    sensitive << dmmu.page_fault_w;
-    sensitive << ireg.rdata1;
-    sensitive << ireg.rtag1;
-    sensitive << ireg.rdata2;
-    sensitive << ireg.rtag2;
-    sensitive << ireg.dport_rdata;
-    sensitive << ireg.ra;
-    sensitive << ireg.sp;
-    sensitive << ireg.gp;
-    sensitive << ireg.tp;
-    sensitive << ireg.t0;
-    sensitive << ireg.t1;
-    sensitive << ireg.t2;
-    sensitive << ireg.fp;
-    sensitive << ireg.s1;
-    sensitive << ireg.a0;
-    sensitive << ireg.a1;
-    sensitive << ireg.a2;
-    sensitive << ireg.a3;
-    sensitive << ireg.a4;
-    sensitive << ireg.a5;
-    sensitive << ireg.a6;
-    sensitive << ireg.a7;
-    sensitive << ireg.s2;
-    sensitive << ireg.s3;
-    sensitive << ireg.s4;
-    sensitive << ireg.s5;
-    sensitive << ireg.s6;
-    sensitive << ireg.s7;
-    sensitive << ireg.s8;
-    sensitive << ireg.s9;
-    sensitive << ireg.s10;
-    sensitive << ireg.s11;
-    sensitive << ireg.t3;
-    sensitive << ireg.t4;
-    sensitive << ireg.t5;
-    sensitive << ireg.t6;
-    sensitive << csr.req_ready;
-    sensitive << csr.resp_valid;
-    sensitive << csr.resp_data;
-    sensitive << csr.resp_exception;
-    sensitive << csr.flushd_valid;
     sensitive << csr.flushi_valid;
-    sensitive << csr.flushmmu_valid;
-    sensitive << csr.flushpipeline_valid;
     sensitive << csr.flush_addr;
-    sensitive << csr.executed_cnt;
-    sensitive << csr.irq_pending;
-    sensitive << csr.o_wakeup;
-    sensitive << csr.stack_overflow;
-    sensitive << csr.stack_underflow;
-    sensitive << csr.step;
-    sensitive << csr.mmu_ena;
-    sensitive << csr.mmu_sv39;
-    sensitive << csr.mmu_sv48;
-    sensitive << csr.mmu_ppn;
-    sensitive << csr.mprv;
-    sensitive << csr.mxr;
-    sensitive << csr.sum;
-    sensitive << csr.progbuf_end;
-    sensitive << csr.progbuf_error;
-    sensitive << dbg.csr_req_valid;
-    sensitive << dbg.csr_req_type;
-    sensitive << dbg.csr_req_addr;
-    sensitive << dbg.csr_req_data;
-    sensitive << dbg.csr_resp_ready;
-    sensitive << dbg.ireg_addr;
-    sensitive << dbg.ireg_wdata;
-    sensitive << dbg.ireg_ena;
-    sensitive << dbg.ireg_write;
-    sensitive << dbg.mem_req_valid;
-    sensitive << dbg.mem_req_write;
-    sensitive << dbg.mem_req_addr;
-    sensitive << dbg.mem_req_size;
-    sensitive << dbg.mem_req_wdata;
-    sensitive << dbg.progbuf_ena;
-    sensitive << dbg.progbuf_pc;
-    sensitive << dbg.progbuf_instr;
-    sensitive << bp.f_valid;
-    sensitive << bp.f_pc;
-    sensitive << iccsr_m0_req_ready;
-    sensitive << iccsr_m0_resp_valid;
-    sensitive << iccsr_m0_resp_data;
-    sensitive << iccsr_m0_resp_exception;
-    sensitive << iccsr_m1_req_ready;
-    sensitive << iccsr_m1_resp_valid;
-    sensitive << iccsr_m1_resp_data;
-    sensitive << iccsr_m1_resp_exception;
-    sensitive << iccsr_s0_req_valid;
-    sensitive << iccsr_s0_req_type;
-    sensitive << iccsr_s0_req_addr;
-    sensitive << iccsr_s0_req_data;
-    sensitive << iccsr_s0_resp_ready;
-    sensitive << iccsr_s0_resp_exception;
-    sensitive << w_mem_resp_error;
-    sensitive << w_writeback_ready;
-    sensitive << w_reg_wena;
-    sensitive << wb_reg_waddr;
-    sensitive << wb_reg_wdata;
-    sensitive << wb_reg_wtag;
-    sensitive << w_reg_inorder;
-    sensitive << w_reg_ignored;
-    sensitive << w_f_flush_ready;
-    sensitive << unused_immu_mem_req_type;
-    sensitive << unused_immu_mem_req_wdata;
-    sensitive << unused_immu_mem_req_wstrb;
-    sensitive << unused_immu_mem_req_size;
-    sensitive << w_immu_core_req_fetch;
-    sensitive << w_dmmu_core_req_fetch;
-    sensitive << unused_immu_core_req_type;
-    sensitive << unused_immu_core_req_wdata;
-    sensitive << unused_immu_core_req_wstrb;
-    sensitive << unused_immu_core_req_size;
-    sensitive << unused_immu_mem_resp_store_fault;
 }
 
 Processor::~Processor() {
@@ -16,6 +16,7 @@
 
 #include "tracer.h"
 #include "api_core.h"
+#include <string.h>
 
 namespace debugger {
 
@@ -119,12 +120,32 @@ Tracer::Tracer(sc_module_name name,
     trace_file_ = trace_file;
     // initial
     char tstr[256];
-    RISCV_sprintf(tstr, sizeof(tstr), "%s%d.log",
+    RISCV_sprintf(tstr, sizeof(tstr), "%s%d.%s",
             trace_file_.c_str(),
-            hartid_);
+            hartid_,
+            CFG_TRACER_BINARY ? "bin" : "log");
     trfilename = std::string(tstr);
     fl = fopen(trfilename.c_str(), "wb");
 
+    binidx_ = 0;
+    binstep_ = 0;
+    for (int i = 0; i < 2; i++) {
+        binbuf_[i].th.func = reinterpret_cast<lib_thread_func>(WriteBinaryThread);
+        binbuf_[i].th.args = &binbuf_[i];
+        binbuf_[i].fl = fl;
+        binbuf_[i].buf = 0;
+        binbuf_[i].cnt = 0;
+        binbuf_[i].busy = false;
+        if (CFG_TRACER_BINARY) {
+            binbuf_[i].buf = new uint8_t[TRACE_BIN_BUF_SZ];
+        }
+    }
+    if (CFG_TRACER_BINARY) {
+        memcpy(binbuf_[0].buf, "RVTRACE\n", 8);
+        memcpy(&binbuf_[0].buf[8], &hartid_, 4);
+        binbuf_[0].cnt = 12;
+    }
+
     // end initial
 
 
@@ -183,6 +204,19 @@ Tracer::Tracer(sc_module_name name,
     sensitive << i_clk.pos();
 }
 
+Tracer::~Tracer() {
+    if (CFG_TRACER_BINARY) {
+        FlushBinary();
+        FlushBinary();
+        for (int i = 0; i < 2; i++) {
+            delete [] binbuf_[i].buf;
+        }
+    }
+    if (fl) {
+        fclose(fl);
+    }
+}
+
 void Tracer::generateVCD(sc_trace_file *i_vcd, sc_trace_file *o_vcd) {
     std::string pn(name());
     if (o_vcd) {
@@ -1258,6 +1292,70 @@ std::string Tracer::TraceOutput(sc_uint<TRACE_TBL_ABITS> rcnt) {
     return ostr;
 }
 
+void Tracer::TraceOutputBinary(sc_uint<TRACE_TBL_ABITS> rcnt) {
+    TraceBinBufferType *p = &binbuf_[binidx_];
+    uint8_t *pout = &p->buf[p->cnt + binstep_];
+    uint8_t *pmemcnt;
+    int ircnt = rcnt.to_int();
+    uint64_t t1;
+    uint32_t t2;
+
+    t1 = r.trace_tbl[ircnt].exec_cnt.read().to_uint64();
+    memcpy(pout, &t1, 8);
+    t1 = r.trace_tbl[ircnt].pc.read().to_uint64();
+    memcpy(&pout[8], &t1, 8);
+    t2 = r.trace_tbl[ircnt].instr.read().to_uint();
+    memcpy(&pout[16], &t2, 4);
+    pmemcnt = &pout[20];
+    pout[20] = 0;
+    pout[21] = static_cast<uint8_t>(r.trace_tbl[ircnt].regactioncnt.read().to_int());
+    pout += 22;
+
+    for (int i = 0; i < r.trace_tbl[ircnt].memactioncnt.read().to_int(); i++) {
+        if (r.trace_tbl[ircnt].memaction[i].ignored.read() == 0) {
+            (*pmemcnt)++;
+            pout[0] = r.trace_tbl[ircnt].memaction[i].store.read() ? 1 : 0;
+            t1 = r.trace_tbl[ircnt].memaction[i].memaddr.read().to_uint64();
+            memcpy(&pout[1], &t1, 8);
+            t1 = r.trace_tbl[ircnt].memaction[i].data.read().to_uint64();
+            memcpy(&pout[9], &t1, 8);
+            pout += 17;
+        }
+    }
+
+    for (int i = 0; i < r.trace_tbl[ircnt].regactioncnt.read().to_int(); i++) {
+        pout[0] = static_cast<uint8_t>(r.trace_tbl[ircnt].regaction[i].waddr.read().to_int());
+        t1 = r.trace_tbl[ircnt].regaction[i].wres.read().to_uint64();
+        memcpy(&pout[1], &t1, 8);
+        pout += 9;
+    }
+    binstep_ = static_cast<int>(pout - &p->buf[p->cnt]);
+}
+
+void Tracer::FlushBinary() {
+    TraceBinBufferType *p = &binbuf_[binidx_];
+    TraceBinBufferType *pnext = &binbuf_[binidx_ ^ 1];
+
+    // Only one writer at time to keep records order
+    if (pnext->busy) {
+        RISCV_thread_join(pnext->th.Handle, 50000);
+        pnext->busy = false;
+    }
+    pnext->cnt = 0;
+    if (p->cnt) {
+        p->busy = true;
+        RISCV_thread_create(&p->th);
+    }
+    binidx_ ^= 1;
+}
+
+void Tracer::WriteBinaryThread(void *arg) {
+    TraceBinBufferType *p = reinterpret_cast<TraceBinBufferType *>(arg);
+    if (p->fl) {
+        fwrite(p->buf, 1, p->cnt, p->fl);
+    }
+}
+
 void Tracer::comb() {
     int wcnt;
     int xcnt;
@@ -1401,6 +1499,7 @@ void Tracer::comb() {
     entry_valid = 1;
     rcnt_inc = r.tr_rcnt;
     outstr = "";
+    binstep_ = 0;
     while ((entry_valid == 1) && (rcnt_inc != r.tr_wcnt.read())) {
         for (int i = 0; i < r.trace_tbl[rcnt_inc].memactioncnt.read().to_int(); i++) {
             if (r.trace_tbl[rcnt_inc].memaction[i].complete == 0) {
@@ -1408,8 +1507,12 @@ void Tracer::comb() {
             }
         }
         if (entry_valid == 1) {
-            tracestr = TraceOutput(rcnt_inc);
-            outstr += tracestr;
+            if (CFG_TRACER_BINARY) {
+                TraceOutputBinary(rcnt_inc);
+            } else {
+                tracestr = TraceOutput(rcnt_inc);
+                outstr += tracestr;
+            }
             rcnt_inc = (rcnt_inc + 1);
         }
     }
@@ -1509,6 +1612,14 @@ void Tracer::registers() {
         fwrite(outstr.c_str(), 1, outstr.size(), fl);
     }
     outstr = "";
+
+    if (binstep_) {
+        binbuf_[binidx_].cnt += binstep_;
+        binstep_ = 0;
+        if (binbuf_[binidx_].cnt > TRACE_BIN_BUF_SZ - TRACE_BIN_STEP_MAX) {
+            FlushBinary();
+        }
+    }
 }
 
 }  // namespace debugger
@@ -17,6 +17,7 @@
 
 #include <systemc.h>
 #include <string>
+#include "api_core.h"
 #include "../river_cfg.h"
 
 namespace debugger {
@@ -55,6 +56,7 @@ SC_MODULE(Tracer) {
            bool async_reset,
            uint32_t hartid,
            std::string trace_file);
+    virtual ~Tracer();
 
     void generateVCD(sc_trace_file *i_vcd, sc_trace_file *o_vcd);
 
@@ -68,6 +70,9 @@ SC_MODULE(Tracer) {
 
     std::string TaskDisassembler(sc_uint<32> instr);
     std::string TraceOutput(sc_uint<TRACE_TBL_ABITS> rcnt);
+    void TraceOutputBinary(sc_uint<TRACE_TBL_ABITS> rcnt);
+    void FlushBinary();
+    static void WriteBinaryThread(void *arg);
 
     struct MemopActionType {
         sc_signal<bool> store;                              // 0=load;1=store
@@ -111,6 +116,29 @@ SC_MODULE(Tracer) {
     std::string tracestr;
     FILE *fl;
 
+    /**
+     * Binary output (CFG_TRACER_BINARY). Records are written by comb() after
+     * the last committed byte and committed in registers(). Full buffer is
+     * stored into the file by a separate thread while the second buffer is
+     * filled.
+     *
+     * Record: u64 exec_cnt, u64 pc, u32 instr, u8 memcnt, u8 regcnt,
+     *         memcnt * {u8 store, u64 addr, u64 data},
+     *         regcnt * {u8 waddr, u64 wres}
+     */
+    static const int TRACE_BIN_BUF_SZ = 1 << 22;
+    static const int TRACE_BIN_STEP_MAX =
+        TRACE_TBL_SZ * (22 + TRACE_TBL_SZ * (17 + 9));
+
+    struct TraceBinBufferType {
+        LibThreadType th;
+        FILE *fl;
+        uint8_t *buf;
+        int cnt;
+        bool busy;
+    } binbuf_[2];
+    int binidx_;
+    int binstep_;
 
 };
 
@@ -97,10 +97,6 @@ dmidebug::dmidebug(sc_module_name name,
 
     SC_METHOD(comb);
     sensitive << i_nrst;
-    sensitive << i_trst;
-    sensitive << i_tck;
-    sensitive << i_tms;
-    sensitive << i_tdi;
     sensitive << i_mapinfo;
     sensitive << i_apbi;
     sensitive << i_halted;
@@ -109,22 +105,10 @@ dmidebug::dmidebug(sc_module_name name,
     sensitive << i_dport_resp_valid;
     sensitive << i_dport_resp_error;
     sensitive << i_dport_rdata;
-    sensitive << w_tap_dmi_req_valid;
-    sensitive << w_tap_dmi_req_write;
-    sensitive << wb_tap_dmi_req_addr;
-    sensitive << wb_tap_dmi_req_data;
-    sensitive << w_tap_dmi_reset;
-    sensitive << w_tap_dmi_hardreset;
     sensitive << w_cdc_dmi_req_valid;
-    sensitive << w_cdc_dmi_req_ready;
     sensitive << w_cdc_dmi_req_write;
     sensitive << wb_cdc_dmi_req_addr;
     sensitive << wb_cdc_dmi_req_data;
-    sensitive << w_cdc_dmi_reset;
-    sensitive << w_cdc_dmi_hardreset;
-    sensitive << wb_jtag_dmi_resp_data;
-    sensitive << w_jtag_dmi_busy;
-    sensitive << w_jtag_dmi_error;
     sensitive << r.bus_jtag;
     sensitive << r.jtag_resp_data;
     sensitive << r.prdata;
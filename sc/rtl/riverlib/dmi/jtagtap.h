@@ -131,8 +131,6 @@ jtagtap<idcode, abits, irlen>::jtagtap(sc_module_name name)
 
 
     SC_METHOD(comb);
-    sensitive << i_trst;
-    sensitive << i_tck;
     sensitive << i_tms;
     sensitive << i_tdi;
     sensitive << i_dmi_resp_data;
@@ -32,7 +32,6 @@ ic_axi4_to_l1::ic_axi4_to_l1(sc_module_name name,
     async_reset_ = async_reset;
 
     SC_METHOD(comb);
-    sensitive << i_nrst;
     sensitive << i_xmsto;
     sensitive << i_l1i;
     sensitive << r.state;
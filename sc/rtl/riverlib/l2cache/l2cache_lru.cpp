@@ -99,26 +99,14 @@ L2CacheLru::L2CacheLru(sc_module_name name,
     sensitive << i_req_mem_ready;
     sensitive << i_mem_data_valid;
     sensitive << i_mem_data;
-    sensitive << i_mem_data_ack;
     sensitive << i_mem_load_fault;
     sensitive << i_mem_store_fault;
     sensitive << i_flush_address;
     sensitive << i_flush_valid;
-    sensitive << line_direct_access_i;
-    sensitive << line_invalidate_i;
-    sensitive << line_re_i;
-    sensitive << line_we_i;
-    sensitive << line_addr_i;
-    sensitive << line_wdata_i;
-    sensitive << line_wstrb_i;
-    sensitive << line_wflags_i;
     sensitive << line_raddr_o;
     sensitive << line_rdata_o;
     sensitive << line_rflags_o;
     sensitive << line_hit_o;
-    sensitive << line_snoop_addr_i;
-    sensitive << line_snoop_ready_o;
-    sensitive << line_snoop_flags_o;
     sensitive << r.req_type;
     sensitive << r.req_size;
     sensitive << r.req_prot;
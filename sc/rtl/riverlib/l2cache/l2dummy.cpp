@@ -38,7 +38,6 @@ L2Dummy::L2Dummy(sc_module_name name,
         sensitive << i_l1o[i];
     }
     sensitive << i_l2i;
-    sensitive << i_flush_valid;
     sensitive << r.state;
     sensitive << r.srcid;
     sensitive << r.req_addr;
@@ -108,12 +108,8 @@ RiverAmba::RiverAmba(sc_module_name name,
 
     SC_METHOD(comb);
     sensitive << i_nrst;
-    sensitive << i_mtimer;
     sensitive << i_msti;
     sensitive << i_dport;
-    sensitive << i_irq_pending;
-    sensitive << i_progbuf;
-    sensitive << req_mem_ready_i;
     sensitive << req_mem_path_o;
     sensitive << req_mem_valid_o;
     sensitive << req_mem_type_o;
@@ -121,28 +117,10 @@ RiverAmba::RiverAmba(sc_module_name name,
     sensitive << req_mem_addr_o;
     sensitive << req_mem_strob_o;
     sensitive << req_mem_data_o;
-    sensitive << resp_mem_data_i;
-    sensitive << resp_mem_valid_i;
-    sensitive << resp_mem_load_fault_i;
-    sensitive << resp_mem_store_fault_i;
-    sensitive << req_snoop_valid_i;
-    sensitive << req_snoop_type_i;
     sensitive << req_snoop_ready_o;
-    sensitive << req_snoop_addr_i;
-    sensitive << resp_snoop_ready_i;
     sensitive << resp_snoop_valid_o;
     sensitive << resp_snoop_data_o;
     sensitive << resp_snoop_flags_o;
-    sensitive << w_dporti_haltreq;
-    sensitive << w_dporti_resumereq;
-    sensitive << w_dporti_resethaltreq;
-    sensitive << w_dporti_hartreset;
-    sensitive << w_dporti_req_valid;
-    sensitive << wb_dporti_dtype;
-    sensitive << wb_dporti_addr;
-    sensitive << wb_dporti_wdata;
-    sensitive << wb_dporti_size;
-    sensitive << w_dporti_resp_ready;
     sensitive << w_dporto_req_ready;
     sensitive << w_dporto_resp_valid;
     sensitive << w_dporto_resp_error;
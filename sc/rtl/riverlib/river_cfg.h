@@ -23,6 +23,9 @@ static const uint32_t CFG_VENDOR_ID = 0x000000F1;
 static const uint32_t CFG_IMPLEMENTATION_ID = 0x20220813;
 static const bool CFG_HW_FPU_ENABLE = true;
 static const bool CFG_TRACER_ENABLE = false;
+// Binary tracer output (off by default to keep the text log), convert
+// into text with debugger/scripts/rvtrace2txt.py
+static const bool CFG_TRACER_BINARY = false;
 
 // Architectural size definition
 static const int RISCV_ARCH = 64;
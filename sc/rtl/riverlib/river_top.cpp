@@ -204,59 +204,6 @@ RiverTop::RiverTop(sc_module_name name,
 
 
     SC_METHOD(comb);
-    sensitive << i_nrst;
-    sensitive << i_mtimer;
-    sensitive << i_req_mem_ready;
-    sensitive << i_resp_mem_valid;
-    sensitive << i_resp_mem_path;
-    sensitive << i_resp_mem_data;
-    sensitive << i_resp_mem_load_fault;
-    sensitive << i_resp_mem_store_fault;
-    sensitive << i_req_snoop_valid;
-    sensitive << i_req_snoop_type;
-    sensitive << i_req_snoop_addr;
-    sensitive << i_resp_snoop_ready;
-    sensitive << i_irq_pending;
-    sensitive << i_haltreq;
-    sensitive << i_resumereq;
-    sensitive << i_dport_req_valid;
-    sensitive << i_dport_type;
-    sensitive << i_dport_addr;
-    sensitive << i_dport_wdata;
-    sensitive << i_dport_size;
-    sensitive << i_dport_resp_ready;
-    sensitive << i_progbuf;
-    sensitive << w_req_ctrl_ready;
-    sensitive << w_req_ctrl_valid;
-    sensitive << wb_req_ctrl_addr;
-    sensitive << w_resp_ctrl_valid;
-    sensitive << wb_resp_ctrl_addr;
-    sensitive << wb_resp_ctrl_data;
-    sensitive << w_resp_ctrl_load_fault;
-    sensitive << w_resp_ctrl_ready;
-    sensitive << w_req_data_ready;
-    sensitive << w_req_data_valid;
-    sensitive << wb_req_data_type;
-    sensitive << wb_req_data_addr;
-    sensitive << wb_req_data_wdata;
-    sensitive << wb_req_data_wstrb;
-    sensitive << wb_req_data_size;
-    sensitive << w_resp_data_valid;
-    sensitive << wb_resp_data_addr;
-    sensitive << wb_resp_data_data;
-    sensitive << w_resp_data_load_fault;
-    sensitive << w_resp_data_store_fault;
-    sensitive << w_resp_data_ready;
-    sensitive << w_pmp_ena;
-    sensitive << w_pmp_we;
-    sensitive << wb_pmp_region;
-    sensitive << wb_pmp_start_addr;
-    sensitive << wb_pmp_end_addr;
-    sensitive << wb_pmp_flags;
-    sensitive << w_flushi_valid;
-    sensitive << wb_flushi_addr;
-    sensitive << w_flushd_valid;
-    sensitive << wb_flushd_addr;
     sensitive << w_flushd_end;
 }
 
@@ -222,38 +222,10 @@ Workgroup::Workgroup(sc_module_name name,
 
 
     SC_METHOD(comb);
-    sensitive << i_cores_nrst;
-    sensitive << i_dmi_nrst;
-    sensitive << i_trst;
-    sensitive << i_tck;
-    sensitive << i_tms;
-    sensitive << i_tdi;
     sensitive << i_msip;
     sensitive << i_mtip;
     sensitive << i_meip;
     sensitive << i_seip;
-    sensitive << i_mtimer;
-    sensitive << i_acpo;
-    sensitive << i_msti;
-    sensitive << i_dmi_mapinfo;
-    sensitive << i_dmi_apbi;
-    for (int i = 0; i < CFG_SLOT_L1_TOTAL; i++) {
-        sensitive << coreo[i];
-    }
-    for (int i = 0; i < CFG_SLOT_L1_TOTAL; i++) {
-        sensitive << corei[i];
-    }
-    sensitive << l2i;
-    sensitive << l2o;
-    for (int i = 0; i < CFG_CPU_MAX; i++) {
-        sensitive << wb_dport_i[i];
-    }
-    for (int i = 0; i < CFG_CPU_MAX; i++) {
-        sensitive << wb_dport_o[i];
-    }
-    for (int i = 0; i < CFG_CPU_MAX; i++) {
-        sensitive << vec_irq[i];
-    }
     for (int i = 0; i < CFG_CPU_MAX; i++) {
         sensitive << vec_halted[i];
     }
@@ -263,25 +235,6 @@ Workgroup::Workgroup(sc_module_name name,
     for (int i = 0; i < CFG_CPU_MAX; i++) {
         sensitive << vec_flush_l2[i];
     }
-    sensitive << wb_halted;
-    sensitive << wb_available;
-    sensitive << wb_dmi_hartsel;
-    sensitive << w_dmi_haltreq;
-    sensitive << w_dmi_resumereq;
-    sensitive << w_dmi_resethaltreq;
-    sensitive << w_dmi_hartreset;
-    sensitive << w_dmi_dport_req_valid;
-    sensitive << wb_dmi_dport_req_type;
-    sensitive << wb_dmi_dport_addr;
-    sensitive << wb_dmi_dport_wdata;
-    sensitive << wb_dmi_dport_size;
-    sensitive << w_ic_dport_req_ready;
-    sensitive << w_dmi_dport_resp_ready;
-    sensitive << w_ic_dport_resp_valid;
-    sensitive << w_ic_dport_resp_error;
-    sensitive << wb_ic_dport_rdata;
-    sensitive << wb_progbuf;
-    sensitive << w_flush_l2;
 }
 
 Workgroup::~Workgroup() {
@@ -75,15 +75,8 @@ ram_cache_bwe_tech<abits, dbits>::ram_cache_bwe_tech(sc_module_name name)
 
 
     SC_METHOD(comb);
-    sensitive << i_addr;
     sensitive << i_wena;
     sensitive << i_wdata;
-    for (int i = 0; i < (dbits / 8); i++) {
-        sensitive << wb_we[i];
-    }
-    for (int i = 0; i < (dbits / 8); i++) {
-        sensitive << wb_wdata[i];
-    }
     for (int i = 0; i < (dbits / 8); i++) {
         sensitive << wb_rdata[i];
     }